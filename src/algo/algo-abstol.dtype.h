@@ -58,6 +58,11 @@ int scil_abstol_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
                                       size_t in_size);
 // End repeat
 
+/**
+ * \brief Upper bound of the compressed size of abstol
+ */
+size_t scil_abstol_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_abstol;
 
 #endif /* SCIL_ABSTOL_H_<DATATYPE> */
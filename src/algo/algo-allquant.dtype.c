@@ -15,8 +15,8 @@
 
 #include <algo/algo-allquant.h>
 
+#include <scil-data-stats.h>
 #include <scil-quantizer.h>
-#include <scil-swager.h>
 #include <scil-util.h>
 
 #include <assert.h>
@@ -88,9 +88,9 @@ int scil_allquant_compress_<DATATYPE>(const scil_context_t* ctx,
     // Element count in buffer to compress
     size_t count = scilPr_get_dims_count(dims);
 
-    // Finding minimum and maximum values in data
+    // Finding minimum and maximum values in data, other stages may have scanned it already
     <DATATYPE> min, max;
-    scil_find_minimum_maximum_<DATATYPE>(source, count, &min, &max);
+    scilI_data_stats_minmax_<DATATYPE>(scilI_context_data_stats(ctx, source, count), &min, &max);
 
     const double abs_tol = ctx->hints.absolute_tolerance;
     const double rel_tol = ctx->hints.relative_tolerance_percent;
@@ -108,25 +108,16 @@ int scil_allquant_compress_<DATATYPE>(const scil_context_t* ctx,
     // Get number of needed bytes for the whole compressed buffer
     *dest_size = round_up_byte(bits_per_value * count) + SCIL_ABSTOL_HEADER_SIZE;
 
-    uint64_t* quantized_buffer = (uint64_t*)SAFE_MALLOC(count * sizeof(uint64_t));
-
     // ==================== Compress ==========================================
     write_header(dest, min, abs_tol, bits_per_value);
     dest += SCIL_ABSTOL_HEADER_SIZE;
 
-    // Use quantization to reduce each values bit count
-    if(scil_quantize_buffer_minmax_<DATATYPE>(quantized_buffer, source, count, abs_tol, min, max)){
-        return SCIL_BUFFER_ERR;
-    }
-
-    // Pack data in quantized buffer tightly
-    if(scil_swage(dest, quantized_buffer, count, (uint8_t)bits_per_value)){
+    // Quantize each value with the reduced bit count and pack it tightly
+    if(scil_quantize_pack_<DATATYPE>(dest, source, count, abs_tol, min, (uint8_t)bits_per_value)){
         return SCIL_BUFFER_ERR;
     }
     // ========================================================================
 
-    free(quantized_buffer);
-
     return SCIL_NO_ERR;
 }
 
@@ -144,32 +135,31 @@ int scil_allquant_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
     byte* in = source;
     size_t in_size = source_size;
     size_t count = scilPr_get_dims_count(dims);
-    uint64_t* unswaged_buffer = (uint64_t*)SAFE_MALLOC(count * sizeof(uint64_t*));
 
     // ============ Decompress ================================================
     // Parse Header
     read_header(in, &in_size, &min, &abs_tol, &bits_per_value);
     in += SCIL_ABSTOL_HEADER_SIZE;
 
-    // Unpacking buffer
-    if(scil_unswage(unswaged_buffer, in, count, bits_per_value)){
-        return SCIL_BUFFER_ERR;
-    }
-
-    // Unquantizing buffer
-    if(scil_unquantize_buffer_<DATATYPE>(dest, unswaged_buffer, count, abs_tol, min)){
+    // Unpacking and unquantizing buffer
+    if(scil_unpack_unquantize_<DATATYPE>(dest, in, count, abs_tol, min, bits_per_value)){
         return SCIL_BUFFER_ERR;
     }
     // ========================================================================
 
-    free(unswaged_buffer);
-
     return SCIL_NO_ERR;
 }
 // End repeat
 
 
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_allquant_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size){
+    // values need less bits than the datatype
+    const uint64_t bits_per_value = 8 * DATATYPE_LENGTH(datatype) - 1;
+    return round_up_byte(bits_per_value * scilPr_get_dims_count(dims)) + SCIL_ABSTOL_HEADER_SIZE;
+}
+
 scilI_algorithm_t algo_allquant = {
     .c.DNtype = {
         CREATE_INITIALIZER(scil_allquant)
@@ -177,5 +167,6 @@ scilI_algorithm_t algo_allquant = {
     "allquant",
     12,
     SCIL_COMPRESSOR_TYPE_DATATYPES,
-    1
+    1,
+    scil_allquant_compress_bound
 };
@@ -40,6 +40,8 @@ int scil_allquant_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
                                       size_t in_size);
 // End repeat
 
+size_t scil_allquant_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_allquant;
 
 #endif
@@ -22,7 +22,7 @@
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_gzip_compress(const scil_context_t* ctx, byte* restrict dest, size_t* restrict dest_size, const byte*restrict source, const size_t source_size){
-  *dest_size = 2*source_size;
+  *dest_size = compressBound(source_size);
   int ret = compress( (Bytef*)dest, dest_size, (Bytef*)source, (uLong)(source_size) );
   if (ret == Z_OK){
     return SCIL_NO_ERR;
@@ -50,6 +50,11 @@ int scil_gzip_decompress(byte*restrict data_out, size_t buff_size,  const byte*r
   return ret;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_gzip_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size){
+  return compressBound(in_size);
+}
+
 scilI_algorithm_t algo_gzip = {
     .c.Btype = {
         scil_gzip_compress,
@@ -57,5 +62,7 @@ scilI_algorithm_t algo_gzip = {
     },
     "gzip",
     2,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_gzip_compress_bound
 };
@@ -46,6 +46,11 @@ int scil_gzip_compress(const scil_context_t* ctx, byte* restrict dest, size_t* r
  */
 int scil_gzip_decompress(byte*restrict data_out, size_t buff_size, const byte*restrict compressed_buf_in, const size_t in_size, size_t * uncomp_size_out);
 
+/**
+ * \brief Upper bound of the compressed size of gzip
+ */
+size_t scil_gzip_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_gzip;
 
 #endif
@@ -15,6 +15,8 @@
 
 #include <algo/algo-memcopy.h>
 
+#include <scil-error.h>
+
 #include <string.h>
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -27,12 +29,19 @@ int scil_memcopy_compress(const scil_context_t* ctx, byte* restrict dest, size_t
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_memcopy_decompress(byte*restrict dest, size_t buff_size, const byte*restrict source, const size_t in_size, size_t * uncomp_size_out){
-    // TODO check if buff is sufficiently large
+    if (in_size > buff_size){
+      return SCIL_BUFFER_ERR;
+    }
     memcpy(dest, source, in_size);
     *uncomp_size_out = in_size;
     return 0;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_memcopy_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size){
+    return in_size;
+}
+
 scilI_algorithm_t algo_memcopy = {
     .c.Btype = {
         scil_memcopy_compress,
@@ -40,5 +49,7 @@ scilI_algorithm_t algo_memcopy = {
     },
     "memcopy",
     0,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_memcopy_compress_bound
 };
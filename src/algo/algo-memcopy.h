@@ -40,6 +40,11 @@ int scil_memcopy_compress(const scil_context_t* ctx, byte* restrict dest, size_t
  */
 int scil_memcopy_decompress(byte*restrict data_out, size_t buff_size, const byte*restrict compressed_buf_in, const size_t in_size, size_t * uncomp_size_out);
 
+/**
+ * \brief Upper bound of the compressed size of memcopy
+ */
+size_t scil_memcopy_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_memcopy;
 
 #endif
@@ -6,6 +6,7 @@
 #include <algo/algo-quantize.h>
 #include <scil-internal.h>
 #include <scil-quantizer.h>
+#include <scil-data-stats.h>
 
 //Supported datatypes: float double
 // Repeat for each data type
@@ -19,7 +20,7 @@ int scil_quantize_compress_<DATATYPE>(const scil_context_t* ctx,
     size_t count = scilPr_get_dims_count(dims);
 
     <DATATYPE> minimum, maximum;
-    scil_find_minimum_maximum_<DATATYPE>(source, count, &minimum, &maximum);
+    scilI_data_stats_minmax_<DATATYPE>(scilI_context_data_stats(ctx, source, count), &minimum, &maximum);
 
     uint8_t bits_per_value = scil_calculate_bits_needed_<DATATYPE>(minimum, maximum, ctx->hints.absolute_tolerance);
     if (bits_per_value > 64)
@@ -56,6 +57,13 @@ int scil_quantize_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
 }
 // End repeat
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_quantize_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size)
+{
+    // minimum and tolerance followed by one int64_t per value
+    return 16 + scilPr_get_dims_count(dims) * sizeof(int64_t);
+}
+
 scilI_algorithm_t algo_quantize = {
     .c.Ctype = {
         CREATE_INITIALIZER(scil_quantize)
@@ -63,5 +71,6 @@ scilI_algorithm_t algo_quantize = {
     "quantize",
     9,
     SCIL_COMPRESSOR_TYPE_DATATYPES_CONVERTER,
-    1
+    1,
+    scil_quantize_compress_bound
 };
@@ -18,6 +18,8 @@ int scil_quantize_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
 
 // End repeat
 
+size_t scil_quantize_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_quantize;
 
 #endif /* SCIL_QUANTIZE_H_<DATATYPE> */
@@ -17,6 +17,7 @@
 
 #include <scil.h>
 
+#include <scil-data-stats.h>
 #include <scil-error.h>
 #include <scil-internal.h>
 #include <scil-swager.h>
@@ -169,53 +170,18 @@ static uint64_t get_mantissa_double(uint64_t value, uint8_t mantissa_bit_count){
     return (value & mask[mantissa_bit_count]) << (MANTISSA_LENGTH_DOUBLE - mantissa_bit_count);
 }
 
-//Supported datatypes: double float
-// Repeat for each data type
-
-static void find_minimums_and_maximums_<DATATYPE>(const <DATATYPE>* buffer,
-                                                  const size_t size,
-                                                  uint8_t* minimum_sign,
-                                                  uint8_t* maximum_sign,
-                                                  int16_t* minimum_exponent,
-                                                  int16_t* maximum_exponent){
-
-    *minimum_sign = 1;
-    *maximum_sign = 0;
-
-    *minimum_exponent = 0x7fff;
-    *maximum_exponent = -*minimum_exponent;
-
-    for(size_t i = 0; i < size; ++i){
-
-        datatype_cast_<DATATYPE> cur;
-        cur.f = buffer[i];
+static void get_header_data(const scilI_data_stats_t* stats,
+                            uint8_t* signs_id,
+                            uint8_t* exponent_bit_count,
+                            int16_t* minimum_exponent){
 
-        if(*minimum_sign != 0 && cur.p.sign < *minimum_sign) { *minimum_sign = cur.p.sign; }
-        if(*maximum_sign != 1 && cur.p.sign > *maximum_sign) { *maximum_sign = cur.p.sign; }
-
-        if(cur.p.exponent < *minimum_exponent) { *minimum_exponent = cur.p.exponent; }
-        if(cur.p.exponent > *maximum_exponent) { *maximum_exponent = cur.p.exponent; }
-    }
+    *minimum_exponent = stats->minimum_exponent;
+    *signs_id = calc_sign_bit_count(stats->minimum_sign, stats->maximum_sign);
+    *exponent_bit_count = calc_exponent_bit_count(stats->minimum_exponent, stats->maximum_exponent);
 }
 
-static void get_header_data_<DATATYPE>(const <DATATYPE>* source,
-                                       size_t count,
-                                       uint8_t* signs_id,
-                                       uint8_t* exponent_bit_count,
-                                       int16_t* minimum_exponent){
-
-    uint8_t minimum_sign, maximum_sign;
-    int16_t maximum_exponent;
-    find_minimums_and_maximums_<DATATYPE>(source,
-                                          count,
-                                          &minimum_sign,
-                                          &maximum_sign,
-                                          minimum_exponent,
-                                          &maximum_exponent);
-
-    *signs_id = calc_sign_bit_count(minimum_sign, maximum_sign);
-    *exponent_bit_count = calc_exponent_bit_count(*minimum_exponent, maximum_exponent);
-}
+//Supported datatypes: double float
+// Repeat for each data type
 
 // TODO: Test this mess... Especially for the super rare exponent maximum overflow.
 // TODO: Speed up shifts with lookup table.
@@ -281,23 +247,29 @@ static <DATATYPE> decompress_value_<DATATYPE>(uint64_t value,
     return cur.f;
 }
 
-static int compress_buffer_<DATATYPE>(uint64_t* restrict dest,
+// compresses and packs the values in a single pass
+static int compress_buffer_<DATATYPE>(byte* restrict dest,
                                       const <DATATYPE>* restrict source,
                                       size_t count,
+                                      uint8_t bit_count_per_value,
                                       uint8_t signs_id,
                                       uint8_t exponent_bit_count,
                                       uint8_t mantissa_bit_count,
                                       int16_t minimum_exponent){
 
+    scil_bit_writer_t writer;
+    scil_bit_writer_init(&writer, dest);
     for(size_t i = 0; i < count; ++i){
-        dest[i] = compress_value_<DATATYPE>(source[i], signs_id, exponent_bit_count, mantissa_bit_count, minimum_exponent);
+        uint64_t value = compress_value_<DATATYPE>(source[i], signs_id, exponent_bit_count, mantissa_bit_count, minimum_exponent);
+        scil_bit_writer_put(&writer, value, bit_count_per_value);
     }
+    scil_bit_writer_flush(&writer);
 
     return SCIL_NO_ERR;
 }
 
 static int decompress_buffer_<DATATYPE>(<DATATYPE>* restrict dest,
-                                        const uint64_t* restrict source,
+                                        const byte* restrict source,
                                         size_t count,
                                         uint8_t bit_count_per_value,
                                         uint8_t signs_id,
@@ -305,8 +277,11 @@ static int decompress_buffer_<DATATYPE>(<DATATYPE>* restrict dest,
                                         uint8_t mantissa_bit_count,
                                         int16_t minimum_exponent){
 
+    scil_bit_reader_t reader;
+    scil_bit_reader_init(&reader, source, round_up_byte(bit_count_per_value * count));
     for (size_t i = 0; i < count; ++i) {
-        dest[i] = decompress_value_<DATATYPE>(source[i], bit_count_per_value, signs_id, exponent_bit_count, mantissa_bit_count, minimum_exponent);
+        uint64_t value = scil_bit_reader_get(&reader, bit_count_per_value);
+        dest[i] = decompress_value_<DATATYPE>(value, bit_count_per_value, signs_id, exponent_bit_count, mantissa_bit_count, minimum_exponent);
     }
 
     return SCIL_NO_ERR;
@@ -336,7 +311,7 @@ int scil_sigbits_compress_<DATATYPE>(const scil_context_t* ctx,
 
     uint8_t signs_id, exponent_bit_count;
     int16_t minimum_exponent;
-    get_header_data_<DATATYPE>(source, count, &signs_id, &exponent_bit_count, &minimum_exponent);
+    get_header_data(scilI_context_data_stats(ctx, source, count), &signs_id, &exponent_bit_count, &minimum_exponent);
 
     uint8_t bit_count_per_value = get_bit_count_per_value(signs_id, exponent_bit_count, mantissa_bit_count);
 
@@ -347,30 +322,14 @@ int scil_sigbits_compress_<DATATYPE>(const scil_context_t* ctx,
 
     *dest_size = round_up_byte(bit_count_per_value * count) + SCIL_SIGBITS_HEADER_SIZE;
 
-    int ret = SCIL_NO_ERR;
-
     // ==================== Compression ========================================
 
-    // Allocate intermediate buffer
-    uint64_t* compressed_buffer = (uint64_t*)SAFE_MALLOC(count * sizeof(uint64_t));
-
-    // Compress each value in source buffer
-    if(compress_buffer_<DATATYPE>(compressed_buffer, source, count, signs_id, exponent_bit_count, mantissa_bit_count, minimum_exponent)){
-        ret = SCIL_BUFFER_ERR;
-        goto comp_cleanup;
+    // Compress each value in source buffer and pack it tightly
+    if(compress_buffer_<DATATYPE>(dest, source, count, bit_count_per_value, signs_id, exponent_bit_count, mantissa_bit_count, minimum_exponent)){
+        return SCIL_BUFFER_ERR;
     }
 
-    // Pack compressed values tightly
-    if(scil_swage(dest, compressed_buffer, count, (uint8_t)bit_count_per_value)){
-        ret = SCIL_BUFFER_ERR;
-        goto comp_cleanup;
-    }
-
-    // ==================== Cleanup ============================================
-
-    comp_cleanup:
-    free(compressed_buffer);
-    return ret;
+    return SCIL_NO_ERR;
 }
 
 int scil_sigbits_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
@@ -397,36 +356,28 @@ int scil_sigbits_decompress_<DATATYPE>(<DATATYPE>*restrict dest,
 
     // ==================== Decompression ======================================
 
-    uint64_t* unswaged_buffer = (uint64_t*)SAFE_MALLOC(count * sizeof(uint64_t));
-
-    int ret = SCIL_NO_ERR;
-
-    if(scil_unswage(unswaged_buffer, source, count, bit_count_per_value)){
-        ret = SCIL_BUFFER_ERR;
-        goto decomp_cleanup;
-    }
-
     if(decompress_buffer_<DATATYPE>(dest,
-                                    unswaged_buffer,
+                                    source,
                                     count,
                                     bit_count_per_value,
                                     signs_id,
                                     exponent_bit_count,
                                     mantissa_bit_count,
                                     minimum_exponent) ){
-        ret = SCIL_BUFFER_ERR;
-        goto decomp_cleanup;
+        return SCIL_BUFFER_ERR;
     }
 
-    // ==================== Cleanup ============================================
-
-    decomp_cleanup:
-    free(unswaged_buffer);
-    return ret;
+    return SCIL_NO_ERR;
 }
 
 // End repeat
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_sigbits_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size){
+    // sign, exponent and mantissa bits never exceed the datatype
+    return round_up_byte(8 * DATATYPE_LENGTH(datatype) * scilPr_get_dims_count(dims)) + SCIL_SIGBITS_HEADER_SIZE;
+}
+
 scilI_algorithm_t algo_sigbits = {
     .c.DNtype = {
         CREATE_INITIALIZER(scil_sigbits)
@@ -434,5 +385,6 @@ scilI_algorithm_t algo_sigbits = {
     "sigbits",
     3,
     SCIL_COMPRESSOR_TYPE_DATATYPES,
-    1
+    1,
+    scil_sigbits_compress_bound
 };
@@ -51,6 +51,11 @@ int scil_sigbits_decompress_<DATATYPE>( <DATATYPE>*restrict dest, scil_dims_t* d
 // End repeat
 
 
+/**
+ * \brief Upper bound of the compressed size of sigbits
+ */
+size_t scil_sigbits_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_sigbits;
 
 #endif /* SCIL_SIGBITS_H_ */
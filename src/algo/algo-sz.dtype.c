@@ -15,6 +15,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
 #include <string.h>
 
 #include <sz.h>
@@ -22,12 +23,16 @@
 #include <algo/algo-sz.h>
 #include <scil-util.h>
 
-static struct sz_params * params = NULL;
+/*
+ SZ keeps its configuration and the error bounds of the current call in global variables,
+ thus the library is initialized once and all calls into it are serialized.
+ */
+static struct sz_params params;
+static pthread_once_t sz_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t sz_lock = PTHREAD_MUTEX_INITIALIZER;
 
-static void init_sz_if_needed(){
-  if (params) return;
-  params = malloc(sizeof(struct sz_params));
-  struct sz_params * p = params;
+static void init_sz(){
+  struct sz_params * p = & params;
   memset(p, -1, sizeof(struct sz_params));
   p->dataEndianType = LITTLE_ENDIAN_DATA;
   p->max_quant_intervals = 65536;
@@ -55,7 +60,7 @@ int scil_sz_compress_<DATATYPE>(const scil_context_t* ctx,
                                     size_t* restrict dest_size,
                                     <DATATYPE>* restrict source,
                                     const scil_dims_t* dims){
-  init_sz_if_needed();
+  pthread_once(& sz_once, init_sz);
   int size = 0;
   double abstol = ctx->hints.absolute_tolerance;
   double reltol = ctx->hints.relative_tolerance_percent / 100.0;
@@ -73,7 +78,9 @@ int scil_sz_compress_<DATATYPE>(const scil_context_t* ctx,
   //printf("Running SZ: with %d %f %f\n", mode, abstol, reltol);
 
   int ret;
+  pthread_mutex_lock(& sz_lock);
   ret = SZ_compress_args2(SZ_<DATATYPE_UPPER>, source, dest, & size, mode, abstol, reltol, 0, dims->length[3], dims->length[2], dims->length[1], dims->length[0]);
+  pthread_mutex_unlock(& sz_lock);
   //printf("Returns: %d\n", size);
   if (ret == 0){
     *dest_size = size;
@@ -88,10 +95,12 @@ int scil_sz_decompress_<DATATYPE>(<DATATYPE>* restrict dest,
                                       scil_dims_t* dims,
                                       byte* restrict source,
                                       size_t source_size){
-  init_sz_if_needed();
+  pthread_once(& sz_once, init_sz);
   int size = (int) source_size;
   //printf("Decompress %d %d\n", size, dims->length[0]);
+  pthread_mutex_lock(& sz_lock);
   int elems = SZ_decompress_args(SZ_<DATATYPE_UPPER>, source, size, (void*) dest, 0, dims->length[3], dims->length[2], dims->length[1], dims->length[0]);
+  pthread_mutex_unlock(& sz_lock);
 
   if (elems < 0){
     printf("SZ DError: %d\n", elems);
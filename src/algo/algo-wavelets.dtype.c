@@ -27,6 +27,19 @@
 
 #include <scil-error.h>
 
+#include <pthread.h>
+
+/*
+ The filter banks are global variables of the wavelet code, they are selected once and
+ only read by the transforms afterwards.
+ */
+static pthread_once_t filter_once = PTHREAD_ONCE_INIT;
+
+static void select_filter(){
+  // List of filters is in wav_trf.c
+  choose_filter('H',9);
+}
+
 // Repeat for each data type
 
 // hard threshold the values in matrix.
@@ -63,8 +76,7 @@ int scil_wavelets_compress_<DATATYPE>(const scil_context_t* ctx,
   	int Nl,Nh;
   	float *lp,*hp;
 
-    // Choose wavelet filter. List of filters is in wav_trf.c
-  	choose_filter('H',9);
+    pthread_once(&filter_once, select_filter);
 
     // Select the forward bank of filters.
     lp=MFLP;Nl=Nflp;
@@ -138,8 +150,7 @@ int  scil_wavelets_decompress_<DATATYPE>( <DATATYPE>*restrict data_out,
     memcpy(buffer_t[i], compressed_buf_in+i*Nj*sizeof(<DATATYPE>)+sizeof(int), Nj*sizeof(<DATATYPE>));
   }
 
-  // Choose wavelet filter. List of filters is in wav_trf.c
-  choose_filter('H',9);
+  pthread_once(&filter_once, select_filter);
 
   for(i=levs-1;i>=0;i--) {
     shift_arr_r[i]=shift_arr_c[i]=0;
@@ -170,5 +181,7 @@ scilI_algorithm_t algo_wavelets = {
     "wavelets",
     11,
     SCIL_COMPRESSOR_TYPE_DATATYPES,
-		1
+		1,
+    NULL,
+    1
 };
@@ -21,37 +21,13 @@
 
 #include <zfp.h>
 
+#include <scil-data-stats.h>
 #include <scil-util.h>
 
 
 //Supported datatypes: float double
 // Repeat for each data type
 
-static void find_minimums_and_maximums_<DATATYPE>(const <DATATYPE>* buffer,
-                                                  const size_t size,
-                                                  uint8_t* minimum_sign,
-                                                  uint8_t* maximum_sign,
-                                                  int16_t* minimum_exponent,
-                                                  int16_t* maximum_exponent){
-    *minimum_sign = 1;
-    *maximum_sign = 0;
-
-    *minimum_exponent = 0x7fff;
-    *maximum_exponent = -*minimum_exponent;
-
-    for(size_t i = 0; i < size; ++i){
-
-        datatype_cast_<DATATYPE> cur;
-        cur.f = buffer[i];
-
-        if(*minimum_sign != 0 && cur.p.sign < *minimum_sign) { *minimum_sign = cur.p.sign; }
-        if(*maximum_sign != 1 && cur.p.sign > *maximum_sign) { *maximum_sign = cur.p.sign; }
-
-        if(cur.p.exponent < *minimum_exponent) { *minimum_exponent = cur.p.exponent; }
-        if(cur.p.exponent > *maximum_exponent) { *maximum_exponent = cur.p.exponent; }
-    }
-}
-
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_zfp_precision_compress_<DATATYPE>(const scil_context_t* ctx,
                         byte * restrict dest,
@@ -73,17 +49,10 @@ int scil_zfp_precision_compress_<DATATYPE>(const scil_context_t* ctx,
     }
 
     // determine number of bits for the exponent
-    uint8_t minimum_sign, maximum_sign;
-    int16_t maximum_exponent, minimum_exponent;
-    find_minimums_and_maximums_<DATATYPE>(source,
-                                          count,
-                                          &minimum_sign,
-                                          &maximum_sign,
-                                          & minimum_exponent,
-                                          &maximum_exponent);
+    const scilI_data_stats_t* stats = scilI_context_data_stats(ctx, source, count);
     uint8_t exponent_bit_count;
-    exponent_bit_count = (uint8_t) ceil(log2(maximum_exponent - minimum_exponent + 1));
-    if(minimum_sign != maximum_sign){
+    exponent_bit_count = (uint8_t) ceil(log2(stats->maximum_exponent - stats->minimum_exponent + 1));
+    if(stats->minimum_sign != stats->maximum_sign){
       exponent_bit_count += 1;
     }
 
@@ -15,6 +15,8 @@
 
 #include <algo/lz4fast.h>
 
+#include <scil-error.h>
+
 #include <string.h>
 #include <lz4.h>
 
@@ -35,15 +37,29 @@ int scil_lz4fast_compress(const scil_context_t* ctx, byte* restrict dest, size_t
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int scil_lz4fast_decompress(byte*restrict dest, size_t buff_size, const byte*restrict src, const size_t in_size, size_t * uncomp_size_out){
-    int size;
+    if (in_size < 4){
+      return SCIL_BUFFER_ERR;
+    }
     // retrieve the size of the uncompressed data
-    size = *((int*) src);
+    const int size = *((int*) src);
+    if (size < 0 || (size_t) size > buff_size){
+      return SCIL_BUFFER_ERR;
+    }
+    // a corrupt stream must not write behind dest
+    const int ret = LZ4_decompress_safe((const char *) src + 4, (char *) dest, (int) (in_size - 4), size);
+    if (ret != size){
+      return SCIL_BUFFER_ERR;
+    }
     *uncomp_size_out = size;
-    size = LZ4_decompress_fast((const char *) src + 4, (char *)  dest, size); // LZ4_decompress_safe (source, dest, source_size, exp_size);
 
     return 0;
 }
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_lz4fast_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size){
+    return 4 + LZ4_compressBound(in_size);
+}
+
 scilI_algorithm_t algo_lz4fast = {
     .c.Btype = {
         scil_lz4fast_compress,
@@ -51,5 +67,7 @@ scilI_algorithm_t algo_lz4fast = {
     },
     "lz4",
     7,
-    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES
+    SCIL_COMPRESSOR_TYPE_INDIVIDUAL_BYTES,
+    0,
+    scil_lz4fast_compress_bound
 };
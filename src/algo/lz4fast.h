@@ -40,6 +40,11 @@ int scil_lz4fast_compress(const scil_context_t* ctx, byte* restrict dest, size_t
  */
 int scil_lz4fast_decompress(byte*restrict dest, size_t buff_size, const byte*restrict src, const size_t in_size, size_t * uncomp_size_out);
 
+/**
+ * \brief Upper bound of the compressed size of LZ4
+ */
+size_t scil_lz4fast_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 extern scilI_algorithm_t algo_lz4fast;
 
 #endif
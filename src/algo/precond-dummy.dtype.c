@@ -45,6 +45,11 @@ int scil_dummy_precond_decompress_<DATATYPE>(<DATATYPE>*restrict data_out, scil_
 // End repeat
 
 
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+size_t scil_dummy_precond_compress_bound(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size){
+  return in_size + 5;
+}
+
 scilI_algorithm_t algo_precond_dummy = {
     .c.PFtype = {
         CREATE_INITIALIZER(scil_dummy_precond)
@@ -52,5 +57,6 @@ scilI_algorithm_t algo_precond_dummy = {
     "dummy-precond",
     8,
     SCIL_COMPRESSOR_TYPE_DATATYPES_PRECONDITIONER_FIRST,
-    0
+    0,
+    scil_dummy_precond_compress_bound
 };
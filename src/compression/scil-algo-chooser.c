@@ -15,18 +15,27 @@
 
 #include <scil-algo-chooser.h>
 
+#include <scil-algo-learning.h>
+#include <scil-decision-cache.h>
 #include <scil-chain.h>
+#include <scil-chooser-model.h>
 #include <scil-config.h>
 #include <scil-data-characteristics.h>
 #include <scil-error.h>
 #include <scil-hardware-limits.h>
 #include <scil-internal.h>
+#include <scil-trace.h>
+#include <scil-util.h>
 
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
 typedef struct{
   scilI_chain_t chain;
+  char name[100];
+  // -1 if the measurement applies to every datatype
+  int datatype;
   float randomness;
   float c_speed;
   float d_speed;
@@ -36,20 +45,67 @@ typedef struct{
 static config_file_entry_t * config_list;
 static int config_list_size = 0;
 
-static config_file_entry_t ** config_list_lossless;
-static int config_list_lossless_size = 0;
+enum accuracy_hint{
+  ACCURACY_ABSOLUTE = 1,
+  ACCURACY_RELATIVE = 2,
+  ACCURACY_RELATIVE_FINEST = 4,
+  ACCURACY_SIGNIFICANT_BITS = 8
+};
 
-static void parse_losless_list(){
-  config_list_lossless = (config_file_entry_t**) malloc(sizeof(void*)* config_list_size);
+// the accuracy hints a lossy algorithm honors, lossy algorithms that are not listed are never chosen
+static const struct{
+  const char* name;
+  int honors;
+} lossy_algorithms[] = {
+  {"abstol", ACCURACY_ABSOLUTE},
+  {"quantize", ACCURACY_ABSOLUTE},
+  {"zfp-abstol", ACCURACY_ABSOLUTE},
+  {"sigbits", ACCURACY_SIGNIFICANT_BITS},
+  {"fpzip", ACCURACY_SIGNIFICANT_BITS},
+  {"zfp-precision", ACCURACY_SIGNIFICANT_BITS},
+  {"sz", ACCURACY_ABSOLUTE | ACCURACY_RELATIVE},
+  {"allquant", ACCURACY_ABSOLUTE | ACCURACY_RELATIVE | ACCURACY_RELATIVE_FINEST | ACCURACY_SIGNIFICANT_BITS},
+  {NULL, 0}
+};
 
-  for(int i=0; i < config_list_size;i++){
-    if (! config_list[i].chain.is_lossy){
-      config_list_lossless[config_list_lossless_size] = & config_list[i];
-      config_list_lossless_size++;
+static int parse_float(const char * str, float * out){
+  char * end;
+  *out = strtof(str, & end);
+  return end != str && *end == 0;
+}
+
+/*
+ A line has the fields "randomness; chain; compression MiB/s; decompression MiB/s; compressed size / original size".
+ The output of scil-benchmark adds the pattern name before the chain, or the datatype and the pattern name.
+ */
+static int parse_entry(char * line, config_file_entry_t * e){
+  char * fields[7];
+  int count = 0;
+  char * saveptr;
+  for(char * token = strtok_r(line, ";", & saveptr); token != NULL; token = strtok_r(NULL, ";", & saveptr)){
+    if(count == 7){
+      return 0;
+    }
+    fields[count++] = scilU_trim(token);
+  }
+  if(count < 5){
+    return 0;
+  }
+  e->datatype = -1;
+  if(count == 7){
+    char * end;
+    e->datatype = (int) strtol(fields[1], & end, 10);
+    if(end == fields[1] || *end != 0){
+      return 0;
     }
   }
-  debug("Configuration found %d entries which are lossless\n", config_list_lossless_size);
-  config_list_lossless = (config_file_entry_t**) realloc(config_list_lossless, config_list_lossless_size * sizeof(void*));
+  const char * chain = fields[count - 4];
+  if(strlen(chain) >= sizeof(e->name)){
+    return 0;
+  }
+  strcpy(e->name, chain);
+  return parse_float(fields[0], & e->randomness) && parse_float(fields[count - 3], & e->c_speed) &&
+         parse_float(fields[count - 2], & e->d_speed) && parse_float(fields[count - 1], & e->ratio);
 }
 
 void scilC_algo_chooser_initialize(){
@@ -69,11 +125,11 @@ void scilC_algo_chooser_initialize(){
 
   // File format is in CSV, see "dev/scil.conf" for an example->
   char * buff = malloc(1024);
+  size_t length = 1024;
   int config_list_capacity = 100;
   config_list = (config_file_entry_t*) malloc(sizeof(config_file_entry_t)* config_list_capacity); // up to 1k entries
 
   while(true){
-    size_t length = 1024;
     int64_t linelength;
     linelength = getline(&buff, & length, data);
     if(linelength == -1){
@@ -101,20 +157,19 @@ void scilC_algo_chooser_initialize(){
     }
 
     config_file_entry_t * e = & config_list[config_list_size];
-    char name[100];
-    char pattern_name[100];
-    int tokens = sscanf(buff, "%f; %s %s %f; %f; %f", & e->randomness, pattern_name, name, & e->c_speed, & e->d_speed, & e->ratio);
-    if( tokens != 6){
-      warn("Parsing configuration line \"%s\" returned an error after token %d\n", buff, tokens);
+    if(! parse_entry(buff, e)){
+      warn("Could not parse configuration line \"%s\"\n", buff);
       continue;
     }
-    name[strlen(name)-1] = 0;
-    ret = scilI_create_chain(& e->chain, name);
+    memset(& e->chain, 0, sizeof(e->chain));
+    ret = scilI_create_chain(& e->chain, e->name);
     if (ret != SCIL_NO_ERR){
-      warn("Parsing configuration line \"%s\"; could not parse compressor chain \"%s\"\n", buff, name);
+      warn("Parsing configuration line \"%s\"; could not parse compressor chain \"%s\"\n", buff, e->name);
       continue;
     }
-    debug("Configuration line %.3f; %s; %.1f; %.1f; %.3f\n", (double) e->randomness, name, (double) e->c_speed, (double) e->d_speed, (double) e->ratio);
+    // the learned statistics refer to the same spelling of the chain
+    scilI_chain_sprint(& e->chain, e->name, sizeof(e->name));
+    debug("Configuration line %.3f; %s; %.1f; %.1f; %.3f\n", (double) e->randomness, e->name, (double) e->c_speed, (double) e->d_speed, (double) e->ratio);
 
     config_list_size++;
     if(config_list_size >= config_list_capacity){
@@ -123,13 +178,280 @@ void scilC_algo_chooser_initialize(){
       debug("Configuration list increasing size to %d\n", config_list_capacity);
     }
   }
-  config_list = (config_file_entry_t*) realloc(config_list, config_list_size * sizeof(config_file_entry_t));
   free(buff);
   fclose(data);
 
   debug("Configuration, parsed %d lines\n", config_list_size);
+}
+
+static int is_set(double value){
+  return value < SCIL_ACCURACY_DBL_IGNORE || value > SCIL_ACCURACY_DBL_IGNORE;
+}
+
+static int required_accuracy(const scil_user_hints_t * hints){
+  int required = 0;
+  if(is_set(hints->absolute_tolerance)) required |= ACCURACY_ABSOLUTE;
+  if(is_set(hints->relative_tolerance_percent)) required |= ACCURACY_RELATIVE;
+  if(is_set(hints->relative_err_finest_abs_tolerance)) required |= ACCURACY_RELATIVE_FINEST;
+  if(hints->significant_bits != SCIL_ACCURACY_INT_IGNORE) required |= ACCURACY_SIGNIFICANT_BITS;
+  return required;
+}
+
+static int honors_accuracy(const scilI_algorithm_t * algo, int required){
+  for(int i=0; lossy_algorithms[i].name != NULL; i++){
+    if(strcmp(lossy_algorithms[i].name, algo->name) == 0){
+      return (lossy_algorithms[i].honors & required) == required;
+    }
+  }
+  return 0;
+}
+
+// a lossy chain must contain a single lossy algorithm that honors all accuracy hints, otherwise the errors add up
+static int chain_is_accurate(const scilI_chain_t * chain, const scil_context_t * ctx){
+  if(! chain->is_lossy){
+    return 1;
+  }
+  const int required = required_accuracy(& ctx->hints);
+  if(ctx->lossless_compression_needed || required == 0){
+    return 0;
+  }
+  const scilI_algorithm_t * lossy = NULL;
+  const scilI_algorithm_t * algos[2 * PRECONDITIONER_LIMIT + 3];
+  int count = 0;
+  for(int i=0; i < chain->precond_first_count; i++){
+    algos[count++] = chain->pre_cond_first[i];
+  }
+  algos[count++] = chain->converter;
+  for(int i=0; i < chain->precond_second_count; i++){
+    algos[count++] = chain->pre_cond_second[i];
+  }
+  algos[count++] = chain->data_compressor;
+  algos[count++] = chain->byte_compressor;
+  for(int i=0; i < count; i++){
+    if(algos[i] == NULL || ! algos[i]->is_lossy){
+      continue;
+    }
+    if(lossy != NULL){
+      return 0;
+    }
+    lossy = algos[i];
+  }
+  return honors_accuracy(lossy, required);
+}
+
+static int entry_matches(const config_file_entry_t * e, const scil_context_t * ctx){
+  return (e->datatype == -1 || e->datatype == (int) ctx->datatype) && scilI_chain_is_applicable(& e->chain, ctx->datatype) == SCIL_NO_ERR;
+}
+
+// the throughput in MiB/s demanded by the performance hint, 0 if there is no demand or the unit is unknown
+static float required_speed(const scilPr_performance_hint_t * hint){
+  float unit;
+  switch(hint->unit){
+  case SCIL_PERFORMANCE_MIB:
+    unit = 1;
+    break;
+  case SCIL_PERFORMANCE_GIB:
+    unit = 1024;
+    break;
+  case SCIL_PERFORMANCE_NETWORK:
+    unit = scilI_get_hardware_limit(NETWORK);
+    break;
+  case SCIL_PERFORMANCE_NODELOCAL_STORAGE:
+  case SCIL_PERFORMANCE_SINGLESTREAM_SHARED_STORAGE:
+    unit = scilI_get_hardware_limit(STORAGE);
+    break;
+  default:
+    unit = 0;
+  }
+  return hint->multiplier * unit;
+}
+
+// the slowest configured component the compressed data passes, 0 if none is configured
+static float io_speed(){
+  float speed = 0;
+  for(int i=0; i < HARDWARE_MAX; i++){
+    const float limit = scilI_get_hardware_limit((enum hardware_limit_e) i);
+    if(limit > 0 && (speed <= 0 || limit < speed)){
+      speed = limit;
+    }
+  }
+  return speed;
+}
+
+// interpolates the measurements of the chain between the two closest randomness values, returns 0 without a measurement
+static int estimate_chain(const char * name, const scil_context_t * ctx, float randomness, config_file_entry_t * out){
+  const config_file_entry_t * lower = NULL;
+  const config_file_entry_t * upper = NULL;
+  for(int i=0; i < config_list_size; i++){
+    const config_file_entry_t * e = & config_list[i];
+    if(strcmp(e->name, name) != 0 || ! entry_matches(e, ctx)){
+      continue;
+    }
+    if(e->randomness <= randomness && (lower == NULL || e->randomness > lower->randomness)){
+      lower = e;
+    }
+    if(e->randomness >= randomness && (upper == NULL || e->randomness < upper->randomness)){
+      upper = e;
+    }
+  }
+  if(lower == NULL && upper == NULL){
+    return 0;
+  }
+  if(lower == NULL || upper == NULL || upper->randomness <= lower->randomness){
+    *out = lower != NULL ? *lower : *upper;
+    return 1;
+  }
+  const float w = (randomness - lower->randomness) / (upper->randomness - lower->randomness);
+  *out = *lower;
+  out->c_speed = lower->c_speed + w * (upper->c_speed - lower->c_speed);
+  out->d_speed = lower->d_speed + w * (upper->d_speed - lower->d_speed);
+  out->ratio = lower->ratio + w * (upper->ratio - lower->ratio);
+  return 1;
+}
+
+// the estimated time in seconds to compress, write, read and decompress one MiB
+static double estimated_time(const config_file_entry_t * e, float io){
+  double time = 1.0 / (double) e->c_speed + 1.0 / (double) e->d_speed;
+  if(io > 0){
+    time += 2.0 * (double) e->ratio / (double) io;
+  }
+  return time;
+}
+
+typedef struct{
+  char name[SCIL_LEARNING_CHAIN_LENGTH];
+  scilI_chain_t chain;
+  // the estimate is valid
+  int known;
+  config_file_entry_t estimate;
+  uint32_t observations;
+} candidate_t;
+
+#define CANDIDATES_MAX 64
+
+// adds the chain once under its canonical name if it may be used for the context
+static void add_candidate(candidate_t * candidates, int * count, const char * name, const scil_context_t * ctx){
+  if(*count == CANDIDATES_MAX){
+    return;
+  }
+  candidate_t * c = & candidates[*count];
+  memset(c, 0, sizeof(candidate_t));
+  if(scilI_create_chain(& c->chain, name) != SCIL_NO_ERR || scilI_chain_is_applicable(& c->chain, ctx->datatype) != SCIL_NO_ERR ||
+     ! chain_is_accurate(& c->chain, ctx)){
+    return;
+  }
+  scilI_chain_sprint(& c->chain, c->name, sizeof(c->name));
+  for(int i=0; i < *count; i++){
+    if(strcmp(candidates[i].name, c->name) == 0){
+      return;
+    }
+  }
+  (*count)++;
+}
 
-  parse_losless_list();
+// the candidates are the chains of the configuration, with learning also the built-in byte compressors and the learned chains
+static int collect_candidates(candidate_t * candidates, const scil_context_t * ctx){
+  int count = 0;
+  for(int i=0; i < config_list_size; i++){
+    add_candidate(candidates, & count, config_list[i].name, ctx);
+  }
+  if(scilC_learning_enabled()){
+    add_candidate(candidates, & count, "memcopy", ctx);
+    add_candidate(candidates, & count, "lz4", ctx);
+    char learned[CANDIDATES_MAX][SCIL_LEARNING_CHAIN_LENGTH];
+    const int learned_count = scilC_learning_chains(ctx->datatype, learned, CANDIDATES_MAX);
+    for(int i=0; i < learned_count; i++){
+      add_candidate(candidates, & count, learned[i], ctx);
+    }
+  }
+  return count;
+}
+
+// the measurements of scil.conf, replaced by the observations of the chain if there are any
+static void estimate_candidate(candidate_t * c, const scil_context_t * ctx, float randomness, size_t size){
+  c->known = estimate_chain(c->name, ctx, randomness, & c->estimate);
+  scilC_learned_t learned;
+  if(scilC_learning_enabled() && scilC_learning_lookup(c->name, ctx->datatype, size, & learned)){
+    if(! c->known){
+      // without a measurement the decompression is assumed to be as fast as the compression
+      c->estimate.d_speed = learned.c_speed;
+    }
+    c->estimate.c_speed = learned.c_speed;
+    c->estimate.ratio = learned.ratio;
+    c->observations = learned.count;
+    c->known = 1;
+  }
+}
+
+/*
+ Picks the chain with the smallest estimated time to compress, write, read and decompress one MiB of data.
+ With learning, a chain that has not been observed yet is tried first, and every SCIL_LEARNING_EXPLORE_INTERVAL-th
+ decision of a context tries the least observed chain instead of the best one, thus the statistics follow the data.
+ Returns 0 if no chain may be used for the context.
+ */
+static int choose_by_cost(float randomness, size_t size, scil_context_t* ctx){
+  const float io = io_speed();
+  const float c_required = required_speed(& ctx->hints.comp_speed);
+  const float d_required = required_speed(& ctx->hints.decomp_speed);
+  const int learning = scilC_learning_enabled();
+  const int explore = learning && ctx->chooser_decisions++ % SCIL_LEARNING_EXPLORE_INTERVAL == SCIL_LEARNING_EXPLORE_INTERVAL - 1;
+
+  candidate_t candidates[CANDIDATES_MAX];
+  const int count = collect_candidates(candidates, ctx);
+  const candidate_t * best = NULL;
+  double best_time = 0;
+  const candidate_t * unobserved = NULL;
+  const candidate_t * least_observed = NULL;
+  for(int i=0; i < count; i++){
+    candidate_t * c = & candidates[i];
+    estimate_candidate(c, ctx, randomness, size);
+    if(c->known && (c->estimate.c_speed <= 0 || c->estimate.d_speed <= 0 || c->estimate.c_speed < c_required || c->estimate.d_speed < d_required)){
+      continue;
+    }
+    if(learning && c->observations == 0 && unobserved == NULL){
+      unobserved = c;
+    }
+    if(! c->known){
+      continue;
+    }
+    const double time = estimated_time(& c->estimate, io);
+    debug("Chain %s estimated with %.3f ms/MiB\n", c->name, time * 1000);
+    if(best == NULL || time < best_time){
+      best = c;
+      best_time = time;
+    }
+    if(least_observed == NULL || c->observations < least_observed->observations){
+      least_observed = c;
+    }
+  }
+  if(learning && unobserved != NULL){
+    best = unobserved;
+  }else if(explore && least_observed != NULL){
+    best = least_observed;
+  }
+  if(best == NULL){
+    return 0;
+  }
+  ctx->chain = best->chain;
+  return 1;
+}
+
+// picks the best chain of the leaf of the model that may be used for the context, returns 0 if there is none
+static int choose_by_model(const scilI_data_features_t * data, const scil_dims_t* dims, scil_context_t* ctx){
+  float features[SCIL_MODEL_FEATURE_COUNT];
+  scilC_chooser_model_features(data, dims, & ctx->hints, features);
+  const int * ranking;
+  const int count = scilC_chooser_model_evaluate(features, & ranking);
+  for(int i=0; i < count; i++){
+    scilI_chain_t chain;
+    memset(& chain, 0, sizeof(chain));
+    if(scilI_create_chain(& chain, scilC_chooser_model_chain(ranking[i])) == SCIL_NO_ERR &&
+       scilI_chain_is_applicable(& chain, ctx->datatype) == SCIL_NO_ERR && chain_is_accurate(& chain, ctx)){
+      ctx->chain = chain;
+      return 1;
+    }
+  }
+  return 0;
 }
 
 void scilC_algo_chooser_execute(const void* restrict source,
@@ -139,9 +461,13 @@ void scilC_algo_chooser_execute(const void* restrict source,
   scilI_chain_t * chain = &ctx->chain;
   int ret;
 
-  // at the moment we only set the compression algorith once
-  if (chain->total_size != 0){
-    return;
+  // the decision is kept unless it is revised with the learned statistics
+  const int revise = chain->total_size != 0;
+  if (revise){
+    if (! ctx->chain_adaptive || ++ctx->chooser_calls < SCIL_LEARNING_DECISION_INTERVAL){
+      return;
+    }
+    ctx->chooser_calls = 0;
   }
   char * chainEnv = getenv("SCIL_FORCE_COMPRESSION_CHAIN");
   if (chainEnv != NULL){
@@ -163,25 +489,101 @@ void scilC_algo_chooser_execute(const void* restrict source,
     return;
   }
 
-  size_t out_size = 15000;
-  byte buffer[15000];
-  size_t in_size = 10000;
-  if (count < in_size){
-    in_size = count;
+  // a cached decision for the variable is reused without looking at the data, unless it is due for a check
+  scilC_decision_t decision;
+  int revalidate = 0;
+  const int cached = ! revise && scilC_decision_cache_lookup(ctx, dims, & decision, & revalidate);
+  if (cached && ! revalidate && scilI_create_chain(chain, decision.chain) == SCIL_NO_ERR){
+    ctx->chain_adaptive = scilC_learning_enabled();
+    return;
   }
 
-  float r = scilI_get_data_randomness(source, in_size, buffer, out_size);
-  if (ctx->lossless_compression_needed){
-      // we can only select byte compressors compress because data must be accurate!
+  // the chain has not been executed yet, thus the workspace is free
+  // the model is consulted for the first decision, revisions rely on the learned statistics
+  const int use_model = ! revise && scilC_chooser_model_loaded();
+  scilI_data_features_t features;
+  float r;
+  const int trace = scilU_trace_enabled();
+  scil_timer sample_timer;
+  if (trace){
+    scilU_start_timer(& sample_timer);
+  }
+  if (use_model){
+    scilI_sample_data_features(source, ctx->datatype, dims, ctx->sample_size, ctx->workspace, & features);
+    r = features.randomness;
+  }else{
+    r = scilI_sample_data_randomness(source, ctx->datatype, dims, ctx->sample_size, ctx->workspace);
+  }
+  if (trace){
+    scilU_trace_span("sample", "compress", sample_timer, 0, 0);
+  }
+  if (cached && fabsf(r - decision.randomness) <= SCIL_DECISION_CACHE_TOLERANCE && scilI_create_chain(chain, decision.chain) == SCIL_NO_ERR){
+    scilC_decision_cache_store(ctx, dims, & decision);
+    ctx->chain_adaptive = scilC_learning_enabled();
+    return;
   }
-  // TODO: pick the best algorithm for the settings given in ctx...
 
-  if (r > 95){
-    ret = scilI_create_chain(chain, "memcopy");
+  if ((use_model && choose_by_model(& features, dims, ctx)) || choose_by_cost(r, scilPr_get_dims_size(dims, ctx->datatype), ctx)){
+    ctx->chain_adaptive = scilC_learning_enabled();
   }else{
-    ret = scilI_create_chain(chain, "lz4");
+    // without measurements only byte compressors are safe for any hints
+    if (r > 95){
+      ret = scilI_create_chain(chain, "memcopy");
+    }else{
+      ret = scilI_create_chain(chain, "lz4");
+    }
+    assert(ret == SCIL_NO_ERR);
+  }
+
+  scilI_chain_sprint(chain, decision.chain, sizeof(decision.chain));
+  decision.randomness = r;
+  scilC_decision_cache_store(ctx, dims, & decision);
+}
+
+static size_t chain_bound(const char* str, const scil_context_t* ctx, const scil_dims_t* dims){
+  scilI_chain_t chain;
+  memset(& chain, 0, sizeof(chain));
+  if (scilI_create_chain(& chain, str) != SCIL_NO_ERR){
+    return 0;
   }
+  return scilI_chain_compress_bound(& chain, ctx->datatype, dims, NULL);
+}
+
+int scilC_algo_chooser_fallback(const scil_dims_t* dims, scil_context_t* ctx){
+  char * chainEnv = getenv("SCIL_FORCE_COMPRESSION_CHAIN");
+  if (! ctx->chain.is_lossy || (chainEnv != NULL && strcmp(chainEnv, "lossless") != 0)){
+    return 0;
+  }
+  int ret = scilI_create_chain(& ctx->chain, "lz4");
   assert(ret == SCIL_NO_ERR);
+
+  // the cached decision for the variable would pick the failing chain again
+  scilC_decision_t decision;
+  int revalidate;
+  if (scilC_decision_cache_lookup(ctx, dims, & decision, & revalidate)){
+    scilI_chain_sprint(& ctx->chain, decision.chain, sizeof(decision.chain));
+    scilC_decision_cache_store(ctx, dims, & decision);
+  }
+  return 1;
+}
+
+size_t scilC_algo_chooser_compress_bound(const scil_context_t* ctx, const scil_dims_t* dims){
+  char * chainEnv = getenv("SCIL_FORCE_COMPRESSION_CHAIN");
+  if (chainEnv != NULL && strcmp(chainEnv, "lossless") != 0){
+    return chain_bound(chainEnv, ctx, dims);
+  }
+  // keep in sync with the candidates of scilC_algo_chooser_execute()
+  size_t bound = chain_bound("memcopy", ctx, dims);
+  bound = max(bound, chain_bound("lz4", ctx, dims));
+  candidate_t candidates[CANDIDATES_MAX];
+  const int count = collect_candidates(candidates, ctx);
+  for(int i=0; i < count; i++){
+    bound = max(bound, scilI_chain_compress_bound(& candidates[i].chain, ctx->datatype, dims, NULL));
+  }
+  for(int i=0; i < scilC_chooser_model_chain_count(); i++){
+    bound = max(bound, chain_bound(scilC_chooser_model_chain(i), ctx, dims));
+  }
+  return bound;
 }
 
 
@@ -205,3 +607,9 @@ for(int i=0; i < count; i++){
 }
 printf("%f %f stddev %f\n", mn, mx, stddev/spread/spread/count/count);
 */
+
+void scilC_algo_chooser_learn(const scil_context_t* ctx, size_t size, size_t out_size, double seconds){
+  char name[SCIL_LEARNING_CHAIN_LENGTH];
+  scilI_chain_sprint(& ctx->chain, name, sizeof(name));
+  scilC_learning_record(name, ctx->datatype, size, out_size, seconds);
+}
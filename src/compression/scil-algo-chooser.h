@@ -25,4 +25,22 @@ void scilC_algo_chooser_execute(const void* restrict source,
                                 const scil_dims_t* dims,
                                 scil_context_t* ctx);
 
+/**
+ * \brief Replaces a lossy chain chosen by scilC_algo_chooser_execute() that failed for the data by lz4.
+ * A lossy algorithm may not reach the tolerance for the range of the data, the lossless chain always works.
+ * A context choosing with learning still revises the chain later, the caller records the failure in the statistics.
+ * \return 1 if the chain was replaced, 0 if the chain is lossless or forced by SCIL_FORCE_COMPRESSION_CHAIN
+ */
+int scilC_algo_chooser_fallback(const scil_dims_t* dims, scil_context_t* ctx);
+
+/**
+ * \brief Returns the maximum compressed size among the chains scilC_algo_chooser_execute() may select.
+ */
+size_t scilC_algo_chooser_compress_bound(const scil_context_t* ctx, const scil_dims_t* dims);
+
+/**
+ * \brief Adds the observed compression with the chain of the context to the learned statistics.
+ */
+void scilC_algo_chooser_learn(const scil_context_t* ctx, size_t size, size_t out_size, double seconds);
+
 #endif // SCIL_ALGO_CHOOSER_H
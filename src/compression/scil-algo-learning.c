@@ -0,0 +1,197 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-algo-learning.h>
+
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-util.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct{
+  char chain[SCIL_LEARNING_CHAIN_LENGTH];
+  int datatype;
+  int size_class;
+  scilC_learned_t stats;
+} learned_entry_t;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static learned_entry_t * entries = NULL;
+static int entry_count = 0;
+static int entry_capacity = 0;
+
+// set once during the initialization of the library
+static const char * statistics_file = NULL;
+
+void scilC_learning_initialize(){
+  statistics_file = scilU_persist_with_env("SCIL_LEARNED_STATISTICS_FILE", "learned statistics", scilC_learning_load, scilC_learning_save);
+}
+
+int scilC_learning_enabled(){
+  return statistics_file != NULL;
+}
+
+int scilC_learning_size_class(size_t size){
+  int size_class = 0;
+  for(size >>= 12; size > 0 && size_class < SCIL_LEARNING_SIZE_CLASSES - 1; size >>= 2){
+    size_class++;
+  }
+  return size_class;
+}
+
+// must be called with the lock held
+static learned_entry_t * find_entry(const char* chain, int datatype, int size_class){
+  for(int i=0; i < entry_count; i++){
+    learned_entry_t * e = & entries[i];
+    if(e->datatype == datatype && e->size_class == size_class && strcmp(e->chain, chain) == 0){
+      return e;
+    }
+  }
+  return NULL;
+}
+
+// must be called with the lock held
+static learned_entry_t * add_entry(const char* chain, int datatype, int size_class){
+  if(strlen(chain) >= SCIL_LEARNING_CHAIN_LENGTH){
+    return NULL;
+  }
+  if(entry_count == entry_capacity){
+    const int capacity = entry_capacity == 0 ? 16 : entry_capacity * 2;
+    learned_entry_t * grown = (learned_entry_t*) realloc(entries, capacity * sizeof(learned_entry_t));
+    if(grown == NULL){
+      return NULL;
+    }
+    entries = grown;
+    entry_capacity = capacity;
+  }
+  learned_entry_t * e = & entries[entry_count++];
+  memset(e, 0, sizeof(learned_entry_t));
+  strcpy(e->chain, chain);
+  e->datatype = datatype;
+  e->size_class = size_class;
+  return e;
+}
+
+void scilC_learning_record(const char* chain, SCIL_Datatype_t datatype, size_t size, size_t out_size, double seconds){
+  if(size == 0 || seconds <= 0){
+    return;
+  }
+  const float c_speed = (float) (size / seconds / 1024 / 1024);
+  const float ratio = (float) ((double) out_size / size);
+  const int size_class = scilC_learning_size_class(size);
+
+  pthread_mutex_lock(& lock);
+  learned_entry_t * e = find_entry(chain, datatype, size_class);
+  if(e == NULL){
+    e = add_entry(chain, datatype, size_class);
+  }
+  if(e != NULL){
+    scilC_learned_t * s = & e->stats;
+    if(s->count == 0){
+      s->c_speed = c_speed;
+      s->ratio = ratio;
+    }else{
+      s->c_speed += SCIL_LEARNING_WEIGHT * (c_speed - s->c_speed);
+      s->ratio += SCIL_LEARNING_WEIGHT * (ratio - s->ratio);
+    }
+    s->count++;
+  }
+  pthread_mutex_unlock(& lock);
+}
+
+int scilC_learning_lookup(const char* chain, SCIL_Datatype_t datatype, size_t size, scilC_learned_t* out){
+  pthread_mutex_lock(& lock);
+  const learned_entry_t * e = find_entry(chain, datatype, scilC_learning_size_class(size));
+  if(e != NULL){
+    *out = e->stats;
+  }
+  pthread_mutex_unlock(& lock);
+  return e != NULL;
+}
+
+int scilC_learning_chains(SCIL_Datatype_t datatype, char (*names)[SCIL_LEARNING_CHAIN_LENGTH], int max){
+  int count = 0;
+  pthread_mutex_lock(& lock);
+  for(int i=0; i < entry_count && count < max; i++){
+    if(entries[i].datatype != (int) datatype){
+      continue;
+    }
+    int seen = 0;
+    for(int j=0; j < count && ! seen; j++){
+      seen = strcmp(names[j], entries[i].chain) == 0;
+    }
+    if(! seen){
+      strcpy(names[count++], entries[i].chain);
+    }
+  }
+  pthread_mutex_unlock(& lock);
+  return count;
+}
+
+int scilC_learning_load(const char* filename){
+  FILE * f = fopen(filename, "r");
+  if(f == NULL){
+    return SCIL_EINVAL;
+  }
+  char line[1024];
+  pthread_mutex_lock(& lock);
+  while(fgets(line, sizeof(line), f) != NULL){
+    if(line[0] == '#'){
+      continue;
+    }
+    char chain[SCIL_LEARNING_CHAIN_LENGTH];
+    int datatype, size_class;
+    scilC_learned_t s;
+    if(sscanf(line, "%d; %d; %99[^;]; %f; %f; %u", & datatype, & size_class, chain, & s.c_speed, & s.ratio, & s.count) != 6 ||
+       size_class < 0 || size_class >= SCIL_LEARNING_SIZE_CLASSES){
+      warn("Invalid line in the learned statistics \"%s\"\n", line);
+      continue;
+    }
+    learned_entry_t * e = find_entry(chain, datatype, size_class);
+    if(e == NULL){
+      e = add_entry(chain, datatype, size_class);
+    }
+    if(e != NULL){
+      e->stats = s;
+    }
+  }
+  pthread_mutex_unlock(& lock);
+  fclose(f);
+  return SCIL_NO_ERR;
+}
+
+int scilC_learning_save(const char* filename){
+  FILE * f = fopen(filename, "w");
+  if(f == NULL){
+    return SCIL_EINVAL;
+  }
+  fprintf(f, "# datatype; size class; chain; compression MiB/s; compressed size / original size; observations\n");
+  pthread_mutex_lock(& lock);
+  for(int i=0; i < entry_count; i++){
+    const learned_entry_t * e = & entries[i];
+    fprintf(f, "%d; %d; %s; %.3f; %.5f; %u\n", e->datatype, e->size_class, e->chain, (double) e->stats.c_speed, (double) e->stats.ratio, e->stats.count);
+  }
+  pthread_mutex_unlock(& lock);
+  return fclose(f) == 0 ? SCIL_NO_ERR : SCIL_EINVAL;
+}
+
+void scilC_learning_reset(){
+  pthread_mutex_lock(& lock);
+  entry_count = 0;
+  pthread_mutex_unlock(& lock);
+}
@@ -0,0 +1,79 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_ALGO_LEARNING_H
+#define SCIL_ALGO_LEARNING_H
+
+#include <scil-datatypes.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ The learned statistics hold the compression speed and ratio the chooser observed for each chain,
+ per datatype and size class. They are moving averages, thus old observations fade out when the data drifts.
+ Learning is enabled by the environment variable SCIL_LEARNED_STATISTICS_FILE, the statistics are read
+ from the file when the library is initialized and written back when the process exits.
+ */
+#define SCIL_LEARNING_WEIGHT 0.25f
+
+// a context revises the chain chosen with learning after this many compressions
+#define SCIL_LEARNING_DECISION_INTERVAL 4
+
+// every n-th decision of a context tries the least observed chain instead of the best one
+#define SCIL_LEARNING_EXPLORE_INTERVAL 8
+
+// the size classes grow by a factor of four, starting with data below 4 KiB
+#define SCIL_LEARNING_SIZE_CLASSES 16
+
+#define SCIL_LEARNING_CHAIN_LENGTH 100
+
+typedef struct{
+  float c_speed;
+  float ratio;
+  uint32_t count;
+} scilC_learned_t;
+
+void scilC_learning_initialize();
+
+int scilC_learning_enabled();
+
+int scilC_learning_size_class(size_t size);
+
+/**
+ * \brief Adds the observed compression of size bytes to out_size bytes within seconds to the statistics of the chain.
+ */
+void scilC_learning_record(const char* chain, SCIL_Datatype_t datatype, size_t size, size_t out_size, double seconds);
+
+/**
+ * \brief Returns 1 and the statistics of the chain for data of the size if the chain has been observed, otherwise 0.
+ */
+int scilC_learning_lookup(const char* chain, SCIL_Datatype_t datatype, size_t size, scilC_learned_t* out);
+
+/**
+ * \brief Copies the names of up to max chains observed for the datatype into names and returns their number.
+ */
+int scilC_learning_chains(SCIL_Datatype_t datatype, char (*names)[SCIL_LEARNING_CHAIN_LENGTH], int max);
+
+int scilC_learning_load(const char* filename);
+
+int scilC_learning_save(const char* filename);
+
+/**
+ * \brief Forgets all statistics.
+ */
+void scilC_learning_reset();
+
+#endif // SCIL_ALGO_LEARNING_H
@@ -0,0 +1,369 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-async.h>
+
+#include <scil.h>
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-parallel.h>
+
+#include <pthread.h>
+#include <string.h>
+
+enum request_state {
+  REQUEST_QUEUED,
+  REQUEST_RUNNING,
+  REQUEST_DONE
+};
+
+struct scil_request {
+  // NULL for decompression
+  scil_context_t* ctx;
+  SCIL_Datatype_t datatype;
+  scil_dims_t dims;
+
+  void* dest;
+  size_t dest_size;
+  // for compression the staging copy of the data
+  void* source;
+  size_t source_size;
+  int staging;
+
+  scil_request_callback_t callback;
+  void* user_ptr;
+  // the caller did not keep a handle, the request is released after completion
+  int detached;
+
+  enum request_state state;
+  int ret;
+  size_t out_size;
+
+  struct scil_request* next;
+};
+
+typedef struct scil_async_context {
+  // a request of the context is running
+  int busy;
+  // queued and running requests
+  size_t pending;
+
+  void* staging[SCIL_ASYNC_STAGING_BUFFERS];
+  size_t staging_size[SCIL_ASYNC_STAGING_BUFFERS];
+  int staging_used[SCIL_ASYNC_STAGING_BUFFERS];
+} scilC_async_context_t;
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t lock     = PTHREAD_MUTEX_INITIALIZER;
+// signalled when a request is queued or a context becomes idle
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+// signalled when a request is done
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static int worker_count = 0;
+
+static scil_request_t* queue_head = NULL;
+static scil_request_t* queue_tail = NULL;
+
+static void execute(scil_request_t* r)
+{
+  if (r->ctx != NULL) {
+    r->ret = scil_compress((byte*) r->dest, r->dest_size, r->source, &r->dims, &r->out_size, r->ctx);
+  } else {
+    r->ret = scil_decompress(r->datatype, r->dest, &r->dims, (byte*) r->source, r->source_size, NULL);
+    r->out_size = scilPr_get_dims_size(&r->dims, r->datatype);
+  }
+}
+
+// the context may run its next request and its staging buffer is free, must be called with the lock held
+static void release(scil_request_t* r)
+{
+  if (r->ctx != NULL) {
+    scilC_async_context_t* async = r->ctx->async;
+    async->busy = 0;
+    async->staging_used[r->staging] = 0;
+    pthread_cond_broadcast(&work_cond);
+    pthread_cond_broadcast(&done_cond);
+  }
+}
+
+// must be called with the lock held after the callback
+static void finish(scil_request_t* r)
+{
+  if (r->ctx != NULL) {
+    r->ctx->async->pending--;
+  }
+  r->state = REQUEST_DONE;
+  pthread_cond_broadcast(&done_cond);
+}
+
+// the callback may submit the next request of the same context, thus the context is released before
+static void complete(scil_request_t* r)
+{
+  pthread_mutex_lock(&lock);
+  release(r);
+  pthread_mutex_unlock(&lock);
+  if (r->callback != NULL) {
+    r->callback(r->user_ptr, r->ret, r->out_size);
+  }
+  pthread_mutex_lock(&lock);
+  finish(r);
+  if (r->detached) {
+    free(r);
+  }
+}
+
+// the first queued request whose context is idle, must be called with the lock held
+static scil_request_t* dequeue()
+{
+  scil_request_t* prev = NULL;
+  for (scil_request_t* r = queue_head; r != NULL; prev = r, r = r->next) {
+    if (r->ctx != NULL && r->ctx->async->busy) {
+      continue;
+    }
+    if (prev == NULL) {
+      queue_head = r->next;
+    } else {
+      prev->next = r->next;
+    }
+    if (queue_tail == r) {
+      queue_tail = prev;
+    }
+    r->next = NULL;
+    return r;
+  }
+  return NULL;
+}
+
+static void* worker_main(void* arg)
+{
+  pthread_mutex_lock(&lock);
+  while (1) {
+    scil_request_t* r = dequeue();
+    if (r == NULL) {
+      pthread_cond_wait(&work_cond, &lock);
+      continue;
+    }
+    if (r->ctx != NULL) {
+      r->ctx->async->busy = 1;
+    }
+    r->state = REQUEST_RUNNING;
+    pthread_mutex_unlock(&lock);
+
+    execute(r);
+    complete(r);
+  }
+  return NULL;
+}
+
+static void start_pool()
+{
+  const int count = scilI_parallel_default_thread_count();
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  for (int i = 0; i < count; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, worker_main, NULL) != 0) {
+      warn("could only start %d of %d background threads\n", worker_count, count);
+      break;
+    }
+    worker_count++;
+  }
+  pthread_attr_destroy(&attr);
+}
+
+static int submit(scil_request_t** out_request, scil_request_t* r)
+{
+  r->detached = out_request == NULL;
+  if (out_request != NULL) {
+    *out_request = r;
+  }
+
+  pthread_once(&pool_once, start_pool);
+  if (worker_count == 0) {
+    // without background threads the request completes before the call returns
+    r->state = REQUEST_RUNNING;
+    execute(r);
+    complete(r);
+    pthread_mutex_unlock(&lock);
+    return SCIL_NO_ERR;
+  }
+
+  pthread_mutex_lock(&lock);
+  r->state = REQUEST_QUEUED;
+  if (queue_tail == NULL) {
+    queue_head = r;
+  } else {
+    queue_tail->next = r;
+  }
+  queue_tail = r;
+  pthread_cond_signal(&work_cond);
+  pthread_mutex_unlock(&lock);
+  return SCIL_NO_ERR;
+}
+
+// must be called with the lock held
+static int free_staging(const scilC_async_context_t* async)
+{
+  for (int i = 0; i < SCIL_ASYNC_STAGING_BUFFERS; i++) {
+    if (! async->staging_used[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int scil_compress_async(scil_request_t** out_request,
+                        byte* restrict dest,
+                        size_t in_dest_size,
+                        const void* restrict source,
+                        const scil_dims_t* dims,
+                        scil_context_t* ctx,
+                        scil_request_callback_t callback,
+                        void* user_ptr)
+{
+  assert(ctx != NULL);
+  assert(dest != NULL);
+  assert(source != NULL);
+  if (out_request == NULL && callback == NULL) {
+    return SCIL_EINVAL;
+  }
+
+  scil_request_t* r = (scil_request_t*) calloc(1, sizeof(scil_request_t));
+  if (r == NULL) {
+    return SCIL_MEMORY_ERR;
+  }
+  r->ctx         = ctx;
+  r->datatype    = ctx->datatype;
+  r->dims        = *dims;
+  r->dest        = dest;
+  r->dest_size   = in_dest_size;
+  r->source_size = scilPr_get_dims_size(dims, ctx->datatype);
+  r->callback    = callback;
+  r->user_ptr    = user_ptr;
+
+  // take a free staging buffer, waiting for the oldest request if both are in use
+  pthread_mutex_lock(&lock);
+  if (ctx->async == NULL) {
+    ctx->async = (scilC_async_context_t*) calloc(1, sizeof(scilC_async_context_t));
+    if (ctx->async == NULL) {
+      pthread_mutex_unlock(&lock);
+      free(r);
+      return SCIL_MEMORY_ERR;
+    }
+  }
+  scilC_async_context_t* async = ctx->async;
+  while ((r->staging = free_staging(async)) < 0) {
+    pthread_cond_wait(&done_cond, &lock);
+  }
+  async->staging_used[r->staging] = 1;
+  async->pending++;
+  pthread_mutex_unlock(&lock);
+
+  // the staging buffer belongs to this request now
+  if (async->staging_size[r->staging] < r->source_size) {
+    free(async->staging[r->staging]);
+    async->staging[r->staging]      = malloc(r->source_size);
+    async->staging_size[r->staging] = async->staging[r->staging] != NULL ? r->source_size : 0;
+    if (async->staging[r->staging] == NULL) {
+      pthread_mutex_lock(&lock);
+      async->staging_used[r->staging] = 0;
+      async->pending--;
+      pthread_cond_broadcast(&done_cond);
+      pthread_mutex_unlock(&lock);
+      free(r);
+      return SCIL_MEMORY_ERR;
+    }
+  }
+  memcpy(async->staging[r->staging], source, r->source_size);
+  r->source = async->staging[r->staging];
+
+  return submit(out_request, r);
+}
+
+int scil_decompress_async(scil_request_t** out_request,
+                          SCIL_Datatype_t datatype,
+                          void* restrict dest,
+                          const scil_dims_t* dims,
+                          byte* restrict source,
+                          const size_t source_size,
+                          scil_request_callback_t callback,
+                          void* user_ptr)
+{
+  assert(dest != NULL);
+  assert(source != NULL);
+  if (out_request == NULL && callback == NULL) {
+    return SCIL_EINVAL;
+  }
+
+  scil_request_t* r = (scil_request_t*) calloc(1, sizeof(scil_request_t));
+  if (r == NULL) {
+    return SCIL_MEMORY_ERR;
+  }
+  r->datatype    = datatype;
+  r->dims        = *dims;
+  r->dest        = dest;
+  r->source      = source;
+  r->source_size = source_size;
+  r->callback    = callback;
+  r->user_ptr    = user_ptr;
+
+  return submit(out_request, r);
+}
+
+int scil_test(scil_request_t* request, int* done)
+{
+  assert(request != NULL);
+  pthread_mutex_lock(&lock);
+  *done = request->state == REQUEST_DONE;
+  pthread_mutex_unlock(&lock);
+  return SCIL_NO_ERR;
+}
+
+int scil_wait(scil_request_t* request, size_t* out_size)
+{
+  assert(request != NULL);
+  pthread_mutex_lock(&lock);
+  while (request->state != REQUEST_DONE) {
+    pthread_cond_wait(&done_cond, &lock);
+  }
+  pthread_mutex_unlock(&lock);
+
+  const int ret = request->ret;
+  if (out_size != NULL) {
+    *out_size = request->out_size;
+  }
+  free(request);
+  return ret;
+}
+
+void scilC_async_context_destroy(scil_context_t* ctx)
+{
+  scilC_async_context_t* async = ctx->async;
+  if (async == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&lock);
+  while (async->pending > 0) {
+    pthread_cond_wait(&done_cond, &lock);
+  }
+  pthread_mutex_unlock(&lock);
+
+  for (int i = 0; i < SCIL_ASYNC_STAGING_BUFFERS; i++) {
+    free(async->staging[i]);
+  }
+  free(async);
+  ctx->async = NULL;
+}
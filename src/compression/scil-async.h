@@ -0,0 +1,34 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_ASYNC_H
+#define SCIL_ASYNC_H
+
+#include <scil-cca.h>
+
+/*
+ Asynchronous requests are executed by a pool of background threads started with the first request.
+ Requests of one context run one after another in the order of submission, as a context must not be
+ used concurrently. The source of a compression is copied into one of two staging buffers of the
+ context, a third request waits until the oldest one finished.
+ */
+#define SCIL_ASYNC_STAGING_BUFFERS 2
+
+/**
+ * \brief Waits for the pending requests of the context and releases its staging buffers.
+ */
+void scilC_async_context_destroy(scil_context_t* ctx);
+
+#endif // SCIL_ASYNC_H
@@ -0,0 +1,169 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil.h>
+#include <scil-cca.h>
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-parallel.h>
+
+#include <assert.h>
+#include <stdlib.h>
+
+// the context of a worker is kept as long as consecutive items use the same settings
+typedef struct {
+  scil_context_t* ctx;
+  SCIL_Datatype_t datatype;
+  const scil_user_hints_t* hints;
+} batch_worker_t;
+
+typedef struct {
+  size_t size;
+  size_t item;
+} batch_order_t;
+
+typedef struct {
+  scil_batch_item_t* items;
+  const batch_order_t* order;
+  batch_worker_t* workers;
+} batch_job_t;
+
+static int compare_size_descending(const void* a, const void* b)
+{
+  const batch_order_t* x = (const batch_order_t*) a;
+  const batch_order_t* y = (const batch_order_t*) b;
+  if (x->size != y->size) {
+    return x->size < y->size ? 1 : -1;
+  }
+  // keep the order of the items stable
+  return x->item < y->item ? -1 : (x->item > y->item);
+}
+
+static int worker_context(batch_worker_t* w, const scil_batch_item_t* item)
+{
+  if (w->ctx != NULL && w->datatype == item->datatype && w->hints == item->hints) {
+    return SCIL_NO_ERR;
+  }
+  if (w->ctx != NULL) {
+    scilPr_destroy_context(w->ctx);
+    w->ctx = NULL;
+  }
+
+  scil_user_hints_t defaults;
+  const scil_user_hints_t* hints = item->hints;
+  if (hints == NULL) {
+    scilPr_initialize_user_hints(&defaults);
+    hints = &defaults;
+  }
+  int ret = scilPr_create_context(&w->ctx, item->datatype, 0, NULL, hints);
+  if (ret != SCIL_NO_ERR) {
+    w->ctx = NULL;
+    return ret;
+  }
+  w->datatype = item->datatype;
+  w->hints    = item->hints;
+  return SCIL_NO_ERR;
+}
+
+static int compress_item(scil_batch_item_t* item, batch_worker_t* w)
+{
+  int ret = worker_context(w, item);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+  if (w->ctx->hints.force_compression_methods == NULL) {
+    // the chooser keeps its first decision for a context, each variable gets its own like with a new context
+    w->ctx->chain.total_size = 0;
+  }
+
+  if (item->dest != NULL) {
+    return scil_compress(item->dest, item->dest_size, item->source, &item->dims, &item->out_size, w->ctx);
+  }
+
+  // the buffer is shrunk to the actual size after compression
+  const size_t limit = scil_compress_bound(w->ctx, &item->dims);
+  byte* dest = (byte*) malloc(limit);
+  if (dest == NULL) {
+    return SCIL_MEMORY_ERR;
+  }
+  ret = scil_compress(dest, limit, item->source, &item->dims, &item->out_size, w->ctx);
+  if (ret != SCIL_NO_ERR) {
+    free(dest);
+    return ret;
+  }
+  byte* shrunk = (byte*) realloc(dest, item->out_size);
+  item->dest      = shrunk != NULL ? shrunk : dest;
+  item->dest_size = item->out_size;
+  return SCIL_NO_ERR;
+}
+
+static int batch_func(void* user, size_t index, int worker)
+{
+  batch_job_t* job        = (batch_job_t*) user;
+  scil_batch_item_t* item = &job->items[job->order[index].item];
+
+  // a failing item does not stop the others, its error is reported in the item
+  item->ret = compress_item(item, &job->workers[worker]);
+  return SCIL_NO_ERR;
+}
+
+int scil_compress_batch(scil_batch_item_t* items, size_t count, int thread_count)
+{
+  if (count == 0) {
+    return SCIL_NO_ERR;
+  }
+  assert(items != NULL);
+
+  if (thread_count <= 0) {
+    thread_count = scilI_parallel_default_thread_count();
+  }
+  if ((size_t) thread_count > count) {
+    thread_count = (int) count;
+  }
+
+  batch_order_t* order    = (batch_order_t*) malloc(count * sizeof(batch_order_t));
+  batch_worker_t* workers = (batch_worker_t*) calloc(thread_count, sizeof(batch_worker_t));
+  if (order == NULL || workers == NULL) {
+    free(order);
+    free(workers);
+    return SCIL_MEMORY_ERR;
+  }
+
+  // the largest items are handed out first, thus the small ones fill the gaps at the end
+  for (size_t i = 0; i < count; i++) {
+    order[i].size = scilPr_get_dims_size(&items[i].dims, items[i].datatype);
+    order[i].item = i;
+    items[i].out_size = 0;
+    items[i].ret      = SCIL_NO_ERR;
+  }
+  qsort(order, count, sizeof(batch_order_t), compare_size_descending);
+
+  // each worker creates its contexts when it needs them, a context that cannot be created fails its item only
+  batch_job_t job = {.items = items, .order = order, .workers = workers};
+  int ret = scilI_parallel_for(thread_count, count, batch_func, &job);
+
+  for (int i = 0; i < thread_count; i++) {
+    if (workers[i].ctx != NULL) {
+      scilPr_destroy_context(workers[i].ctx);
+    }
+  }
+  free(workers);
+  free(order);
+
+  for (size_t i = 0; i < count && ret == SCIL_NO_ERR; i++) {
+    ret = items[i].ret;
+  }
+  return ret;
+}
@@ -0,0 +1,74 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_CHAIN_EXECUTION_H
+#define SCIL_CHAIN_EXECUTION_H
+
+#include <scil-context.h>
+#include <scil-dims.h>
+
+struct scil_stats;
+
+/**
+ * \brief Applies the chain stored in ctx to the complete buffer.
+ * In contrast to scil_compress(), the algorithm chooser is not invoked.
+ */
+int scilC_compress_chain(byte* restrict dest,
+                         size_t dest_size,
+                         void* restrict source,
+                         const scil_dims_t* dims,
+                         size_t* restrict out_size,
+                         scil_context_t* ctx);
+
+/**
+ * \brief Returns the maximum size of data compressed without tiling, see scil_compress_bound().
+ */
+size_t scilC_compress_chain_bound(const scil_context_t* ctx, const scil_dims_t* dims);
+
+/**
+ * \brief Returns the scratch memory needed to compress data of the given dimensions with the chain of ctx.
+ */
+size_t scilC_compress_workspace_size(const scil_context_t* ctx, const scil_dims_t* dims);
+
+/**
+ * \brief Returns the scratch memory scilC_decompress_chain() needs for the buffer, 0 for single-stage chains.
+ */
+size_t scilC_decompress_chain_scratch_size(SCIL_Datatype_t datatype, const scil_dims_t* dims, const byte* source, size_t source_size);
+
+/**
+ * \brief Decompresses data of any format like scil_decompress(), the stages are added to stats if it is not NULL.
+ */
+int scilC_decompress(SCIL_Datatype_t datatype,
+                     void* restrict dest,
+                     scil_dims_t* dims,
+                     byte* restrict source,
+                     const size_t source_size,
+                     byte* restrict buff_tmp1,
+                     struct scil_stats* stats);
+
+/**
+ * \brief Decompresses a single chain-encoded buffer as created by scilC_compress_chain().
+ * If buff_tmp1 is NULL, the scratch is taken from the workspace of the calling thread.
+ * If stats is not NULL, the stages are added to it.
+ */
+int scilC_decompress_chain(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           scil_dims_t* dims,
+                           byte* restrict source,
+                           const size_t source_size,
+                           byte* restrict buff_tmp1,
+                           struct scil_stats* stats);
+
+#endif // SCIL_CHAIN_EXECUTION_H
@@ -0,0 +1,235 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <scil-chooser-model.h>
+
+#include <scil-chain.h>
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-util.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct{
+  // -1 for a leaf
+  int feature;
+  float threshold;
+  // the child for values up to the threshold and above it, always behind the node
+  int left;
+  int right;
+  int chain_count;
+  int chains[SCIL_MODEL_LEAF_CHAINS];
+} model_node_t;
+
+static const char * feature_names[SCIL_MODEL_FEATURE_COUNT] = {
+  [SCIL_MODEL_FEATURE_DIMS] = "dims",
+  [SCIL_MODEL_FEATURE_LOG2_COUNT] = "log2_count",
+  [SCIL_MODEL_FEATURE_MEAN] = "mean",
+  [SCIL_MODEL_FEATURE_STDDEV] = "stddev",
+  [SCIL_MODEL_FEATURE_MAX_STEP] = "max_step",
+  [SCIL_MODEL_FEATURE_ABS_TOL] = "abs_tol",
+  [SCIL_MODEL_FEATURE_REL_TOL] = "rel_tol"
+};
+
+// the model is only replaced during the initialization of the library and by tests
+static model_node_t * nodes = NULL;
+static int node_count = 0;
+static char (* chains)[SCIL_MODEL_CHAIN_LENGTH] = NULL;
+static int chain_count = 0;
+
+void scilC_chooser_model_initialize(){
+  const char * filename = getenv("SCIL_CHOOSER_MODEL_FILE");
+  if(filename == NULL){
+    return;
+  }
+  if(scilC_chooser_model_load(filename) != SCIL_NO_ERR){
+    warn("Could not read the chooser model %s\n", filename);
+  }
+}
+
+int scilC_chooser_model_loaded(){
+  return node_count > 0;
+}
+
+static void clear(){
+  free(nodes);
+  free(chains);
+  nodes = NULL;
+  chains = NULL;
+  node_count = 0;
+  chain_count = 0;
+}
+
+static int parse_int(const char * str, int * out){
+  char * end;
+  *out = (int) strtol(str, & end, 10);
+  return end != str && *end == 0;
+}
+
+// returns the index of the chain in the model, adds it under its canonical name if needed
+// returns -1 if the chain is not available in this build and -2 without memory
+static int chain_index(const char * name){
+  scilI_chain_t chain;
+  memset(& chain, 0, sizeof(chain));
+  if(scilI_create_chain(& chain, name) != SCIL_NO_ERR){
+    return -1;
+  }
+  char canonical[SCIL_MODEL_CHAIN_LENGTH];
+  scilI_chain_sprint(& chain, canonical, sizeof(canonical));
+  for(int i=0; i < chain_count; i++){
+    if(strcmp(chains[i], canonical) == 0){
+      return i;
+    }
+  }
+  char (* grown)[SCIL_MODEL_CHAIN_LENGTH] = realloc(chains, (chain_count + 1) * sizeof(*chains));
+  if(grown == NULL){
+    return -2;
+  }
+  chains = grown;
+  strcpy(chains[chain_count], canonical);
+  return chain_count++;
+}
+
+/*
+ An inner node has the fields "node; feature; threshold; left; right", a leaf "node; leaf; chain; chain...".
+ The model may be trained with algorithms this build lacks, a leaf skips their chains.
+ */
+static int parse_node(char * line, model_node_t * n){
+  char * fields[SCIL_MODEL_LEAF_CHAINS + 2];
+  int count = 0;
+  char * saveptr;
+  for(char * token = strtok_r(line, ";", & saveptr); token != NULL; token = strtok_r(NULL, ";", & saveptr)){
+    if(count == SCIL_MODEL_LEAF_CHAINS + 2){
+      return 0;
+    }
+    fields[count++] = scilU_trim(token);
+  }
+  int index;
+  if(count < 3 || ! parse_int(fields[0], & index) || index != node_count){
+    return 0;
+  }
+  memset(n, 0, sizeof(model_node_t));
+  if(strcmp(fields[1], "leaf") == 0){
+    n->feature = -1;
+    for(int i=2; i < count; i++){
+      const int chain = chain_index(fields[i]);
+      if(chain == -2){
+        return 0;
+      }
+      if(chain == -1){
+        debug("The chain %s of the chooser model is not available\n", fields[i]);
+        continue;
+      }
+      n->chains[n->chain_count++] = chain;
+    }
+    return 1;
+  }
+  n->feature = -1;
+  for(int f=0; f < SCIL_MODEL_FEATURE_COUNT; f++){
+    if(strcmp(fields[1], feature_names[f]) == 0){
+      n->feature = f;
+    }
+  }
+  char * end;
+  n->threshold = strtof(fields[2], & end);
+  return n->feature >= 0 && count == 5 && end != fields[2] && *end == 0 &&
+         parse_int(fields[3], & n->left) && parse_int(fields[4], & n->right) && n->left > index && n->right > index;
+}
+
+int scilC_chooser_model_load(const char* filename){
+  clear();
+  FILE * f = fopen(filename, "r");
+  if(f == NULL){
+    return SCIL_EINVAL;
+  }
+  char line[4096];
+  int capacity = 0;
+  int ret = SCIL_NO_ERR;
+  while(ret == SCIL_NO_ERR && fgets(line, sizeof(line), f) != NULL){
+    if(line[0] == '#' || strlen(scilU_trim(line)) == 0){
+      continue;
+    }
+    if(node_count == capacity){
+      capacity = capacity == 0 ? 64 : capacity * 2;
+      model_node_t * grown = (model_node_t*) realloc(nodes, capacity * sizeof(model_node_t));
+      if(grown == NULL){
+        ret = SCIL_MEMORY_ERR;
+        break;
+      }
+      nodes = grown;
+    }
+    if(! parse_node(line, & nodes[node_count])){
+      warn("Invalid node %d in the chooser model\n", node_count);
+      ret = SCIL_EINVAL;
+      break;
+    }
+    node_count++;
+  }
+  fclose(f);
+  for(int i=0; i < node_count && ret == SCIL_NO_ERR; i++){
+    if(nodes[i].feature >= 0 && (nodes[i].left >= node_count || nodes[i].right >= node_count)){
+      warn("The node %d of the chooser model refers to a missing node\n", i);
+      ret = SCIL_EINVAL;
+    }
+  }
+  if(ret != SCIL_NO_ERR || node_count == 0){
+    clear();
+    return ret != SCIL_NO_ERR ? ret : SCIL_EINVAL;
+  }
+  debug("Chooser model with %d nodes and %d chains\n", node_count, chain_count);
+  return SCIL_NO_ERR;
+}
+
+// a tolerance is scaled by the value range, a constant field meets any tolerance
+static float scaled_tolerance(double tolerance, double range){
+  if(tolerance <= SCIL_ACCURACY_DBL_IGNORE){
+    return 0;
+  }
+  return range > 0 ? (float) (tolerance / range) : 1;
+}
+
+void scilC_chooser_model_features(const scilI_data_features_t* data, const scil_dims_t* dims, const scil_user_hints_t* hints, float* out){
+  const double range = data->max - data->min;
+  out[SCIL_MODEL_FEATURE_DIMS] = (float) dims->dims;
+  out[SCIL_MODEL_FEATURE_LOG2_COUNT] = (float) log2((double) scilPr_get_dims_count(dims));
+  out[SCIL_MODEL_FEATURE_MEAN] = range > 0 ? (float) ((data->mean - data->min) / range) : 0;
+  out[SCIL_MODEL_FEATURE_STDDEV] = range > 0 ? (float) (data->stddev / range) : 0;
+  out[SCIL_MODEL_FEATURE_MAX_STEP] = range > 0 ? (float) (data->max_step / range) : 0;
+  out[SCIL_MODEL_FEATURE_ABS_TOL] = scaled_tolerance(hints->absolute_tolerance, range);
+  out[SCIL_MODEL_FEATURE_REL_TOL] = hints->relative_tolerance_percent > SCIL_ACCURACY_DBL_IGNORE ? (float) hints->relative_tolerance_percent : 0;
+}
+
+int scilC_chooser_model_evaluate(const float* features, const int** out_chains){
+  if(node_count == 0){
+    return 0;
+  }
+  const model_node_t * n = & nodes[0];
+  while(n->feature >= 0){
+    n = & nodes[features[n->feature] <= n->threshold ? n->left : n->right];
+  }
+  *out_chains = n->chains;
+  return n->chain_count;
+}
+
+int scilC_chooser_model_chain_count(){
+  return chain_count;
+}
+
+const char* scilC_chooser_model_chain(int index){
+  return chains[index];
+}
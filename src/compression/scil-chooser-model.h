@@ -0,0 +1,77 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SCIL_CHOOSER_MODEL_H
+#define SCIL_CHOOSER_MODEL_H
+
+#include <scil-data-characteristics.h>
+#include <scil-dims.h>
+#include <scil-user-hints.h>
+
+/*
+ The chooser model is a decision tree trained by tools/scil-train-chooser-model.py from the output of
+ tools/scil-generate-chooser-data. Its inner nodes compare one feature of the data and the hints with a threshold,
+ its leaves rank the chains by the time the training data needed with them.
+ The model is read from the file named by the environment variable SCIL_CHOOSER_MODEL_FILE.
+ */
+
+// the features are scaled by the value range of the data, thus a model applies to data of any magnitude
+enum scilC_model_feature{
+  SCIL_MODEL_FEATURE_DIMS,
+  SCIL_MODEL_FEATURE_LOG2_COUNT,
+  SCIL_MODEL_FEATURE_MEAN,
+  SCIL_MODEL_FEATURE_STDDEV,
+  SCIL_MODEL_FEATURE_MAX_STEP,
+  SCIL_MODEL_FEATURE_ABS_TOL,
+  SCIL_MODEL_FEATURE_REL_TOL,
+  SCIL_MODEL_FEATURE_COUNT
+};
+
+// a leaf ranks at most this many chains
+#define SCIL_MODEL_LEAF_CHAINS 8
+
+#define SCIL_MODEL_CHAIN_LENGTH 100
+
+void scilC_chooser_model_initialize();
+
+int scilC_chooser_model_loaded();
+
+/**
+ * \brief Replaces the model with the one of the file.
+ * \return SCIL_NO_ERR, or SCIL_EINVAL if the file cannot be read or describes no valid tree; the model is empty then
+ */
+int scilC_chooser_model_load(const char* filename);
+
+/**
+ * \brief Computes the features of the model from the sampled statistics of the data and the accuracy hints.
+ */
+void scilC_chooser_model_features(const scilI_data_features_t* data, const scil_dims_t* dims, const scil_user_hints_t* hints, float* out);
+
+/**
+ * \brief Walks the tree with the features.
+ * \param out_chains set to the indices of the chains in the leaf, the best chain first, see scilC_chooser_model_chain()
+ * \return the number of chains in the leaf, 0 without a model
+ */
+int scilC_chooser_model_evaluate(const float* features, const int** out_chains);
+
+/**
+ * \brief Returns the number of distinct chains the leaves of the model name.
+ */
+int scilC_chooser_model_chain_count();
+
+const char* scilC_chooser_model_chain(int index);
+
+#endif // SCIL_CHOOSER_MODEL_H
@@ -0,0 +1,150 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-decision-cache.h>
+
+#include <scil-dict.h>
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-util.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CACHE_BUCKETS 1024
+#define KEY_LENGTH 1024
+
+// the value of an entry is "randomness;hits;chain"
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static scilI_dict_t * cache = NULL;
+
+void scilC_decision_cache_initialize(){
+  cache = scilI_dict_create(CACHE_BUCKETS);
+  scilU_persist_with_env("SCIL_DECISION_CACHE_FILE", "decision cache", scilC_decision_cache_load, scilC_decision_cache_save);
+}
+
+// the hints that influence the decision, doubles are printed exactly
+static int make_key(char * key, const scil_context_t* ctx, const scil_dims_t* dims){
+  if(ctx->variable_id == NULL){
+    return 0;
+  }
+  const scil_user_hints_t * h = & ctx->hints;
+  int pos = snprintf(key, KEY_LENGTH, "%s|%d|", ctx->variable_id, (int) ctx->datatype);
+  for(int d=0; d < dims->dims && pos < KEY_LENGTH; d++){
+    pos += snprintf(key + pos, KEY_LENGTH - pos, d == 0 ? "%zu" : "x%zu", dims->length[d]);
+  }
+  if(pos < KEY_LENGTH){
+    pos += snprintf(key + pos, KEY_LENGTH - pos, "|%a|%a|%a|%d|%d|%d*%a|%d*%a", h->absolute_tolerance, h->relative_tolerance_percent,
+                    h->relative_err_finest_abs_tolerance, h->significant_bits, ctx->lossless_compression_needed,
+                    (int) h->comp_speed.unit, (double) h->comp_speed.multiplier, (int) h->decomp_speed.unit, (double) h->decomp_speed.multiplier);
+  }
+  // the key ends the line of the file
+  return pos < KEY_LENGTH && strchr(key, '\n') == NULL;
+}
+
+// must be called with the lock held
+static void put(const char * key, const scilC_decision_t* decision, unsigned hits){
+  char value[SCIL_DECISION_CACHE_CHAIN_LENGTH + 64];
+  snprintf(value, sizeof(value), "%.3f;%u;%s", (double) decision->randomness, hits, decision->chain);
+  scilI_dict_put(cache, key, value);
+}
+
+static int parse_value(const char * value, scilC_decision_t* out, unsigned * hits){
+  return sscanf(value, "%f;%u;%99[^;\n]", & out->randomness, hits, out->chain) == 3;
+}
+
+int scilC_decision_cache_lookup(const scil_context_t* ctx, const scil_dims_t* dims, scilC_decision_t* out, int* out_revalidate){
+  char key[KEY_LENGTH];
+  if(! make_key(key, ctx, dims)){
+    return 0;
+  }
+  unsigned hits = 0;
+  int found = 0;
+  pthread_mutex_lock(& lock);
+  scilI_dict_element_t * e = scilI_dict_get(cache, key);
+  if(e != NULL && parse_value(e->value, out, & hits)){
+    found = 1;
+    hits++;
+    put(key, out, hits);
+  }
+  pthread_mutex_unlock(& lock);
+  *out_revalidate = found && hits >= SCIL_DECISION_CACHE_REVALIDATE;
+  return found;
+}
+
+void scilC_decision_cache_store(const scil_context_t* ctx, const scil_dims_t* dims, const scilC_decision_t* decision){
+  char key[KEY_LENGTH];
+  if(! make_key(key, ctx, dims)){
+    return;
+  }
+  pthread_mutex_lock(& lock);
+  put(key, decision, 0);
+  pthread_mutex_unlock(& lock);
+}
+
+int scilC_decision_cache_load(const char* filename){
+  FILE * f = fopen(filename, "r");
+  if(f == NULL){
+    return SCIL_EINVAL;
+  }
+  char line[KEY_LENGTH + SCIL_DECISION_CACHE_CHAIN_LENGTH + 64];
+  pthread_mutex_lock(& lock);
+  while(fgets(line, sizeof(line), f) != NULL){
+    if(line[0] == '#'){
+      continue;
+    }
+    scilC_decision_t decision;
+    unsigned hits;
+    int key_pos = 0;
+    if(sscanf(line, "%f; %u; %99[^;]; %n", & decision.randomness, & hits, decision.chain, & key_pos) != 3 || key_pos == 0){
+      warn("Invalid line in the decision cache \"%s\"\n", line);
+      continue;
+    }
+    char * key = & line[key_pos];
+    key[strcspn(key, "\n")] = 0;
+    put(key, & decision, hits);
+  }
+  pthread_mutex_unlock(& lock);
+  fclose(f);
+  return SCIL_NO_ERR;
+}
+
+int scilC_decision_cache_save(const char* filename){
+  FILE * f = fopen(filename, "w");
+  if(f == NULL){
+    return SCIL_EINVAL;
+  }
+  fprintf(f, "# randomness; hits since the last check; chain; variable|datatype|dims|hints\n");
+  pthread_mutex_lock(& lock);
+  for(unsigned i=0; i < cache->size; i++){
+    for(scilI_dict_element_t * e = cache->elem[i]; e != NULL; e = e->next){
+      scilC_decision_t decision;
+      unsigned hits;
+      if(parse_value(e->value, & decision, & hits)){
+        fprintf(f, "%.3f; %u; %s; %s\n", (double) decision.randomness, hits, decision.chain, e->key);
+      }
+    }
+  }
+  pthread_mutex_unlock(& lock);
+  return fclose(f) == 0 ? SCIL_NO_ERR : SCIL_EINVAL;
+}
+
+void scilC_decision_cache_reset(){
+  pthread_mutex_lock(& lock);
+  scilI_dict_destroy(cache);
+  cache = scilI_dict_create(CACHE_BUCKETS);
+  pthread_mutex_unlock(& lock);
+}
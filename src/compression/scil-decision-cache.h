@@ -0,0 +1,65 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_DECISION_CACHE_H
+#define SCIL_DECISION_CACHE_H
+
+#include <scil-context.h>
+#include <scil-dims.h>
+
+/*
+ The decision cache remembers the chain the chooser picked for a variable, it is shared by all contexts.
+ A variable is identified by the ID set with scilPr_set_variable_id(), the datatype, the dimensions and the hints.
+ If the environment variable SCIL_DECISION_CACHE_FILE is set, the cache is read from the file when the
+ library is initialized and written back when the process exits.
+ */
+
+// after this many hits of a decision the randomness of the data is sampled again
+#define SCIL_DECISION_CACHE_REVALIDATE 16
+
+// the decision is kept if the randomness differs by at most this many percentage points
+#define SCIL_DECISION_CACHE_TOLERANCE 5.0f
+
+#define SCIL_DECISION_CACHE_CHAIN_LENGTH 100
+
+typedef struct{
+  char chain[SCIL_DECISION_CACHE_CHAIN_LENGTH];
+  // the randomness measured when the decision was made
+  float randomness;
+} scilC_decision_t;
+
+void scilC_decision_cache_initialize();
+
+/**
+ * \brief Returns 1 and the decision for the variable of the context if it is cached, otherwise 0.
+ * \param out_revalidate set to 1 if the decision is due to be checked against the current data
+ */
+int scilC_decision_cache_lookup(const scil_context_t* ctx, const scil_dims_t* dims, scilC_decision_t* out, int* out_revalidate);
+
+/**
+ * \brief Stores the decision for the variable of the context, a context without variable ID is ignored.
+ */
+void scilC_decision_cache_store(const scil_context_t* ctx, const scil_dims_t* dims, const scilC_decision_t* decision);
+
+int scilC_decision_cache_load(const char* filename);
+
+int scilC_decision_cache_save(const char* filename);
+
+/**
+ * \brief Forgets all decisions.
+ */
+void scilC_decision_cache_reset();
+
+#endif // SCIL_DECISION_CACHE_H
@@ -0,0 +1,140 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <scil-stats.h>
+
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-util.h>
+
+#include <pthread.h>
+#include <string.h>
+
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_key;
+
+void scilC_stats_begin(scil_stats_t* last)
+{
+  memset(last, 0, sizeof(scil_stats_t));
+}
+
+void scilC_stats_add_stage(scil_stats_t* s, int stage, const char* name, double seconds, size_t bytes_in, size_t bytes_out)
+{
+  assert(stage < SCIL_STATS_STAGES_MAX);
+  scil_stage_stats_t* e = &s->stages[stage];
+  if (stage >= s->stage_count) {
+    memset(e, 0, sizeof(scil_stage_stats_t));
+    e->name        = name;
+    s->stage_count = stage + 1;
+  }
+  e->seconds   += seconds;
+  e->bytes_in  += bytes_in;
+  e->bytes_out += bytes_out;
+}
+
+void scilC_stats_merge(scil_stats_t* dst, const scil_stats_t* src)
+{
+  for (int i = 0; i < src->stage_count; i++) {
+    const scil_stage_stats_t* e = &src->stages[i];
+    scilC_stats_add_stage(dst, i, e->name, e->seconds, e->bytes_in, e->bytes_out);
+  }
+  dst->scratch_bytes += src->scratch_bytes;
+}
+
+// the chain may change between calls, thus the total is aggregated by the name of the algorithm
+static scil_stage_stats_t* total_stage(scil_stats_t* total, const char* name)
+{
+  for (int i = 0; i < total->stage_count; i++) {
+    if (strcmp(total->stages[i].name, name) == 0) {
+      return &total->stages[i];
+    }
+  }
+  if (total->stage_count == SCIL_STATS_STAGES_MAX) {
+    return NULL;
+  }
+  scil_stage_stats_t* e = &total->stages[total->stage_count++];
+  memset(e, 0, sizeof(scil_stage_stats_t));
+  e->name = name;
+  return e;
+}
+
+void scilC_stats_end(scil_stats_t* last, scil_stats_t* total, size_t bytes_in, size_t bytes_out, double seconds)
+{
+  last->calls     = 1;
+  last->seconds   = seconds;
+  last->bytes_in  = bytes_in;
+  last->bytes_out = bytes_out;
+
+  total->calls++;
+  total->seconds   += seconds;
+  total->bytes_in  += bytes_in;
+  total->bytes_out += bytes_out;
+  total->scratch_bytes = max(total->scratch_bytes, last->scratch_bytes);
+  for (int i = 0; i < last->stage_count; i++) {
+    const scil_stage_stats_t* e = &last->stages[i];
+    scil_stage_stats_t* t       = total_stage(total, e->name);
+    if (t != NULL) {
+      t->seconds   += e->seconds;
+      t->bytes_in  += e->bytes_in;
+      t->bytes_out += e->bytes_out;
+    }
+  }
+}
+
+static int copy_stats(const struct scil_context_stats* s, scil_stats_t* out_last, scil_stats_t* out_total)
+{
+  if (s == NULL) {
+    return SCIL_EINVAL;
+  }
+  if (out_last != NULL) {
+    *out_last = s->last;
+  }
+  if (out_total != NULL) {
+    *out_total = s->total;
+  }
+  return SCIL_NO_ERR;
+}
+
+int scil_get_last_stats(const scil_context_t* ctx, scil_stats_t* out_last, scil_stats_t* out_total)
+{
+  return copy_stats(ctx->call_stats, out_last, out_total);
+}
+
+static void create_thread_key()
+{
+  pthread_key_create(&thread_key, free);
+}
+
+struct scil_context_stats* scilC_decompression_stats()
+{
+  pthread_once(&thread_key_once, create_thread_key);
+  return (struct scil_context_stats*) pthread_getspecific(thread_key);
+}
+
+void scil_set_decompression_stats(int enabled)
+{
+  free(scilC_decompression_stats());
+  struct scil_context_stats* s = NULL;
+  if (enabled) {
+    s = (struct scil_context_stats*) SAFE_CALLOC(1, sizeof(struct scil_context_stats));
+  }
+  pthread_setspecific(thread_key, s);
+}
+
+int scil_get_last_decompression_stats(scil_stats_t* out_last, scil_stats_t* out_total)
+{
+  return copy_stats(scilC_decompression_stats(), out_last, out_total);
+}
@@ -0,0 +1,57 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SCIL_STATS_H
+#define SCIL_STATS_H
+
+#include <scil.h>
+
+/*
+ The statistics of scil_compress() and scil_decompress() are only recorded if they are enabled,
+ the chain checks a single pointer per stage otherwise.
+ */
+struct scil_context_stats {
+  scil_stats_t last;
+  scil_stats_t total;
+};
+
+/**
+ * \brief Clears the statistics of the last call.
+ */
+void scilC_stats_begin(scil_stats_t* last);
+
+/**
+ * \brief Adds an execution of the algorithm at position stage of the chain, e.g., for one block of the data.
+ */
+void scilC_stats_add_stage(scil_stats_t* s, int stage, const char* name, double seconds, size_t bytes_in, size_t bytes_out);
+
+/**
+ * \brief Adds the stages and the scratch memory of src, which must have used the same chain, to dst.
+ * The scratch memory is summed up as the workers of tiled compression hold it at the same time.
+ */
+void scilC_stats_merge(scil_stats_t* dst, const scil_stats_t* src);
+
+/**
+ * \brief Completes the statistics of the last call and adds them to the total.
+ */
+void scilC_stats_end(scil_stats_t* last, scil_stats_t* total, size_t bytes_in, size_t bytes_out, double seconds);
+
+/**
+ * \brief Returns the decompression statistics of the calling thread, NULL unless enabled with scil_set_decompression_stats().
+ */
+struct scil_context_stats* scilC_decompression_stats();
+
+#endif // SCIL_STATS_H
@@ -0,0 +1,482 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-stream.h>
+
+#include <scil.h>
+#include <scil-chain-execution.h>
+#include <scil-error.h>
+#include <scil-internal.h>
+#include <scil-util.h>
+
+#include <pthread.h>
+#include <string.h>
+
+struct scil_compress_stream {
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t plane_size;
+  size_t window_planes;
+  size_t planes_appended;
+
+  // planes that did not fill a complete window yet
+  byte* staging;
+  size_t staged_planes;
+
+  byte* buffer;
+  size_t buffer_size;
+
+  scil_stream_write_func_t write;
+  void* user_ptr;
+  size_t out_size;
+  // once an error occurred, the stream cannot continue
+  int ret;
+};
+
+static int stream_write(scil_compress_stream_t* stream, const byte* data, size_t size)
+{
+  if (stream->write(stream->user_ptr, data, size) != 0) {
+    return SCIL_IO_ERR;
+  }
+  stream->out_size += size;
+  return SCIL_NO_ERR;
+}
+
+static int emit_frame(scil_compress_stream_t* stream, const byte* data, size_t planes)
+{
+  scil_dims_t dims = stream->dims;
+  dims.length[dims.dims - 1] = planes;
+
+  size_t size;
+  int ret = scil_compress(stream->buffer, stream->buffer_size, (void*) data, &dims, &size, stream->ctx);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+
+  byte header[SCIL_STREAM_FRAME_HEADER_SIZE];
+  byte* pos = header;
+  uint64_t val = size;
+  scilU_pack8(pos, val);
+  pos += 8;
+  val = planes;
+  scilU_pack8(pos, val);
+
+  ret = stream_write(stream, header, SCIL_STREAM_FRAME_HEADER_SIZE);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+  return stream_write(stream, stream->buffer, size);
+}
+
+int scil_compress_stream_begin(scil_compress_stream_t** out_stream,
+                               scil_context_t* ctx,
+                               const scil_dims_t* dims,
+                               size_t window_size,
+                               scil_stream_write_func_t write,
+                               void* user_ptr)
+{
+  assert(ctx != NULL);
+  assert(write != NULL);
+  *out_stream = NULL;
+
+  if (dims->dims == 0 || dims->dims > SCIL_DIMS_MAX) {
+    return SCIL_EINVAL;
+  }
+  if (window_size == 0) {
+    window_size = SCIL_STREAM_DEFAULT_WINDOW;
+  }
+
+  scil_compress_stream_t* stream = (scil_compress_stream_t*) SAFE_CALLOC(1, sizeof(scil_compress_stream_t));
+  stream->ctx      = ctx;
+  stream->write    = write;
+  stream->user_ptr = user_ptr;
+  scilPr_copy_dims(&stream->dims, dims);
+
+  // a frame contains at least one plane
+  scil_dims_t plane = stream->dims;
+  plane.length[plane.dims - 1] = 1;
+  stream->plane_size    = scilPr_get_dims_size(&plane, ctx->datatype);
+  stream->window_planes = stream->plane_size == 0 ? 1 : window_size / stream->plane_size;
+  if (stream->window_planes == 0) {
+    stream->window_planes = 1;
+  }
+
+  plane.length[plane.dims - 1] = stream->window_planes;
+  stream->buffer_size = scil_compress_bound(ctx, &plane);
+  stream->buffer      = (byte*) SAFE_MALLOC(stream->buffer_size);
+  stream->staging     = (byte*) SAFE_MALLOC(stream->window_planes * stream->plane_size);
+
+  byte header[1 + 1 + 8 * SCIL_DIMS_MAX];
+  header[0] = SCIL_STREAM_CONTAINER;
+  size_t header_size = 1 + scilU_write_dims_to_buffer(header + 1, &stream->dims);
+  stream->ret = stream_write(stream, header, header_size);
+
+  *out_stream = stream;
+  return stream->ret;
+}
+
+int scil_compress_stream_append(scil_compress_stream_t* stream, const void* slab, size_t planes)
+{
+  if (stream->ret != SCIL_NO_ERR) {
+    return stream->ret;
+  }
+  if (stream->planes_appended + planes > stream->dims.length[stream->dims.dims - 1]) {
+    return SCIL_EINVAL;
+  }
+  stream->planes_appended += planes;
+
+  const byte* pos = (const byte*) slab;
+  int ret         = SCIL_NO_ERR;
+  while (planes > 0 && ret == SCIL_NO_ERR) {
+    if (stream->staged_planes == 0 && planes >= stream->window_planes) {
+      // compress complete windows directly from the slab
+      ret = emit_frame(stream, pos, stream->window_planes);
+      pos    += stream->window_planes * stream->plane_size;
+      planes -= stream->window_planes;
+      continue;
+    }
+    size_t count = stream->window_planes - stream->staged_planes;
+    if (count > planes) {
+      count = planes;
+    }
+    memcpy(stream->staging + stream->staged_planes * stream->plane_size, pos, count * stream->plane_size);
+    stream->staged_planes += count;
+    pos    += count * stream->plane_size;
+    planes -= count;
+
+    if (stream->staged_planes == stream->window_planes) {
+      ret = emit_frame(stream, stream->staging, stream->staged_planes);
+      stream->staged_planes = 0;
+    }
+  }
+  stream->ret = ret;
+  return ret;
+}
+
+int scil_compress_stream_finish(scil_compress_stream_t* stream, size_t* out_size)
+{
+  int ret = stream->ret;
+  if (ret == SCIL_NO_ERR && stream->staged_planes > 0) {
+    ret = emit_frame(stream, stream->staging, stream->staged_planes);
+  }
+  if (ret == SCIL_NO_ERR) {
+    byte terminator[8] = {0};
+    ret = stream_write(stream, terminator, 8);
+  }
+  if (ret == SCIL_NO_ERR && stream->planes_appended != stream->dims.length[stream->dims.dims - 1]) {
+    // the data is incomplete
+    ret = SCIL_EINVAL;
+  }
+  if (out_size != NULL) {
+    *out_size = stream->out_size;
+  }
+
+  free(stream->staging);
+  free(stream->buffer);
+  free(stream);
+  return ret;
+}
+
+size_t scilC_decompress_stream_scratch_size(SCIL_Datatype_t datatype,
+                                            const scil_dims_t* dims,
+                                            const byte* source,
+                                            const size_t source_size)
+{
+  assert(source[0] == SCIL_STREAM_CONTAINER);
+
+  if (source_size < 2 + 8 * (size_t) dims->dims) {
+    return 0;
+  }
+  scil_dims_t plane = *dims;
+  const byte* pos = source + 2 + 8 * dims->dims;
+  const byte* end = source + source_size;
+  size_t scratch = 0;
+  while (end - pos >= SCIL_STREAM_FRAME_HEADER_SIZE) {
+    uint64_t size, planes;
+    scilU_unpack8(pos, &size);
+    scilU_unpack8(pos + 8, &planes);
+    pos += SCIL_STREAM_FRAME_HEADER_SIZE;
+    if (size == 0 || (uint64_t)(end - pos) < size) {
+      break;
+    }
+    plane.length[plane.dims - 1] = planes;
+    const size_t frame_scratch = scil_decompress_scratch_size(datatype, &plane, pos, size);
+    scratch = max(scratch, frame_scratch);
+    pos += size;
+  }
+  return scratch;
+}
+
+int scilC_decompress_stream_buffer(SCIL_Datatype_t datatype,
+                                   void* restrict dest,
+                                   scil_dims_t* dims,
+                                   byte* restrict source,
+                                   const size_t source_size,
+                                   byte* restrict buff_tmp)
+{
+  assert(source[0] == SCIL_STREAM_CONTAINER);
+
+  if (source_size < 2 || source[1] != dims->dims || source_size < 2 + 8 * (size_t) dims->dims) {
+    return SCIL_BUFFER_ERR;
+  }
+  scil_dims_t stream_dims;
+  scilU_read_dims_from_buffer(&stream_dims, source + 1);
+  for (int d = 0; d < dims->dims; d++) {
+    if (stream_dims.length[d] != dims->length[d]) {
+      return SCIL_BUFFER_ERR;
+    }
+  }
+
+  scil_dims_t plane = *dims;
+  plane.length[plane.dims - 1] = 1;
+  const size_t plane_size  = scilPr_get_dims_size(&plane, datatype);
+  const size_t plane_count = dims->length[dims->dims - 1];
+
+  byte* pos       = source + 2 + 8 * dims->dims;
+  const byte* end = source + source_size;
+  size_t planes_done = 0;
+  while (1) {
+    uint64_t size, planes;
+    if (end - pos < 8) {
+      return SCIL_BUFFER_ERR;
+    }
+    scilU_unpack8(pos, &size);
+    pos += 8;
+    if (size == 0) {
+      break;
+    }
+    if (end - pos < 8) {
+      return SCIL_BUFFER_ERR;
+    }
+    scilU_unpack8(pos, &planes);
+    pos += 8;
+    if ((uint64_t)(end - pos) < size || planes_done + planes > plane_count) {
+      return SCIL_BUFFER_ERR;
+    }
+
+    plane.length[plane.dims - 1] = planes;
+    int ret = scilC_decompress(datatype, (byte*) dest + planes_done * plane_size, &plane, pos, size, buff_tmp, NULL);
+    if (ret != SCIL_NO_ERR) {
+      return ret;
+    }
+    pos         += size;
+    planes_done += planes;
+  }
+  return planes_done == plane_count ? SCIL_NO_ERR : SCIL_BUFFER_ERR;
+}
+
+// a frame read ahead while the previous one is decompressed
+typedef struct {
+  byte* data;
+  size_t capacity;
+  uint64_t size;
+  uint64_t planes;
+  int ret;
+  int last;
+  int filled;
+} frame_slot_t;
+
+typedef struct {
+  scil_stream_read_func_t read;
+  void* user_ptr;
+
+  frame_slot_t slots[2];
+  int stop;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+} frame_reader_t;
+
+static int read_frame(frame_reader_t* reader, frame_slot_t* slot)
+{
+  byte header[SCIL_STREAM_FRAME_HEADER_SIZE];
+  byte* pos = header;
+
+  if (reader->read(reader->user_ptr, header, 8) != 0) {
+    return SCIL_IO_ERR;
+  }
+  scilU_unpack8(pos, &slot->size);
+  if (slot->size == 0) {
+    slot->last = 1;
+    return SCIL_NO_ERR;
+  }
+  pos += 8;
+  if (reader->read(reader->user_ptr, pos, 8) != 0) {
+    return SCIL_IO_ERR;
+  }
+  scilU_unpack8(pos, &slot->planes);
+
+  if (slot->capacity < slot->size) {
+    free(slot->data);
+    slot->data     = (byte*) malloc(slot->size);
+    slot->capacity = slot->data == NULL ? 0 : slot->size;
+    if (slot->data == NULL) {
+      return SCIL_MEMORY_ERR;
+    }
+  }
+  if (reader->read(reader->user_ptr, slot->data, slot->size) != 0) {
+    return SCIL_IO_ERR;
+  }
+  return SCIL_NO_ERR;
+}
+
+static void* reader_main(void* arg)
+{
+  frame_reader_t* reader = (frame_reader_t*) arg;
+
+  for (int i = 0;; i = 1 - i) {
+    frame_slot_t* slot = &reader->slots[i];
+
+    pthread_mutex_lock(&reader->lock);
+    while (slot->filled && ! reader->stop) {
+      pthread_cond_wait(&reader->cond, &reader->lock);
+    }
+    int stop = reader->stop;
+    pthread_mutex_unlock(&reader->lock);
+    if (stop) {
+      break;
+    }
+
+    slot->ret  = read_frame(reader, slot);
+    slot->last = slot->last || slot->ret != SCIL_NO_ERR;
+
+    pthread_mutex_lock(&reader->lock);
+    slot->filled = 1;
+    pthread_cond_broadcast(&reader->cond);
+    pthread_mutex_unlock(&reader->lock);
+
+    if (slot->last) {
+      break;
+    }
+  }
+  return NULL;
+}
+
+int scil_decompress_stream(SCIL_Datatype_t datatype,
+                           scil_dims_t* dims,
+                           scil_stream_read_func_t read,
+                           void* read_ptr,
+                           scil_stream_sink_func_t sink,
+                           void* sink_ptr)
+{
+  byte header[1 + 1 + 8 * SCIL_DIMS_MAX];
+  scil_dims_t stream_dims;
+
+  if (read(read_ptr, header, 2) != 0) {
+    return SCIL_IO_ERR;
+  }
+  if (header[0] != SCIL_STREAM_CONTAINER || header[1] == 0 || header[1] > SCIL_DIMS_MAX) {
+    return SCIL_BUFFER_ERR;
+  }
+  if (read(read_ptr, header + 2, 8 * header[1]) != 0) {
+    return SCIL_IO_ERR;
+  }
+  scilU_read_dims_from_buffer(&stream_dims, header + 1);
+  if (dims->dims == 0) {
+    *dims = stream_dims;
+  } else if (dims->dims != stream_dims.dims || memcmp(dims->length, stream_dims.length, dims->dims * sizeof(size_t)) != 0) {
+    return SCIL_BUFFER_ERR;
+  }
+
+  scil_dims_t plane = stream_dims;
+  plane.length[plane.dims - 1] = 1;
+  const size_t plane_size  = scilPr_get_dims_size(&plane, datatype);
+  const size_t plane_count = stream_dims.length[stream_dims.dims - 1];
+
+  frame_reader_t reader;
+  memset(&reader, 0, sizeof(reader));
+  reader.read     = read;
+  reader.user_ptr = read_ptr;
+  pthread_mutex_init(&reader.lock, NULL);
+  pthread_cond_init(&reader.cond, NULL);
+
+  // the next frame is read while the current one is decompressed
+  pthread_t thread;
+  int threaded = pthread_create(&thread, NULL, reader_main, &reader) == 0;
+
+  byte* slab         = NULL;
+  size_t slab_planes = 0;
+  size_t planes_done = 0;
+  int ret            = SCIL_NO_ERR;
+
+  for (int i = 0;; i = 1 - i) {
+    frame_slot_t* slot = &reader.slots[i];
+
+    if (threaded) {
+      pthread_mutex_lock(&reader.lock);
+      while (! slot->filled) {
+        pthread_cond_wait(&reader.cond, &reader.lock);
+      }
+      pthread_mutex_unlock(&reader.lock);
+    } else {
+      slot->ret  = read_frame(&reader, slot);
+      slot->last = slot->last || slot->ret != SCIL_NO_ERR;
+    }
+
+    ret = slot->ret;
+    if (ret != SCIL_NO_ERR || slot->last) {
+      break;
+    }
+    if (planes_done + slot->planes > plane_count) {
+      ret = SCIL_BUFFER_ERR;
+      break;
+    }
+
+    plane.length[plane.dims - 1] = slot->planes;
+    if (slab_planes < slot->planes) {
+      free(slab);
+      slab_planes = slot->planes;
+      slab = (byte*) malloc(slab_planes * plane_size);
+      if (slab == NULL) {
+        ret = SCIL_MEMORY_ERR;
+        break;
+      }
+    }
+
+    // multi-stage frames take their scratch from the workspace of the thread
+    ret = scilC_decompress(datatype, slab, &plane, slot->data, slot->size, NULL, NULL);
+    if (ret != SCIL_NO_ERR) {
+      break;
+    }
+    if (sink(sink_ptr, slab, planes_done, slot->planes) != 0) {
+      ret = SCIL_IO_ERR;
+      break;
+    }
+    planes_done += slot->planes;
+
+    pthread_mutex_lock(&reader.lock);
+    slot->filled = 0;
+    pthread_cond_broadcast(&reader.cond);
+    pthread_mutex_unlock(&reader.lock);
+  }
+
+  if (threaded) {
+    pthread_mutex_lock(&reader.lock);
+    reader.stop = 1;
+    pthread_cond_broadcast(&reader.cond);
+    pthread_mutex_unlock(&reader.lock);
+    pthread_join(thread, NULL);
+  }
+  pthread_mutex_destroy(&reader.lock);
+  pthread_cond_destroy(&reader.cond);
+
+  free(reader.slots[0].data);
+  free(reader.slots[1].data);
+  free(slab);
+
+  if (ret == SCIL_NO_ERR && planes_done != plane_count) {
+    ret = SCIL_BUFFER_ERR;
+  }
+  return ret;
+}
@@ -0,0 +1,59 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_STREAM_H
+#define SCIL_STREAM_H
+
+#include <scil-dims.h>
+
+/*
+ A stream container starts with this byte instead of the chain length.
+ In contrast to the chain format, it can be parsed from front to back:
+ - byte SCIL_STREAM_CONTAINER
+ - the dimensions of the complete data as written by scilU_write_dims_to_buffer()
+ - a sequence of frames, each one consisting of
+   - uint64 COMPRESSED_SIZE
+   - uint64 PLANE_COUNT // the number of elements along the slowest dimension
+   - the slab compressed with scil_compress()
+ - uint64 0 // terminates the sequence of frames
+ */
+#define SCIL_STREAM_CONTAINER 254
+
+#define SCIL_STREAM_FRAME_HEADER_SIZE 16
+
+/*
+ Without an explicit window, frames cover up to this many bytes of uncompressed data.
+ */
+#define SCIL_STREAM_DEFAULT_WINDOW (64 * 1024 * 1024)
+
+/**
+ * \brief Returns the largest scratch memory one of the frames of the stream container needs.
+ */
+size_t scilC_decompress_stream_scratch_size(SCIL_Datatype_t datatype,
+                                            const scil_dims_t* dims,
+                                            const byte* source,
+                                            const size_t source_size);
+
+/**
+ * \brief Decompresses a stream container that is completely in memory.
+ */
+int scilC_decompress_stream_buffer(SCIL_Datatype_t datatype,
+                                   void* restrict dest,
+                                   scil_dims_t* dims,
+                                   byte* restrict source,
+                                   const size_t source_size,
+                                   byte* restrict buff_tmp);
+
+#endif // SCIL_STREAM_H
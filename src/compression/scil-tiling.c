@@ -0,0 +1,594 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-tiling.h>
+
+#include <scil-chain.h>
+#include <scil-chain-execution.h>
+#include <scil-data-stats.h>
+#include <scil-error.h>
+#include <scil-hyperslab.h>
+#include <scil-internal.h>
+#include <scil-parallel.h>
+#include <scil-stats.h>
+#include <scil-trace.h>
+#include <scil-util.h>
+
+#include <string.h>
+#include <sys/types.h>
+
+void scilC_tiling_initialize(scilC_tiling_t* tiling, const scil_dims_t* dims, const scil_dims_t* tile_dims)
+{
+  tiling->tile.dims  = dims->dims;
+  tiling->tile_count = 1;
+  for (int d = 0; d < dims->dims; d++) {
+    size_t len = dims->length[d];
+    if (d < tile_dims->dims && tile_dims->length[d] > 0 && tile_dims->length[d] < len) {
+      len = tile_dims->length[d];
+    }
+    tiling->tile.length[d] = len;
+    tiling->grid[d]        = len == 0 ? 0 : (dims->length[d] + len - 1) / len;
+    tiling->tile_count    *= tiling->grid[d];
+  }
+}
+
+void scilC_tiling_get_tile(const scilC_tiling_t* tiling, const scil_dims_t* dims, size_t tile, scil_dims_t* out_origin, scil_dims_t* out_extent)
+{
+  out_origin->dims = dims->dims;
+  out_extent->dims = dims->dims;
+  for (int d = 0; d < dims->dims; d++) {
+    const size_t pos = tile % tiling->grid[d];
+    tile /= tiling->grid[d];
+
+    out_origin->length[d] = pos * tiling->tile.length[d];
+    out_extent->length[d] = dims->length[d] - out_origin->length[d];
+    if (out_extent->length[d] > tiling->tile.length[d]) {
+      out_extent->length[d] = tiling->tile.length[d];
+    }
+  }
+}
+
+size_t scilC_get_tile_count(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+  if (ctx->tile_dims.dims == 0) {
+    return 1;
+  }
+  scilC_tiling_t tiling;
+  scilC_tiling_initialize(&tiling, dims, &ctx->tile_dims);
+  return tiling.tile_count;
+}
+
+// returns the byte offset of the tile in the domain if it is stored contiguously, otherwise -1.
+// That is the case if the tile covers the lower dimensions completely up to one dimension and is flat above it.
+static ssize_t contiguous_offset(const scil_dims_t* dims, const scil_dims_t* origin, const scil_dims_t* extent, size_t elem_size)
+{
+  int partial = 0;
+  while (partial < dims->dims - 1 && extent->length[partial] == dims->length[partial]) {
+    partial++;
+  }
+  for (int d = partial + 1; d < dims->dims; d++) {
+    if (extent->length[d] != 1) {
+      return -1;
+    }
+  }
+  size_t stride = elem_size;
+  size_t offset = 0;
+  for (int d = 0; d < dims->dims; d++) {
+    offset += origin->length[d] * stride;
+    stride *= dims->length[d];
+  }
+  return (ssize_t) offset;
+}
+
+typedef struct {
+  scil_context_t* ctx;
+  byte* tile_buffer;
+  // the decompression statistics of the worker
+  scil_stats_t* stats;
+} tile_worker_t;
+
+typedef struct {
+  byte* data;
+  size_t size;
+} tile_result_t;
+
+typedef struct {
+  const scilC_tiling_t* tiling;
+  const scil_dims_t* dims;
+  SCIL_Datatype_t datatype;
+  size_t elem_size;
+  size_t tile_size;
+
+  // compression
+  scil_context_t* ctx;
+  byte* source;
+  tile_result_t* results;
+
+  // decompression
+  byte* dest;
+  const byte* tiles;
+  const byte* offsets;
+  size_t tiles_size;
+  // the hyperslab to decompress and the tiles overlapping it, NULL for all tiles
+  const scil_dims_t* region_offset;
+  const scil_dims_t* region_count;
+  const size_t* tile_list;
+  // the decompression statistics of the caller, NULL if disabled
+  scil_stats_t* stats;
+
+  tile_worker_t* workers;
+} tile_job_t;
+
+static void destroy_workers(tile_worker_t* workers, int count)
+{
+  for (int i = 0; i < count; i++) {
+    if (workers[i].ctx != NULL) {
+      scilPr_destroy_context(workers[i].ctx);
+    }
+    free(workers[i].tile_buffer);
+    free(workers[i].stats);
+  }
+  free(workers);
+}
+
+static int compress_tile(void* user, size_t tile, int worker)
+{
+  tile_job_t* job   = (tile_job_t*) user;
+  tile_worker_t* w  = &job->workers[worker];
+  scil_dims_t origin, extent;
+  scil_dims_t zero = {0};
+
+  // the tiles on the timeline of the workers show stragglers and idle threads
+  scil_timer timer;
+  const int trace = scilU_trace_enabled();
+  if (trace) {
+    scilU_start_timer(&timer);
+  }
+
+  if (w->ctx == NULL) {
+    // each worker needs its own pipeline parameters
+    scilPr_clone_context(&w->ctx, job->ctx);
+  }
+  scilC_tiling_get_tile(job->tiling, job->dims, tile, &origin, &extent);
+
+  byte* in;
+  ssize_t offset = contiguous_offset(job->dims, &origin, &extent, job->elem_size);
+  if (offset >= 0) {
+    in = job->source + offset;
+  } else {
+    if (w->tile_buffer == NULL) {
+      w->tile_buffer = (byte*) SAFE_MALLOC(job->tile_size);
+    }
+    zero.dims = extent.dims;
+    scilI_copy_hyperslab(w->tile_buffer, &extent, &zero, job->source, job->dims, &origin, &extent, job->elem_size);
+    in = w->tile_buffer;
+  }
+  // the tile buffer is reused, statistics of the previous tile must not be taken for this one
+  scilI_context_data_stats_invalidate(w->ctx);
+
+  // the buffer is shrunk to the actual size after compression
+  const size_t out_limit = scilC_compress_chain_bound(w->ctx, &extent);
+  tile_result_t* result  = &job->results[tile];
+  result->data = (byte*) SAFE_MALLOC(out_limit);
+  int ret = scilC_compress_chain(result->data, out_limit, in, &extent, &result->size, w->ctx);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+  result->data = (byte*) SAFE_REALLOC(result->data, result->size);
+  if (trace) {
+    scilU_trace_span("tile", "compress", timer, scilPr_get_dims_size(&extent, job->datatype), result->size);
+  }
+  return SCIL_NO_ERR;
+}
+
+static size_t container_header_size(const scil_dims_t* dims, uint64_t tile_count)
+{
+  return 1 + 1 + 8 * dims->dims + 8 + 8 * (tile_count + 1);
+}
+
+static size_t container_bound(const scil_context_t* ctx, const scil_dims_t* dims, const scilC_tiling_t* tiling)
+{
+  size_t bound = container_header_size(dims, tiling->tile_count);
+  for (size_t i = 0; i < tiling->tile_count; i++) {
+    scil_dims_t origin, extent;
+    scilC_tiling_get_tile(tiling, dims, i, &origin, &extent);
+    bound += scilC_compress_chain_bound(ctx, &extent);
+  }
+  return bound;
+}
+
+// writes the container header up to the offset table and returns the position of the table
+static byte* write_container_header(byte* dest, const scilC_tiling_t* tiling)
+{
+  byte* pos = dest;
+  *pos = SCIL_TILED_CONTAINER;
+  pos++;
+  pos += scilU_write_dims_to_buffer(pos, &tiling->tile);
+  scilU_pack8(pos, tiling->tile_count);
+  pos += 8;
+  return pos;
+}
+
+size_t scilC_compress_tiled_bound(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+  scilC_tiling_t tiling;
+  scilC_tiling_initialize(&tiling, dims, &ctx->tile_dims);
+  return container_bound(ctx, dims, &tiling);
+}
+
+int scilC_compress_tiled(byte* restrict dest,
+                         size_t dest_size,
+                         void* restrict source,
+                         const scil_dims_t* dims,
+                         size_t* restrict out_size,
+                         scil_context_t* ctx)
+{
+  scilC_tiling_t tiling;
+  scilC_tiling_initialize(&tiling, dims, &ctx->tile_dims);
+  const uint64_t tile_count = tiling.tile_count;
+
+  size_t header_size = container_header_size(dims, tile_count);
+  if (header_size > dest_size) {
+    return SCIL_MEMORY_ERR;
+  }
+
+  int threads = ctx->tile_threads > 0 ? ctx->tile_threads : scilI_parallel_default_thread_count();
+  if ((size_t) threads > tile_count) {
+    threads = (int) tile_count;
+  }
+
+  tile_job_t job = {
+    .tiling = &tiling, .dims = dims, .datatype = ctx->datatype,
+    .elem_size = DATATYPE_LENGTH(ctx->datatype),
+    .tile_size = scilPr_get_dims_size(&tiling.tile, ctx->datatype),
+    .ctx = ctx, .source = (byte*) source
+  };
+  job.results = (tile_result_t*) SAFE_CALLOC(tile_count, sizeof(tile_result_t));
+  job.workers = (tile_worker_t*) SAFE_CALLOC(threads, sizeof(tile_worker_t));
+
+  int ret = scilI_parallel_for(threads, tile_count, compress_tile, &job);
+
+  if (ret == SCIL_NO_ERR) {
+    byte* pos = write_container_header(dest, &tiling);
+
+    // concatenate the tiles in order, thus the result is independent of the thread count
+    byte* offsets  = pos;
+    byte* tiles    = pos + 8 * (tile_count + 1);
+    uint64_t offset = 0;
+    for (uint64_t i = 0; i < tile_count; i++) {
+      byte* entry = offsets + 8 * i;
+      scilU_pack8(entry, offset);
+      if (header_size + offset + job.results[i].size > dest_size) {
+        ret = SCIL_MEMORY_ERR;
+        break;
+      }
+      memcpy(tiles + offset, job.results[i].data, job.results[i].size);
+      offset += job.results[i].size;
+    }
+    byte* entry = offsets + 8 * tile_count;
+    scilU_pack8(entry, offset);
+    *out_size = header_size + offset;
+  }
+
+  for (uint64_t i = 0; i < tile_count; i++) {
+    free(job.results[i].data);
+  }
+  free(job.results);
+  if (ctx->call_stats != NULL) {
+    for (int i = 0; i < threads; i++) {
+      if (job.workers[i].ctx != NULL) {
+        scilC_stats_merge(&ctx->call_stats->last, &job.workers[i].ctx->call_stats->last);
+      }
+    }
+  }
+  destroy_workers(job.workers, threads);
+
+  return ret;
+}
+
+int scilC_blocking_initialize(scilC_tiling_t* tiling, const scil_context_t* ctx, const scil_dims_t* dims)
+{
+  if (ctx->block_size == 0 || ctx->tile_dims.dims != 0) {
+    return 0;
+  }
+  // a single stage has no intermediate data, a chain that is not chosen yet may need blocking
+  if (ctx->chain.total_size == 1 || scilI_chain_needs_global_data(&ctx->chain)) {
+    return 0;
+  }
+  if (scilPr_get_dims_size(dims, ctx->datatype) < 2 * ctx->block_size) {
+    return 0;
+  }
+
+  // a block covers the lower dimensions completely and is flat above the partial one, thus it is contiguous in memory
+  scil_dims_t block;
+  block.dims = dims->dims;
+  size_t size = DATATYPE_LENGTH(ctx->datatype);
+  int d = 0;
+  for (; d < dims->dims && size * dims->length[d] <= ctx->block_size; d++) {
+    block.length[d] = 0;
+    size *= dims->length[d];
+  }
+  block.length[d] = max(ctx->block_size / size, 1);
+  for (d++; d < dims->dims; d++) {
+    block.length[d] = 1;
+  }
+  scilC_tiling_initialize(tiling, dims, &block);
+  return tiling->tile_count > 1;
+}
+
+size_t scilC_get_block_count(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+  scilC_tiling_t tiling;
+  return scilC_blocking_initialize(&tiling, ctx, dims) ? tiling.tile_count : 1;
+}
+
+size_t scilC_compress_blocked_bound(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+  scilC_tiling_t tiling;
+  scilC_blocking_initialize(&tiling, ctx, dims);
+  return container_bound(ctx, dims, &tiling);
+}
+
+int scilC_compress_blocked(byte* restrict dest,
+                           size_t dest_size,
+                           void* restrict source,
+                           const scil_dims_t* dims,
+                           size_t* restrict out_size,
+                           scil_context_t* ctx)
+{
+  scilC_tiling_t tiling;
+  scilC_blocking_initialize(&tiling, ctx, dims);
+  const uint64_t block_count = tiling.tile_count;
+  const size_t elem_size     = DATATYPE_LENGTH(ctx->datatype);
+
+  const size_t header_size = container_header_size(dims, block_count);
+  if (header_size > dest_size) {
+    return SCIL_MEMORY_ERR;
+  }
+  byte* offsets = write_container_header(dest, &tiling);
+  byte* blocks  = offsets + 8 * (block_count + 1);
+
+  // all stages process one block before the next block is read, the intermediate buffers of the
+  // chain are taken from the workspace of the context and stay the same for all blocks
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < block_count; i++) {
+    scil_dims_t origin, extent;
+    scilC_tiling_get_tile(&tiling, dims, i, &origin, &extent);
+    const ssize_t in_offset = contiguous_offset(dims, &origin, &extent, elem_size);
+    assert(in_offset >= 0);
+
+    byte* entry = offsets + 8 * i;
+    scilU_pack8(entry, offset);
+
+    // the intermediate buffers hold the previous block, its statistics must not be taken for this one
+    scilI_context_data_stats_invalidate(ctx);
+
+    size_t size;
+    int ret = scilC_compress_chain(blocks + offset, dest_size - header_size - offset, (byte*) source + in_offset, &extent, &size, ctx);
+    if (ret != SCIL_NO_ERR) {
+      return ret;
+    }
+    offset += size;
+  }
+  byte* entry = offsets + 8 * block_count;
+  scilU_pack8(entry, offset);
+  *out_size = header_size + offset;
+
+  return SCIL_NO_ERR;
+}
+
+static int decompress_tile(void* user, size_t item, int worker)
+{
+  tile_job_t* job  = (tile_job_t*) user;
+  tile_worker_t* w = &job->workers[worker];
+  const size_t tile = job->tile_list == NULL ? item : job->tile_list[item];
+  scil_dims_t origin, extent;
+
+  scil_timer timer;
+  const int trace = scilU_trace_enabled();
+  if (trace) {
+    scilU_start_timer(&timer);
+  }
+
+  scilC_tiling_get_tile(job->tiling, job->dims, tile, &origin, &extent);
+
+  uint64_t start, end;
+  const byte* entry = job->offsets + 8 * tile;
+  scilU_unpack8(entry, &start);
+  entry += 8;
+  scilU_unpack8(entry, &end);
+  if (start > end || end > job->tiles_size) {
+    return SCIL_BUFFER_ERR;
+  }
+
+  // the part of the tile covered by the region, relative to the region
+  scil_dims_t in_tile, in_region, count;
+  int inside = 1;
+  in_tile.dims = in_region.dims = count.dims = extent.dims;
+  for (int d = 0; d < extent.dims; d++) {
+    const size_t lo = max(origin.length[d], job->region_offset->length[d]);
+    const size_t hi_tile   = origin.length[d] + extent.length[d];
+    const size_t hi_region = job->region_offset->length[d] + job->region_count->length[d];
+    const size_t hi = hi_tile < hi_region ? hi_tile : hi_region;
+
+    in_tile.length[d]   = lo - origin.length[d];
+    in_region.length[d] = lo - job->region_offset->length[d];
+    count.length[d]     = hi - lo;
+    inside &= count.length[d] == extent.length[d];
+  }
+
+  // decompress directly into the output if the tile is stored contiguously
+  byte* out;
+  ssize_t offset = inside ? contiguous_offset(job->region_count, &in_region, &extent, job->elem_size) : -1;
+  if (offset >= 0) {
+    out = job->dest + offset;
+  } else {
+    if (w->tile_buffer == NULL) {
+      w->tile_buffer = (byte*) SAFE_MALLOC(job->tile_size);
+    }
+    out = w->tile_buffer;
+  }
+
+  if (job->stats != NULL && w->stats == NULL) {
+    w->stats = (scil_stats_t*) SAFE_CALLOC(1, sizeof(scil_stats_t));
+  }
+  // the scratch of multi-stage chains is taken from the workspace of the thread
+  int ret = scilC_decompress_chain(job->datatype, out, &extent, (byte*) job->tiles + start, end - start, NULL, w->stats);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+  if (offset < 0) {
+    scilI_copy_hyperslab(job->dest, job->region_count, &in_region, out, &extent, &in_tile, &count, job->elem_size);
+  }
+  if (trace) {
+    scilU_trace_span("tile", "decompress", timer, end - start, scilPr_get_dims_size(&extent, job->datatype));
+  }
+  return SCIL_NO_ERR;
+}
+
+// checks the container header and fills the job with the location of the tiles
+static int parse_container(scilC_tiling_t* tiling, tile_job_t* job, const scil_dims_t* dims, const byte* restrict source, const size_t source_size)
+{
+  assert(source[0] == SCIL_TILED_CONTAINER);
+
+  scil_dims_t tile_dims;
+  if (source_size < 2 || source[1] != dims->dims || source_size < 2 + 8 * (size_t) dims->dims + 8) {
+    return SCIL_BUFFER_ERR;
+  }
+  scilU_read_dims_from_buffer(&tile_dims, (byte*) source + 1);
+
+  scilC_tiling_initialize(tiling, dims, &tile_dims);
+
+  const byte* pos = source + 2 + 8 * dims->dims;
+  uint64_t tile_count;
+  scilU_unpack8(pos, &tile_count);
+  pos += 8;
+  if (tile_count != tiling->tile_count) {
+    return SCIL_BUFFER_ERR;
+  }
+  for (int d = 0; d < dims->dims; d++) {
+    if (tiling->tile.length[d] != tile_dims.length[d]) {
+      return SCIL_BUFFER_ERR;
+    }
+  }
+
+  const size_t header_size = (pos - source) + 8 * (tile_count + 1);
+  uint64_t total;
+  if (header_size > source_size) {
+    return SCIL_BUFFER_ERR;
+  }
+  const byte* entry = pos + 8 * tile_count;
+  scilU_unpack8(entry, &total);
+  if (header_size + total > source_size) {
+    return SCIL_BUFFER_ERR;
+  }
+
+  job->tiling     = tiling;
+  job->dims       = dims;
+  job->offsets    = pos;
+  job->tiles      = source + header_size;
+  job->tiles_size = total;
+  return SCIL_NO_ERR;
+}
+
+static int run_decompression(tile_job_t* job, size_t tile_count)
+{
+  int threads = scilI_parallel_default_thread_count();
+  if ((size_t) threads > tile_count) {
+    threads = (int) tile_count;
+  }
+  job->elem_size = DATATYPE_LENGTH(job->datatype);
+  job->tile_size = scilPr_get_dims_size(&job->tiling->tile, job->datatype);
+  job->workers   = (tile_worker_t*) SAFE_CALLOC(threads, sizeof(tile_worker_t));
+
+  int ret = scilI_parallel_for(threads, tile_count, decompress_tile, job);
+
+  if (job->stats != NULL) {
+    for (int i = 0; i < threads; i++) {
+      if (job->workers[i].stats != NULL) {
+        scilC_stats_merge(job->stats, job->workers[i].stats);
+      }
+    }
+  }
+  destroy_workers(job->workers, threads);
+  return ret;
+}
+
+int scilC_decompress_tiled(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           const scil_dims_t* dims,
+                           const byte* restrict source,
+                           const size_t source_size,
+                           scil_stats_t* stats)
+{
+  scilC_tiling_t tiling;
+  tile_job_t job = { .datatype = datatype, .dest = (byte*) dest, .stats = stats };
+  scil_dims_t zero = {0};
+
+  int ret = parse_container(&tiling, &job, dims, source, source_size);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+  zero.dims          = dims->dims;
+  job.region_offset  = &zero;
+  job.region_count   = dims;
+
+  return run_decompression(&job, tiling.tile_count);
+}
+
+int scilC_decompress_tiled_region(SCIL_Datatype_t datatype,
+                                  void* restrict dest,
+                                  const scil_dims_t* dims,
+                                  const scil_dims_t* offset,
+                                  const scil_dims_t* count,
+                                  const byte* restrict source,
+                                  const size_t source_size)
+{
+  scilC_tiling_t tiling;
+  tile_job_t job = { .datatype = datatype, .dest = (byte*) dest, .region_offset = offset, .region_count = count };
+
+  int ret = parse_container(&tiling, &job, dims, source, source_size);
+  if (ret != SCIL_NO_ERR) {
+    return ret;
+  }
+
+  // enumerate the tiles overlapping the region, the first dimension varies fastest
+  size_t first[SCIL_DIMS_MAX];
+  size_t range[SCIL_DIMS_MAX];
+  size_t tile_count = 1;
+  for (int d = 0; d < dims->dims; d++) {
+    first[d] = offset->length[d] / tiling.tile.length[d];
+    range[d] = (offset->length[d] + count->length[d] - 1) / tiling.tile.length[d] - first[d] + 1;
+    tile_count *= range[d];
+  }
+
+  size_t* tile_list = (size_t*) SAFE_MALLOC(tile_count * sizeof(size_t));
+  for (size_t i = 0; i < tile_count; i++) {
+    size_t rest = i;
+    size_t tile = 0;
+    size_t grid_stride = 1;
+    for (int d = 0; d < dims->dims; d++) {
+      tile += (first[d] + rest % range[d]) * grid_stride;
+      rest /= range[d];
+      grid_stride *= tiling.grid[d];
+    }
+    tile_list[i] = tile;
+  }
+  job.tile_list = tile_list;
+
+  ret = run_decompression(&job, tile_count);
+  free(tile_list);
+  return ret;
+}
@@ -0,0 +1,119 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_TILING_H
+#define SCIL_TILING_H
+
+#include <scil-context.h>
+#include <scil-dims.h>
+
+struct scil_stats;
+
+/*
+ A tiled container starts with this byte instead of the chain length.
+ It is formated as follows:
+ - byte SCIL_TILED_CONTAINER
+ - the dimensions of a regular tile as written by scilU_write_dims_to_buffer()
+ - uint64 TILE_COUNT
+ - uint64 OFFSET[TILE_COUNT + 1] // relative to the first tile, the last entry is the total size
+ - the tiles, each one compressed with the regular chain format
+
+ Tiles are numbered with the first dimension varying fastest, tiles at the upper
+ border of a dimension may be smaller than the regular tile.
+ */
+#define SCIL_TILED_CONTAINER 255
+
+/** \brief Geometry of the tiles covering a domain. */
+typedef struct {
+  /** \brief The extent of a regular tile */
+  scil_dims_t tile;
+  /** \brief Number of tiles in each dimension */
+  size_t grid[SCIL_DIMS_MAX];
+  size_t tile_count;
+} scilC_tiling_t;
+
+/**
+ * \brief Computes the tiles covering dims.
+ * \param tile_dims the requested tile extent, a length of 0 and missing dimensions cover the whole domain
+ */
+void scilC_tiling_initialize(scilC_tiling_t* tiling, const scil_dims_t* dims, const scil_dims_t* tile_dims);
+
+/**
+ * \brief Returns the position and extent of a tile within the domain.
+ */
+void scilC_tiling_get_tile(const scilC_tiling_t* tiling, const scil_dims_t* dims, size_t tile, scil_dims_t* out_origin, scil_dims_t* out_extent);
+
+/**
+ * \brief Returns the number of tiles the data is split into by the tiling configured in ctx, 1 if tiling is disabled.
+ */
+size_t scilC_get_tile_count(const scil_context_t* ctx, const scil_dims_t* dims);
+
+/**
+ * \brief Returns the maximum size of the tiled container, see scil_compress_bound().
+ */
+size_t scilC_compress_tiled_bound(const scil_context_t* ctx, const scil_dims_t* dims);
+
+int scilC_compress_tiled(byte* restrict dest,
+                         size_t dest_size,
+                         void* restrict source,
+                         const scil_dims_t* dims,
+                         size_t* restrict out_size,
+                         scil_context_t* ctx);
+
+/**
+ * \brief Computes the blocks for the blocked execution of the chain of ctx.
+ * Instead of streaming the whole array through one stage after another, the blocks are pushed through all stages
+ * one after another, thus the intermediate data stays in the cache. The blocks are stored in the tiled container.
+ * \return 1 if the data is compressed in blocks, 0 if the whole array is compressed at once
+ */
+int scilC_blocking_initialize(scilC_tiling_t* tiling, const scil_context_t* ctx, const scil_dims_t* dims);
+
+/**
+ * \brief Returns the number of blocks scil_compress() processes sequentially, 1 if the whole array is compressed at once.
+ */
+size_t scilC_get_block_count(const scil_context_t* ctx, const scil_dims_t* dims);
+
+size_t scilC_compress_blocked_bound(const scil_context_t* ctx, const scil_dims_t* dims);
+
+int scilC_compress_blocked(byte* restrict dest,
+                           size_t dest_size,
+                           void* restrict source,
+                           const scil_dims_t* dims,
+                           size_t* restrict out_size,
+                           scil_context_t* ctx);
+
+/**
+ * \brief Decompresses all tiles in parallel, the stages of the tiles are added to stats if it is not NULL.
+ */
+int scilC_decompress_tiled(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           const scil_dims_t* dims,
+                           const byte* restrict source,
+                           const size_t source_size,
+                           struct scil_stats* stats);
+
+/**
+ * \brief Decompresses only the tiles overlapping the hyperslab given by offset and count.
+ * \param dest a buffer with the extent count
+ */
+int scilC_decompress_tiled_region(SCIL_Datatype_t datatype,
+                                  void* restrict dest,
+                                  const scil_dims_t* dims,
+                                  const scil_dims_t* offset,
+                                  const scil_dims_t* count,
+                                  const byte* restrict source,
+                                  const size_t source_size);
+
+#endif // SCIL_TILING_H
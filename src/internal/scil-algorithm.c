@@ -11,3 +11,11 @@ scilI_algorithm_t* scilI_find_compressor_by_name(const char* name)
         return algo_array[num];
     }
 }
+
+size_t scilI_algorithm_compress_bound(const scilI_algorithm_t* algo, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size)
+{
+    if (algo->compress_bound == NULL) {
+        return 2 * in_size;
+    }
+    return algo->compress_bound(datatype, dims, in_size);
+}
@@ -5,4 +5,10 @@
 
 scilI_algorithm_t* scilI_find_compressor_by_name(const char* name);
 
+/**
+ * \brief Returns the maximum number of bytes the algorithm writes when compressing in_size bytes.
+ * Falls back to 2x the input size for algorithms that do not provide a bound.
+ */
+size_t scilI_algorithm_compress_bound(const scilI_algorithm_t* algo, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
 #endif // SCIL_COMPRESSION_ALGORITHM_H
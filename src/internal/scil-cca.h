@@ -13,6 +13,9 @@
 #define PRECONDITIONER_LIMIT 10
 
 struct scil_compression_algorithm;
+struct scil_workspace;
+struct scil_data_stats;
+struct scil_context_stats;
 
 typedef struct scil_compression_chain {
   struct scil_compression_algorithm* pre_cond_first[PRECONDITIONER_LIMIT]; // preconditioners first stage
@@ -39,8 +42,41 @@ typedef struct scil_context {
   /** \brief The last compressor used, could be used for debugging */
   scilI_chain_t chain;
 
+  /** \brief Set if the chooser picked the chain with learning enabled, the decision is revised periodically */
+  int chain_adaptive;
+  /** \brief Compressions since the last decision of the chooser and the number of its decisions */
+  int chooser_calls;
+  unsigned chooser_decisions;
+
+  /** \brief Identifies the variable in the decision cache of the chooser, NULL disables the cache */
+  char * variable_id;
+
   /** \brief Dictionary for pipeline internal parameters */
   scilI_dict_t * pipeline_params;
+
+  /** \brief Extent of a tile for tiled compression, dims == 0 disables tiling */
+  scil_dims_t tile_dims;
+
+  /** \brief Number of threads processing tiles, 0 selects a default */
+  int tile_threads;
+
+  /** \brief Input bytes pushed through all stages of the chain at once, 0 processes the whole array stage by stage */
+  size_t block_size;
+
+  /** \brief Bytes of the data examined by the automatic selection of the chain, 0 examines all data */
+  size_t sample_size;
+
+  /** \brief Scratch space for the chain and the algorithms, grown on demand and reused across calls */
+  struct scil_workspace* workspace;
+
+  /** \brief Statistics of the data compressed at the moment, see scilI_context_data_stats() */
+  struct scil_data_stats* stats;
+
+  /** \brief Timing of the stages of the last and of all compressions, NULL unless enabled with scilPr_set_stats() */
+  struct scil_context_stats* call_stats;
+
+  /** \brief Staging buffers and pending requests of scil_compress_async(), NULL until the first request */
+  struct scil_async_context* async;
 } scil_context_t;
 
 enum compressor_type{
@@ -52,7 +88,8 @@ enum compressor_type{
 };
 
 /*
- An algorithm implementation can be sure that the compression output buffer is at least 2x the size of the input data.
+ An algorithm implementation can be sure that the compression output buffer is at least the size returned by compress_bound.
+ Algorithms without compress_bound can be sure that the output buffer is at least 2x the size of the input data.
  */
 typedef struct scil_compression_algorithm {
   union{
@@ -144,6 +181,13 @@ typedef struct scil_compression_algorithm {
 
   enum compressor_type type;
   char is_lossy; // byte compressors are expected to be lossless anyway
+
+  // optional, the maximum number of bytes written by compress for in_size bytes of input.
+  // For preconditioners this includes the header, for converters and data compressors in_size is the size of the original data.
+  size_t (*compress_bound)(SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t in_size);
+
+  // set if the algorithm must see the whole array, e.g., for a transform, it disables the blocked execution of the chain
+  char needs_global_data;
 } scilI_algorithm_t;
 
 #endif // SCIL_CCA_H
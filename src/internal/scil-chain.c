@@ -3,6 +3,7 @@
 #include <scil-algorithm.h>
 #include <scil-error.h>
 #include <scil-internal.h>
+#include <scil-util.h>
 
 #include <string.h>
 
@@ -17,6 +18,10 @@ int scilI_create_chain(scilI_chain_t* chain, const char* str_in)
     chain->precond_first_count  = 0;
     chain->precond_second_count = 0;
     chain->total_size           = 0;
+    // the chain of a context is replaced when the chooser revises its decision
+    chain->converter            = NULL;
+    chain->data_compressor      = NULL;
+    chain->byte_compressor      = NULL;
 
     char lossy = 0;
     for (int i = 0; token != NULL; i++) {
@@ -163,3 +168,97 @@ int scilI_chain_is_applicable(const scilI_chain_t* chain, SCIL_Datatype_t dataty
   }
   return SCIL_NO_ERR;
 }
+
+size_t scilI_chain_compress_bound(const scilI_chain_t* chain, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t* out_stage_size)
+{
+    // mirrors the buffer layout of scilC_compress_chain(), every stage appends its compressor id
+    const size_t datatypes_size = scilPr_get_dims_size(dims, datatype);
+    size_t size                 = datatypes_size;
+    size_t stage_size           = 0;
+    int remaining               = chain->total_size;
+
+    for (int i = 0; i < chain->precond_first_count; i++) {
+        size += scilI_algorithm_compress_bound(chain->pre_cond_first[i], datatype, dims, datatypes_size) - datatypes_size + 1;
+    }
+    if (chain->precond_first_count > 0 && remaining > 1) {
+        stage_size = size;
+    }
+    remaining -= chain->precond_first_count;
+
+    if (chain->converter) {
+        size = scilI_algorithm_compress_bound(chain->converter, datatype, dims, datatypes_size) + size - datatypes_size + 1;
+        if (--remaining > 0) {
+            stage_size = max(stage_size, size);
+        }
+    }
+
+    if (chain->precond_second_count > 0) {
+        // the headers are placed behind the data of the original size
+        const size_t data_size = size + datatypes_size;
+        size = data_size;
+        for (int i = 0; i < chain->precond_second_count; i++) {
+            size += scilI_algorithm_compress_bound(chain->pre_cond_second[i], datatype, dims, data_size) - data_size + 1;
+        }
+        remaining -= chain->precond_second_count;
+        if (remaining > 0) {
+            stage_size = max(stage_size, size);
+        }
+    }
+
+    if (chain->data_compressor) {
+        size = scilI_algorithm_compress_bound(chain->data_compressor, datatype, dims, datatypes_size) + size - datatypes_size + 1;
+        if (--remaining > 0) {
+            stage_size = max(stage_size, size);
+        }
+    }
+
+    if (chain->byte_compressor) {
+        size = scilI_algorithm_compress_bound(chain->byte_compressor, datatype, dims, size) + 1;
+    }
+
+    if (out_stage_size != NULL) {
+        *out_stage_size = stage_size;
+    }
+    return size + 1;
+}
+
+int scilI_chain_needs_global_data(const scilI_chain_t* chain)
+{
+    for (int i = 0; i < chain->precond_first_count; i++) {
+        if (chain->pre_cond_first[i]->needs_global_data) return 1;
+    }
+    for (int i = 0; i < chain->precond_second_count; i++) {
+        if (chain->pre_cond_second[i]->needs_global_data) return 1;
+    }
+    if (chain->converter && chain->converter->needs_global_data) return 1;
+    if (chain->data_compressor && chain->data_compressor->needs_global_data) return 1;
+    if (chain->byte_compressor && chain->byte_compressor->needs_global_data) return 1;
+    return 0;
+}
+
+void scilI_chain_sprint(const scilI_chain_t* chain, char* out, int buff_length)
+{
+    const scilI_algorithm_t* algos[2 * PRECONDITIONER_LIMIT + 3];
+    int count = 0;
+    for (int i = 0; i < chain->precond_first_count; i++) {
+        algos[count++] = chain->pre_cond_first[i];
+    }
+    if (chain->converter != NULL) {
+        algos[count++] = chain->converter;
+    }
+    for (int i = 0; i < chain->precond_second_count; i++) {
+        algos[count++] = chain->pre_cond_second[i];
+    }
+    if (chain->data_compressor != NULL) {
+        algos[count++] = chain->data_compressor;
+    }
+    if (chain->byte_compressor != NULL) {
+        algos[count++] = chain->byte_compressor;
+    }
+
+    out[0] = 0;
+    int pos = 0;
+    for (int i = 0; i < count && pos < buff_length; i++) {
+        pos += snprintf(out + pos, buff_length - pos, i == 0 ? "%s" : ",%s", algos[i]->name);
+    }
+}
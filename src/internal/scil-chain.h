@@ -7,4 +7,20 @@ int scilI_create_chain(scilI_chain_t* chain, const char* str_in);
 
 int scilI_chain_is_applicable(const scilI_chain_t* chain, SCIL_Datatype_t datatype);
 
+/**
+ * \brief Returns the maximum size of the data compressed with the chain, including the chain length.
+ * \param out_stage_size if not NULL, set to the size needed for the output of an intermediate stage
+ */
+size_t scilI_chain_compress_bound(const scilI_chain_t* chain, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t* out_stage_size);
+
+/**
+ * \brief Prints the names of the algorithms of the chain separated by commas, the format parsed by scilI_create_chain().
+ */
+void scilI_chain_sprint(const scilI_chain_t* chain, char* out, int buff_length);
+
+/**
+ * \brief Returns 1 if an algorithm of the chain must process the whole array at once.
+ */
+int scilI_chain_needs_global_data(const scilI_chain_t* chain);
+
 #endif // SCIL_CHAIN_H
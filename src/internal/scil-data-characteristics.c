@@ -1,9 +1,13 @@
 #include <scil-data-characteristics.h>
 
 #include <scil-internal.h>
+#include <scil-util.h>
 
 #include <algo/lz4fast.h>
 
+#include <math.h>
+#include <string.h>
+
 float scilI_get_data_randomness(const void* source, size_t in_size, byte* restrict buffer, size_t buffer_size)
 {
     // We may want to use https://en.wikipedia.org/wiki/Randomness_tests
@@ -15,3 +19,173 @@ float scilI_get_data_randomness(const void* source, size_t in_size, byte* restri
         critical("lz4fast error to determine randomness: %d\n", ret);
     }
 }
+
+// the position of the k-th block within a dimension in [0, 1), each dimension uses another base
+static double radical_inverse(size_t k, size_t base)
+{
+    double inverse = 0;
+    double digit = 1.0 / base;
+    for (; k > 0; k /= base, digit /= base) {
+        inverse += (k % base) * digit;
+    }
+    return inverse;
+}
+
+// copies the hyperslab rows into one contiguous block
+static void gather_block(byte* restrict out, const byte* restrict source, const scil_dims_t* dims, const size_t* start, const size_t* extent, size_t elem_size)
+{
+    size_t pos[SCIL_DIMS_MAX] = {0};
+    const size_t row = extent[0] * elem_size;
+    while (1) {
+        size_t offset = 0;
+        size_t stride = elem_size;
+        for (int d = 0; d < dims->dims; d++) {
+            offset += (start[d] + pos[d]) * stride;
+            stride *= dims->length[d];
+        }
+        memcpy(out, source + offset, row);
+        out += row;
+
+        int d = 1;
+        for (; d < dims->dims; d++) {
+            if (++pos[d] < extent[d]) {
+                break;
+            }
+            pos[d] = 0;
+        }
+        if (d >= dims->dims) {
+            return;
+        }
+    }
+}
+
+static double value_at(const byte* data, SCIL_Datatype_t datatype, size_t i)
+{
+    switch (datatype) {
+    case SCIL_TYPE_FLOAT:
+        return ((const float*) data)[i];
+    case SCIL_TYPE_DOUBLE:
+        return ((const double*) data)[i];
+    case SCIL_TYPE_INT8:
+        return ((const int8_t*) data)[i];
+    case SCIL_TYPE_INT16:
+        return ((const int16_t*) data)[i];
+    case SCIL_TYPE_INT32:
+        return ((const int32_t*) data)[i];
+    case SCIL_TYPE_INT64:
+        return (double) ((const int64_t*) data)[i];
+    default:
+        return 0;
+    }
+}
+
+typedef struct {
+    size_t count;
+    double min;
+    double max;
+    double sum;
+    double sum_squares;
+    double max_step;
+} block_statistics_t;
+
+// adds the values of a contiguous block with the extent to the statistics
+static void add_block_statistics(block_statistics_t* s, const byte* block, SCIL_Datatype_t datatype, int dims, const size_t* extent)
+{
+    if (datatype > SCIL_DATATYPE_NUMERIC_MAX) {
+        return;
+    }
+    size_t count = 1;
+    for (int d = 0; d < dims; d++) {
+        count *= extent[d];
+    }
+    for (size_t i = 0; i < count; i++) {
+        const double v = value_at(block, datatype, i);
+        if (s->count == 0 && i == 0) {
+            s->min = v;
+            s->max = v;
+        }
+        s->min = v < s->min ? v : s->min;
+        s->max = v > s->max ? v : s->max;
+        s->sum += v;
+        s->sum_squares += v * v;
+
+        // the predecessor in every dimension
+        size_t stride = 1;
+        size_t rest = i;
+        for (int d = 0; d < dims; d++) {
+            if (rest % extent[d] > 0) {
+                const double step = fabs(v - value_at(block, datatype, i - stride));
+                s->max_step = step > s->max_step ? step : s->max_step;
+            }
+            rest /= extent[d];
+            stride *= extent[d];
+        }
+    }
+    s->count += count;
+}
+
+static float sample(const void* source, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t sample_size, scilI_workspace_t* ws, block_statistics_t* stats)
+{
+    static const size_t bases[SCIL_DIMS_MAX] = {2, 3, 5, 7};
+    const size_t elem_size = DATATYPE_LENGTH(datatype);
+    const size_t size = scilPr_get_dims_size(dims, datatype);
+
+    scilI_workspace_reset(ws);
+    if (sample_size == 0 || sample_size >= size) {
+        if (stats != NULL) {
+            add_block_statistics(stats, (const byte*) source, datatype, dims->dims, dims->length);
+        }
+        const size_t buffer_size = scil_lz4fast_compress_bound(datatype, dims, size);
+        byte* buffer = (byte*) scilI_workspace_alloc(ws, buffer_size);
+        return scilI_get_data_randomness(source, size, buffer, buffer_size);
+    }
+
+    // the extent of a block: whole rows first, then the next dimension
+    size_t remain = max(sample_size / SCIL_SAMPLE_BLOCKS / elem_size, (size_t) 1);
+    size_t extent[SCIL_DIMS_MAX];
+    size_t block_size = elem_size;
+    for (int d = 0; d < dims->dims; d++) {
+        extent[d] = remain < dims->length[d] ? remain : dims->length[d];
+        remain = max(remain / extent[d], (size_t) 1);
+        block_size *= extent[d];
+    }
+
+    const size_t buffer_size = scil_lz4fast_compress_bound(datatype, dims, block_size);
+    byte* block = (byte*) scilI_workspace_alloc(ws, block_size);
+    byte* buffer = (byte*) scilI_workspace_alloc(ws, buffer_size);
+    double compressed = 0;
+    for (size_t k = 0; k < SCIL_SAMPLE_BLOCKS; k++) {
+        size_t start[SCIL_DIMS_MAX];
+        for (int d = 0; d < dims->dims; d++) {
+            start[d] = (size_t) (radical_inverse(k + 1, bases[d]) * (double) (dims->length[d] - extent[d] + 1));
+        }
+        gather_block(block, (const byte*) source, dims, start, extent, elem_size);
+        if (stats != NULL) {
+            add_block_statistics(stats, block, datatype, dims->dims, extent);
+        }
+        compressed += (double) scilI_get_data_randomness(block, block_size, buffer, buffer_size);
+    }
+    return (float) (compressed / SCIL_SAMPLE_BLOCKS);
+}
+
+float scilI_sample_data_randomness(const void* source, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t sample_size, scilI_workspace_t* ws)
+{
+    return sample(source, datatype, dims, sample_size, ws, NULL);
+}
+
+void scilI_sample_data_features(const void* source, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t sample_size, scilI_workspace_t* ws, scilI_data_features_t* out)
+{
+    block_statistics_t s;
+    memset(& s, 0, sizeof(s));
+    memset(out, 0, sizeof(scilI_data_features_t));
+    out->randomness = sample(source, datatype, dims, sample_size, ws, & s);
+    if (s.count == 0) {
+        return;
+    }
+    out->min = s.min;
+    out->max = s.max;
+    out->mean = s.sum / (double) s.count;
+    const double variance = s.sum_squares / (double) s.count - out->mean * out->mean;
+    out->stddev = variance > 0 ? sqrt(variance) : 0;
+    out->max_step = s.max_step;
+}
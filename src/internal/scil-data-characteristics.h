@@ -2,9 +2,45 @@
 #define SCIL_DATA_CHARACTERISTICS_H
 
 #include <scil-datatypes.h>
+#include <scil-dims.h>
+#include <scil-workspace.h>
 
 #include <stdlib.h>
 
 float scilI_get_data_randomness(const void* source, size_t in_size, byte* restrict buffer, size_t buffer_size);
 
+/*
+ Large arrays are characterized by this many blocks spread over all dimensions.
+ */
+#define SCIL_SAMPLE_BLOCKS 16
+
+/**
+ * \brief Estimates the randomness of the whole array from blocks spread over all its dimensions.
+ * A block is a hyperslab, thus neighbouring points in every dimension are compressed together.
+ * All blocks have the same size, the result is the mean of their randomness.
+ * \param sample_size the bytes of all blocks together, 0 or a size beyond the array measures the whole array
+ * \param ws provides the scratch memory, it is reset
+ * \return the size of the compressed blocks in percent of their size, see scilI_get_data_randomness()
+ */
+float scilI_sample_data_randomness(const void* source, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t sample_size, scilI_workspace_t* ws);
+
+/*
+ The statistics of the sampled blocks, they are the characteristics tools/scil-generate-chooser-data records.
+ */
+typedef struct{
+  float randomness;
+  double min;
+  double max;
+  double mean;
+  double stddev;
+  // the largest difference between neighbours in any dimension within a block
+  double max_step;
+} scilI_data_features_t;
+
+/**
+ * \brief Samples the same blocks as scilI_sample_data_randomness() and computes their statistics as well.
+ * Strings and binary data only provide the randomness, their statistics are 0.
+ */
+void scilI_sample_data_features(const void* source, SCIL_Datatype_t datatype, const scil_dims_t* dims, size_t sample_size, scilI_workspace_t* ws, scilI_data_features_t* out);
+
 #endif // SCIL_DATA_CHARACTERISTICS_H
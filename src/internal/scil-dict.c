@@ -50,6 +50,7 @@ void scilI_dict_destroy(scilI_dict_t* dict)
         }
     }
     free(dict->elem);
+    free(dict);
 }
 
 /* lookup: look for s in dict */
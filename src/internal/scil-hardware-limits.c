@@ -18,14 +18,15 @@
 #include <scil.h>
 #include <scil-error.h>
 
+#include <assert.h>
 #include <string.h>
 #include <stdio.h>
 
 static float hardware_limits[HARDWARE_MAX];
 static const char* hardware_names[] = {
-  "storage",
-  "network",
-  NULL
+  [NETWORK] = "network",
+  [STORAGE] = "storage",
+  [HARDWARE_MAX] = NULL
 };
 
 void scilI_initialize_hardware_limits(){
@@ -46,3 +47,8 @@ int scilI_add_hardware_limit(const char* name, const char* str){
   }
   return SCIL_EINVAL;
 }
+
+float scilI_get_hardware_limit(enum hardware_limit_e limit){
+  assert(limit < HARDWARE_MAX);
+  return hardware_limits[limit];
+}
@@ -26,5 +26,10 @@ void scilI_initialize_hardware_limits();
 
 int scilI_add_hardware_limit(const char* name, const char* str);
 
+/**
+ * \brief Returns the throughput of the component in MiB/s as configured in scil.conf, 0 if it is unknown.
+ */
+float scilI_get_hardware_limit(enum hardware_limit_e limit);
+
 
 #endif // SCIL_HARDWARE_LIMITS_H
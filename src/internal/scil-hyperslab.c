@@ -0,0 +1,66 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-hyperslab.h>
+
+#include <assert.h>
+#include <string.h>
+
+void scilI_copy_hyperslab(void* restrict dst,
+                          const scil_dims_t* dst_dims,
+                          const scil_dims_t* dst_offset,
+                          const void* restrict src,
+                          const scil_dims_t* src_dims,
+                          const scil_dims_t* src_offset,
+                          const scil_dims_t* count,
+                          size_t elem_size)
+{
+  const int dims = count->dims;
+  assert(dims == src_dims->dims && dims == dst_dims->dims);
+
+  size_t src_stride[SCIL_DIMS_MAX];
+  size_t dst_stride[SCIL_DIMS_MAX];
+  size_t rows = 1;
+  src_stride[0] = elem_size;
+  dst_stride[0] = elem_size;
+  for (int d = 1; d < dims; d++) {
+    src_stride[d] = src_stride[d - 1] * src_dims->length[d - 1];
+    dst_stride[d] = dst_stride[d - 1] * dst_dims->length[d - 1];
+    rows *= count->length[d];
+  }
+  if (dims == 0 || count->length[0] == 0) {
+    return;
+  }
+  const size_t row_size = count->length[0] * elem_size;
+
+  size_t pos[SCIL_DIMS_MAX] = {0};
+  for (size_t r = 0; r < rows; r++) {
+    size_t src_pos = 0;
+    size_t dst_pos = 0;
+    for (int d = 0; d < dims; d++) {
+      src_pos += (src_offset->length[d] + pos[d]) * src_stride[d];
+      dst_pos += (dst_offset->length[d] + pos[d]) * dst_stride[d];
+    }
+    memcpy((char*) dst + dst_pos, (const char*) src + src_pos, row_size);
+
+    // advance to the next row, dimension 0 is copied as a whole
+    for (int d = 1; d < dims; d++) {
+      if (++pos[d] < count->length[d]) {
+        break;
+      }
+      pos[d] = 0;
+    }
+  }
+}
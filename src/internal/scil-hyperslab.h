@@ -0,0 +1,37 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_HYPERSLAB_H
+#define SCIL_HYPERSLAB_H
+
+#include <scil-dims.h>
+
+/**
+ * \brief Copies an N-D hyperslab between two arrays of the same dimensionality.
+ * The region of extent count starts at src_offset in src and at dst_offset in dst.
+ * The first dimension is the fastest varying one, rows along it are copied with memcpy.
+ * \param elem_size size of a single element in bytes
+ * \pre count->dims == src_dims->dims == dst_dims->dims
+ */
+void scilI_copy_hyperslab(void* restrict dst,
+                          const scil_dims_t* dst_dims,
+                          const scil_dims_t* dst_offset,
+                          const void* restrict src,
+                          const scil_dims_t* src_dims,
+                          const scil_dims_t* src_offset,
+                          const scil_dims_t* count,
+                          size_t elem_size);
+
+#endif // SCIL_HYPERSLAB_H
@@ -0,0 +1,128 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-parallel.h>
+
+#include <scil-error.h>
+#include <scil-internal.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+  scilI_parallel_func_t func;
+  void* user;
+  size_t item_count;
+
+  size_t next_item;
+  int stop;
+
+  pthread_mutex_t lock;
+  size_t failed_item;
+  int ret;
+} parallel_loop_t;
+
+typedef struct {
+  parallel_loop_t* loop;
+  int worker;
+} parallel_worker_t;
+
+int scilI_parallel_default_thread_count()
+{
+  const char* env = getenv("SCIL_THREADS");
+  if (env != NULL) {
+    int count = atoi(env);
+    if (count > 0) {
+      return count;
+    }
+  }
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return cpus > 0 ? (int) cpus : 1;
+}
+
+static void* worker_main(void* arg)
+{
+  parallel_worker_t* w  = (parallel_worker_t*) arg;
+  parallel_loop_t* loop = w->loop;
+
+  while (! __atomic_load_n(&loop->stop, __ATOMIC_RELAXED)) {
+    size_t item = __atomic_fetch_add(&loop->next_item, 1, __ATOMIC_RELAXED);
+    if (item >= loop->item_count) {
+      break;
+    }
+    int ret = loop->func(loop->user, item, w->worker);
+    if (ret != SCIL_NO_ERR) {
+      pthread_mutex_lock(&loop->lock);
+      if (loop->ret == SCIL_NO_ERR || item < loop->failed_item) {
+        loop->ret         = ret;
+        loop->failed_item = item;
+      }
+      pthread_mutex_unlock(&loop->lock);
+      __atomic_store_n(&loop->stop, 1, __ATOMIC_RELAXED);
+    }
+  }
+  return NULL;
+}
+
+int scilI_parallel_for(int thread_count, size_t item_count, scilI_parallel_func_t func, void* user)
+{
+  if (thread_count <= 0) {
+    thread_count = scilI_parallel_default_thread_count();
+  }
+  if ((size_t) thread_count > item_count) {
+    thread_count = (int) item_count;
+  }
+  if (thread_count <= 1) {
+    for (size_t i = 0; i < item_count; i++) {
+      int ret = func(user, i, 0);
+      if (ret != SCIL_NO_ERR) {
+        return ret;
+      }
+    }
+    return SCIL_NO_ERR;
+  }
+
+  parallel_loop_t loop = {
+    .func = func, .user = user, .item_count = item_count,
+    .next_item = 0, .stop = 0, .failed_item = 0, .ret = SCIL_NO_ERR
+  };
+  pthread_mutex_init(&loop.lock, NULL);
+
+  pthread_t threads[thread_count];
+  parallel_worker_t workers[thread_count];
+  int started = 1;
+
+  for (int i = 0; i < thread_count; i++) {
+    workers[i].loop   = &loop;
+    workers[i].worker = i;
+  }
+  for (int i = 1; i < thread_count; i++) {
+    if (pthread_create(&threads[i], NULL, worker_main, &workers[i]) != 0) {
+      // continue with the workers we have
+      warn("could only start %d of %d threads\n", started, thread_count);
+      break;
+    }
+    started++;
+  }
+  worker_main(&workers[0]);
+
+  for (int i = 1; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&loop.lock);
+
+  return loop.ret;
+}
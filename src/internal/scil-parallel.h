@@ -0,0 +1,44 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_PARALLEL_H
+#define SCIL_PARALLEL_H
+
+#include <stddef.h>
+
+/**
+ * \brief Work function of a parallel loop.
+ * \param user the pointer handed to scilI_parallel_for()
+ * \param item the index of the item to process
+ * \param worker the index of the calling worker, 0 <= worker < thread_count
+ * \return SCIL_NO_ERR or an error code that stops the loop
+ */
+typedef int (*scilI_parallel_func_t)(void* user, size_t item, int worker);
+
+/**
+ * \brief Number of workers used if the user does not request a specific count.
+ * The environment variable SCIL_THREADS overrides the number of online processors.
+ */
+int scilI_parallel_default_thread_count();
+
+/**
+ * \brief Processes the items 0 .. item_count-1 using up to thread_count workers.
+ * Items are handed out dynamically, the calling thread acts as worker 0.
+ * \param thread_count number of workers, 0 uses scilI_parallel_default_thread_count()
+ * \return SCIL_NO_ERR or the error of the item with the lowest index that failed
+ */
+int scilI_parallel_for(int thread_count, size_t item_count, scilI_parallel_func_t func, void* user);
+
+#endif // SCIL_PARALLEL_H
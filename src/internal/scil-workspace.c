@@ -0,0 +1,151 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-workspace.h>
+
+#include <scil-util.h>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct workspace_block {
+  struct workspace_block* next;
+  unsigned char* data;
+  size_t size;
+  size_t used;
+} workspace_block_t;
+
+struct scil_workspace {
+  // the block allocations are taken from, older blocks follow
+  workspace_block_t* blocks;
+  size_t capacity;
+};
+
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_key;
+
+static size_t align_size(size_t size)
+{
+  return (size + SCIL_WORKSPACE_ALIGNMENT - 1) & ~((size_t) SCIL_WORKSPACE_ALIGNMENT - 1);
+}
+
+static void add_block(scilI_workspace_t* ws, size_t size)
+{
+  workspace_block_t* block = (workspace_block_t*) SAFE_MALLOC(sizeof(workspace_block_t) + size + SCIL_WORKSPACE_ALIGNMENT);
+  block->data = (unsigned char*) align_size((uintptr_t) (block + 1));
+  block->size = size;
+  block->used = 0;
+  block->next = ws->blocks;
+  ws->blocks  = block;
+  ws->capacity += size;
+}
+
+static void free_blocks(scilI_workspace_t* ws)
+{
+  workspace_block_t* block = ws->blocks;
+  while (block != NULL) {
+    workspace_block_t* next = block->next;
+    free(block);
+    block = next;
+  }
+  ws->blocks   = NULL;
+  ws->capacity = 0;
+}
+
+scilI_workspace_t* scilI_workspace_create()
+{
+  return (scilI_workspace_t*) SAFE_CALLOC(1, sizeof(scilI_workspace_t));
+}
+
+void scilI_workspace_destroy(scilI_workspace_t* ws)
+{
+  if (ws == NULL) {
+    return;
+  }
+  free_blocks(ws);
+  free(ws);
+}
+
+void* scilI_workspace_alloc(scilI_workspace_t* ws, size_t size)
+{
+  size = align_size(size == 0 ? 1 : size);
+  workspace_block_t* block = ws->blocks;
+  if (block == NULL || block->size - block->used < size) {
+    // grow geometrically to limit the number of blocks until the next reset
+    add_block(ws, max(size, ws->capacity));
+    block = ws->blocks;
+  }
+  void* ptr = block->data + block->used;
+  block->used += size;
+  return ptr;
+}
+
+void scilI_workspace_reset(scilI_workspace_t* ws)
+{
+  if (ws->blocks != NULL && ws->blocks->next != NULL) {
+    const size_t capacity = ws->capacity;
+    free_blocks(ws);
+    add_block(ws, capacity);
+  }
+  if (ws->blocks != NULL) {
+    ws->blocks->used = 0;
+  }
+}
+
+void scilI_workspace_reserve(scilI_workspace_t* ws, size_t size)
+{
+  scilI_workspace_reset(ws);
+  size = align_size(size);
+  if (ws->capacity < size) {
+    free_blocks(ws);
+    add_block(ws, size);
+  }
+}
+
+size_t scilI_workspace_capacity(const scilI_workspace_t* ws)
+{
+  return ws->capacity;
+}
+
+size_t scilI_workspace_used(const scilI_workspace_t* ws)
+{
+  size_t used = 0;
+  for (const workspace_block_t* block = ws->blocks; block != NULL; block = block->next) {
+    used += block->used;
+  }
+  return used;
+}
+
+static void destroy_thread_workspace(void* ws)
+{
+  scilI_workspace_destroy((scilI_workspace_t*) ws);
+}
+
+static void create_thread_key()
+{
+  pthread_key_create(&thread_key, destroy_thread_workspace);
+}
+
+scilI_workspace_t* scilI_thread_workspace()
+{
+  pthread_once(&thread_key_once, create_thread_key);
+  scilI_workspace_t* ws = (scilI_workspace_t*) pthread_getspecific(thread_key);
+  if (ws == NULL) {
+    ws = scilI_workspace_create();
+    pthread_setspecific(thread_key, ws);
+  }
+  return ws;
+}
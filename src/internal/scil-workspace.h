@@ -0,0 +1,66 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_WORKSPACE_H
+#define SCIL_WORKSPACE_H
+
+#include <stddef.h>
+
+/*
+ A workspace is a scratch arena for temporary buffers of the compression chain.
+ Allocations are never freed individually, the chain resets the workspace before it runs.
+ If an allocation does not fit, an additional block is added; on the next reset all blocks
+ are merged into one, thus after the first call no memory is allocated for data of the same size.
+ */
+#define SCIL_WORKSPACE_ALIGNMENT 64
+
+typedef struct scil_workspace scilI_workspace_t;
+
+scilI_workspace_t* scilI_workspace_create();
+
+void scilI_workspace_destroy(scilI_workspace_t* ws);
+
+/**
+ * \brief Returns a buffer of size bytes aligned to SCIL_WORKSPACE_ALIGNMENT, valid until the next reset.
+ */
+void* scilI_workspace_alloc(scilI_workspace_t* ws, size_t size);
+
+/**
+ * \brief Releases all allocations of the workspace, the memory is kept for reuse.
+ */
+void scilI_workspace_reset(scilI_workspace_t* ws);
+
+/**
+ * \brief Resets the workspace and ensures that allocations of size bytes in total fit without growing.
+ */
+void scilI_workspace_reserve(scilI_workspace_t* ws, size_t size);
+
+/**
+ * \brief Returns the number of bytes the workspace holds.
+ */
+size_t scilI_workspace_capacity(const scilI_workspace_t* ws);
+
+/**
+ * \brief Returns the number of bytes allocated since the last reset.
+ */
+size_t scilI_workspace_used(const scilI_workspace_t* ws);
+
+/**
+ * \brief Returns the workspace of the calling thread, it is used by the decompressors which have no context.
+ * The workspace is released when the thread terminates.
+ */
+scilI_workspace_t* scilI_thread_workspace();
+
+#endif // SCIL_WORKSPACE_H
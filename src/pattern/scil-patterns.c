@@ -16,6 +16,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include <math.h>
+#include <pthread.h>
 
 #include <scil-patterns.h>
 #include <scil-pattern-internal.h>
@@ -61,17 +62,8 @@ static int library_capacity = 100;
 
 int scilPa_get_available_patterns_count()
 {
-    static int count = -1;
-
-    if (count != -1)
-        return count;
-
-    for(count = 0; ; count++){
-        if(patterns[count] == NULL){
-            break;
-        }
-    }
-    return count;
+    // the array is terminated by NULL
+    return (int) (sizeof(patterns) / sizeof(*patterns)) - 1;
 }
 
 char* scilPa_get_pattern_name(int index)
@@ -126,12 +118,9 @@ static void library_add(char * pattern, char * name, float mn, float mx, float a
   library_size++;
 }
 
-static void create_library_patterns_if_needed(){
-  static int initialized = 0;
-  if (initialized){
-    return;
-  }
-  initialized = 1;
+static pthread_once_t library_once = PTHREAD_ONCE_INIT;
+
+static void create_library_patterns(){
   library = malloc(sizeof(library_pattern) * library_capacity);
 
   library_add("random", "randomRep10-100", 1, 100, -1, 0,     1, scilPa_repeater, 10.0);
@@ -164,12 +153,12 @@ static void create_library_patterns_if_needed(){
 }
 
 int scilPa_get_pattern_library_size(){
-  create_library_patterns_if_needed();
+  pthread_once(& library_once, create_library_patterns);
   return library_size;
 }
 
 char * scilPa_get_library_pattern_name(int p){
-  create_library_patterns_if_needed();
+  pthread_once(& library_once, create_library_patterns);
   assert( p <= library_size && p >= 0);
 
   return library[p].name;
@@ -256,7 +245,7 @@ int scilPa_create_library_pattern(void * buffer, SCIL_Datatype_t datatype, const
     data = (double*) buffer;
   }
 
-  create_library_patterns_if_needed();
+  pthread_once(& library_once, create_library_patterns);
   assert(pattern_index <= library_size && pattern_index >= 0);
   library_pattern* l = &library[pattern_index];
   int ret;
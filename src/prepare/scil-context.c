@@ -2,24 +2,31 @@
 
 #include <scil-compressors.h>
 #include <scil-algo-chooser.h>
+#include <scil-algo-learning.h>
+#include <scil-decision-cache.h>
+#include <scil-chooser-model.h>
+#include <scil-async.h>
 #include <scil-chain.h>
+#include <scil-chain-execution.h>
 #include <scil-hardware-limits.h>
 #include <scil-util.h>
 #include <scil-internal.h>
+#include <scil-workspace.h>
+#include <scil-data-stats.h>
+#include <scil-stats.h>
+#include <scil-trace.h>
 
 #include <assert.h>
 #include <float.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 
-static int initialized = 0;
+static pthread_once_t initialize_once = PTHREAD_ONCE_INIT;
 
+// runs once per process, contexts may be created concurrently
 static void initialize()
 {
-    if (initialized) {
-        return;
-    }
-
     // verify correctness of algo_array
     int i = 0;
     for (scilI_algorithm_t **algo = algo_array; *algo != NULL;
@@ -36,7 +43,9 @@ static void initialize()
 
     scilI_initialize_hardware_limits();
     scilC_algo_chooser_initialize();
-    initialized = 1;
+    scilC_learning_initialize();
+    scilC_decision_cache_initialize();
+    scilC_chooser_model_initialize();
 }
 
 static int check_compress_lossless_needed(scil_context_t* ctx)
@@ -70,8 +79,13 @@ int scilPr_create_context(scil_context_t** out_ctx,
                           int special_values_count,
                           void* special_values,
                           const scil_user_hints_t* hints){
-  initialize();
+  pthread_once(&initialize_once, initialize);
 
+  scil_timer timer;
+  const int trace = scilU_trace_enabled();
+  if (trace) {
+      scilU_start_timer(&timer);
+  }
   int ret = SCIL_NO_ERR;
   scil_context_t* ctx;
   *out_ctx = NULL;
@@ -80,8 +94,12 @@ int scilPr_create_context(scil_context_t** out_ctx,
   memset(ctx, 0, sizeof(scil_context_t));
 
   ctx->pipeline_params = scilI_dict_create(30);
+  ctx->workspace = scilI_workspace_create();
+  ctx->stats = (scilI_data_stats_t*)SAFE_CALLOC(1, sizeof(scilI_data_stats_t));
 
   ctx->datatype = datatype;
+  ctx->block_size = 0;
+  ctx->sample_size = SCIL_DEFAULT_SAMPLE_SIZE;
 	ctx->special_values_count = special_values_count;
 	if (ctx->special_values_count > 0){
 		assert(special_values != NULL);
@@ -160,21 +178,111 @@ int scilPr_create_context(scil_context_t** out_ctx,
     if (ret == SCIL_NO_ERR) {
         *out_ctx = ctx;
     } else {
+        scilI_dict_destroy(ctx->pipeline_params);
+        scilI_workspace_destroy(ctx->workspace);
+        free(ctx->stats);
         free(ctx);
     }
+    if (trace) {
+        scilU_trace_span("create_context", "context", timer, 0, 0);
+    }
 
     return ret;
 }
 
 int scilPr_destroy_context(scil_context_t* out_ctx)
 {
+    scilC_async_context_destroy(out_ctx);
     free(out_ctx->hints.force_compression_methods);
+    free(out_ctx->variable_id);
+    scilI_dict_destroy(out_ctx->pipeline_params);
+    scilI_workspace_destroy(out_ctx->workspace);
+    free(out_ctx->stats);
+    free(out_ctx->call_stats);
     free(out_ctx);
     out_ctx = NULL;
 
     return SCIL_NO_ERR;
 }
 
+int scilPr_clone_context(scil_context_t** out_ctx, const scil_context_t* ctx)
+{
+    scil_context_t* clone = (scil_context_t*)SAFE_MALLOC(sizeof(scil_context_t));
+    *clone = *ctx;
+
+    clone->pipeline_params = scilI_dict_create(30);
+    clone->workspace       = scilI_workspace_create();
+    clone->stats           = (scilI_data_stats_t*)SAFE_CALLOC(1, sizeof(scilI_data_stats_t));
+    clone->async           = NULL;
+    // the caller merges the statistics of a clone, e.g., of the workers of tiled compression
+    clone->call_stats      = NULL;
+    if (ctx->call_stats != NULL) {
+        scilPr_set_stats(clone, 1);
+    }
+    if (ctx->hints.force_compression_methods != NULL) {
+        clone->hints.force_compression_methods = strdup(ctx->hints.force_compression_methods);
+    }
+    if (ctx->variable_id != NULL) {
+        clone->variable_id = strdup(ctx->variable_id);
+    }
+
+    *out_ctx = clone;
+    return SCIL_NO_ERR;
+}
+
+int scilPr_reserve_workspace(scil_context_t* ctx, const scil_dims_t* dims)
+{
+    scilI_workspace_reserve(ctx->workspace, scilC_compress_workspace_size(ctx, dims));
+    return SCIL_NO_ERR;
+}
+
+int scilPr_set_tiling(scil_context_t* ctx, const scil_dims_t* tile_dims, int thread_count)
+{
+    if (tile_dims == NULL) {
+        memset(&ctx->tile_dims, 0, sizeof(scil_dims_t));
+        ctx->tile_threads = 0;
+        return SCIL_NO_ERR;
+    }
+    if (tile_dims->dims == 0 || tile_dims->dims > SCIL_DIMS_MAX || thread_count < 0) {
+        return SCIL_EINVAL;
+    }
+    scilPr_copy_dims(&ctx->tile_dims, tile_dims);
+    ctx->tile_threads = thread_count;
+    return SCIL_NO_ERR;
+}
+
+int scilPr_set_block_size(scil_context_t* ctx, size_t block_size)
+{
+    ctx->block_size = block_size;
+    return SCIL_NO_ERR;
+}
+
+int scilPr_set_sample_size(scil_context_t* ctx, size_t sample_size)
+{
+    ctx->sample_size = sample_size;
+    return SCIL_NO_ERR;
+}
+
+int scilPr_set_stats(scil_context_t* ctx, int enabled)
+{
+    free(ctx->call_stats);
+    ctx->call_stats = NULL;
+    if (enabled) {
+        ctx->call_stats = (struct scil_context_stats*)SAFE_CALLOC(1, sizeof(struct scil_context_stats));
+    }
+    return SCIL_NO_ERR;
+}
+
+int scilPr_set_variable_id(scil_context_t* ctx, const char* id)
+{
+    if (id != NULL && strchr(id, '\n') != NULL) {
+        return SCIL_EINVAL;
+    }
+    free(ctx->variable_id);
+    ctx->variable_id = id != NULL ? strdup(id) : NULL;
+    return SCIL_NO_ERR;
+}
+
 scil_user_hints_t scilPr_get_effective_hints(const scil_context_t* ctx)
 {
     return ctx->hints;
@@ -20,6 +20,72 @@ int scilPr_create_context(scil_context_t** out_ctx,
 
 int scilPr_destroy_context(scil_context_t* out_ctx);
 
+/**
+ * \brief Creates an independent copy of a context, e.g., to use it concurrently in another thread.
+ * The copy shares the special values but not the pipeline internal parameters.
+ */
+int scilPr_clone_context(scil_context_t** out_ctx, const scil_context_t* ctx);
+
+/**
+ * \brief Enable tiled compression: the data is split into hyperslabs that are compressed independently in parallel.
+ * The compressed tiles are stored in a container with an offset table, the result does not depend on thread_count.
+ * \param tile_dims the extent of a tile, a length of 0 and missing dimensions cover the whole dimension, NULL disables tiling
+ * \param thread_count number of threads to use, 0 uses the number of available processors
+ * \return SCIL_NO_ERR or SCIL_EINVAL if the tile does not fit the supported dimensions
+ */
+int scilPr_set_tiling(scil_context_t* ctx, const scil_dims_t* tile_dims, int thread_count);
+
+/*
+ A block size that keeps the intermediate data of a chain in the cache, for use with scilPr_set_block_size().
+ The size is fixed instead of derived from the cache of the machine, thus the compressed data does not depend
+ on the machine it is created on. Blocking is off by default: the blocks are stored in the tiled container,
+ which changes the format, the ratio and scil_compress_bound() compared to the plain chain.
+ */
+#define SCIL_RECOMMENDED_BLOCK_SIZE (128 * 1024)
+
+/**
+ * \brief Sets the size of the blocks for the cache-blocked execution of the chain.
+ * The blocks are stored in the same container as tiles, tiling set by scilPr_set_tiling() takes precedence.
+ * Chains with a single stage or an algorithm that needs the whole array are not executed in blocks.
+ * \param block_size the input bytes per block, 0 (the default) processes the whole array by one stage after another
+ */
+int scilPr_set_block_size(scil_context_t* ctx, size_t block_size);
+
+/*
+ The automatic selection of the chain examines this many bytes taken from blocks spread over the whole array.
+ */
+#define SCIL_DEFAULT_SAMPLE_SIZE (64 * 1024)
+
+/**
+ * \brief Sets the amount of data the automatic selection of the chain examines.
+ * \param sample_size the bytes of all examined blocks together, 0 examines the whole array
+ */
+int scilPr_set_sample_size(scil_context_t* ctx, size_t sample_size);
+
+/**
+ * \brief Names the variable compressed with the context, e.g., "temperature".
+ * The chain the automatic selection picks for the variable is cached across contexts, together with the datatype,
+ * dimensions and hints. A new context for the same variable reuses the decision without examining the data,
+ * every SCIL_DECISION_CACHE_REVALIDATE-th reuse samples the data again to detect a drift.
+ * Set SCIL_DECISION_CACHE_FILE to keep the decisions across runs.
+ * \param id the name of the variable, it must not contain a newline; NULL disables the cache for the context
+ */
+int scilPr_set_variable_id(scil_context_t* ctx, const char* id);
+
+/**
+ * \brief Pre-sizes the scratch memory of the context for compressing data of the given dimensions.
+ * The scratch memory grows on demand and is reused across calls, reserving it avoids allocations in the first call.
+ * Call it after forcing a chain or after the first compression, otherwise the intermediate buffers of the chain are unknown.
+ */
+int scilPr_reserve_workspace(scil_context_t* ctx, const scil_dims_t* dims);
+
+/**
+ * \brief Enables or disables the recording of statistics by scil_compress() with the context, see scil_get_last_stats().
+ * For each stage of the chain, the time, the input and output bytes are recorded. Enabling the statistics clears them,
+ * while they are disabled, the compression is not slowed down.
+ */
+int scilPr_set_stats(scil_context_t* ctx, int enabled);
+
 scil_user_hints_t scilPr_get_effective_hints(const scil_context_t* ctx);
 
 #endif // SCIL_CONTEXT_H
@@ -0,0 +1,335 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <scil-data-stats.h>
+
+#include <scil-util.h>
+
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCIL_STATS_X86
+#include <immintrin.h>
+#endif
+
+#define MINIMUM_int8_t INT8_MIN
+#define MAXIMUM_int8_t INT8_MAX
+#define MINIMUM_int16_t INT16_MIN
+#define MAXIMUM_int16_t INT16_MAX
+#define MINIMUM_int32_t INT32_MIN
+#define MAXIMUM_int32_t INT32_MAX
+#define MINIMUM_int64_t INT64_MIN
+#define MAXIMUM_int64_t INT64_MAX
+
+#define EXPONENT_MAX_float 0xff
+#define EXPONENT_MAX_double 0x7ff
+
+static void initialize_stats(scilI_data_stats_t* stats, SCIL_Datatype_t datatype, size_t count)
+{
+  stats->datatype = datatype;
+  stats->count = count;
+  stats->minimum = INFINITY;
+  stats->maximum = -INFINITY;
+  stats->minimum_int = INT64_MAX;
+  stats->maximum_int = INT64_MIN;
+  stats->minimum_sign = 1;
+  stats->maximum_sign = 0;
+  stats->minimum_exponent = 0x7fff;
+  stats->maximum_exponent = -0x7fff;
+  stats->nan_count = 0;
+  stats->inf_count = 0;
+  stats->data = NULL;
+}
+
+#ifdef SCIL_STATS_X86
+
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+static int avx2_available = 0;
+
+static void detect_avx2()
+{
+  __builtin_cpu_init();
+  avx2_available = __builtin_cpu_supports("avx2");
+}
+
+static int avx2_supported()
+{
+  pthread_once(&detect_once, detect_avx2);
+  return avx2_available;
+}
+
+// Processes a multiple of the vector width and merges the result into stats, returns the number of values processed
+__attribute__((target("avx2")))
+static size_t stats_avx2_double(const double* restrict buffer, size_t count, scilI_data_stats_t* stats)
+{
+  const __m256i exponent_mask = _mm256_set1_epi64x(EXPONENT_MAX_double);
+  const __m256i mantissa_mask = _mm256_set1_epi64x((INT64_C(1) << MANTISSA_LENGTH_DOUBLE) - 1);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256d min = _mm256_set1_pd(INFINITY);
+  __m256d max = _mm256_set1_pd(-INFINITY);
+  __m256i emin = _mm256_set1_epi64x(0x7fff);
+  __m256i emax = _mm256_set1_epi64x(-0x7fff);
+  __m256i sign_or = zero;
+  __m256i sign_and = _mm256_set1_epi64x(-1);
+  __m256i nans = zero;
+  __m256i infs = zero;
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256d v = _mm256_loadu_pd(buffer + i);
+    const __m256i bits = _mm256_castpd_si256(v);
+    // (v < min) ? v : min, thus NaN values are ignored
+    min = _mm256_min_pd(v, min);
+    max = _mm256_max_pd(v, max);
+    sign_or = _mm256_or_si256(sign_or, bits);
+    sign_and = _mm256_and_si256(sign_and, bits);
+
+    const __m256i e = _mm256_and_si256(_mm256_srli_epi64(bits, MANTISSA_LENGTH_DOUBLE), exponent_mask);
+    emin = _mm256_blendv_epi8(emin, e, _mm256_cmpgt_epi64(emin, e));
+    emax = _mm256_blendv_epi8(emax, e, _mm256_cmpgt_epi64(e, emax));
+
+    // all bits of the exponent set: infinity if the mantissa is 0, NaN otherwise
+    const __m256i special = _mm256_cmpeq_epi64(e, exponent_mask);
+    const __m256i mantissa_zero = _mm256_cmpeq_epi64(_mm256_and_si256(bits, mantissa_mask), zero);
+    infs = _mm256_sub_epi64(infs, _mm256_and_si256(special, mantissa_zero));
+    nans = _mm256_sub_epi64(nans, _mm256_andnot_si256(mantissa_zero, special));
+  }
+
+  double mins[4], maxs[4];
+  int64_t emins[4], emaxs[4], ors[4], ands[4], nan_counts[4], inf_counts[4];
+  _mm256_storeu_pd(mins, min);
+  _mm256_storeu_pd(maxs, max);
+  _mm256_storeu_si256((__m256i*) emins, emin);
+  _mm256_storeu_si256((__m256i*) emaxs, emax);
+  _mm256_storeu_si256((__m256i*) ors, sign_or);
+  _mm256_storeu_si256((__m256i*) ands, sign_and);
+  _mm256_storeu_si256((__m256i*) nan_counts, nans);
+  _mm256_storeu_si256((__m256i*) inf_counts, infs);
+  for (int k = 0; k < 4; k++) {
+    if (mins[k] < stats->minimum) stats->minimum = mins[k];
+    if (maxs[k] > stats->maximum) stats->maximum = maxs[k];
+    if (emins[k] < stats->minimum_exponent) stats->minimum_exponent = (int16_t) emins[k];
+    if (emaxs[k] > stats->maximum_exponent) stats->maximum_exponent = (int16_t) emaxs[k];
+    if (ors[k] < 0) stats->maximum_sign = 1;
+    if (ands[k] >= 0) stats->minimum_sign = 0;
+    stats->nan_count += nan_counts[k];
+    stats->inf_count += inf_counts[k];
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+static size_t stats_avx2_float(const float* restrict buffer, size_t count, scilI_data_stats_t* stats)
+{
+  const __m256i exponent_mask = _mm256_set1_epi32(EXPONENT_MAX_float);
+  const __m256i mantissa_mask = _mm256_set1_epi32((1 << MANTISSA_LENGTH_FLOAT) - 1);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256 min = _mm256_set1_ps(INFINITY);
+  __m256 max = _mm256_set1_ps(-INFINITY);
+  __m256i emin = _mm256_set1_epi32(0x7fff);
+  __m256i emax = _mm256_set1_epi32(-0x7fff);
+  __m256i sign_or = zero;
+  __m256i sign_and = _mm256_set1_epi32(-1);
+  __m256i nans = zero;
+  __m256i infs = zero;
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 v = _mm256_loadu_ps(buffer + i);
+    const __m256i bits = _mm256_castps_si256(v);
+    min = _mm256_min_ps(v, min);
+    max = _mm256_max_ps(v, max);
+    sign_or = _mm256_or_si256(sign_or, bits);
+    sign_and = _mm256_and_si256(sign_and, bits);
+
+    const __m256i e = _mm256_and_si256(_mm256_srli_epi32(bits, MANTISSA_LENGTH_FLOAT), exponent_mask);
+    emin = _mm256_min_epi32(emin, e);
+    emax = _mm256_max_epi32(emax, e);
+
+    const __m256i special = _mm256_cmpeq_epi32(e, exponent_mask);
+    const __m256i mantissa_zero = _mm256_cmpeq_epi32(_mm256_and_si256(bits, mantissa_mask), zero);
+    infs = _mm256_sub_epi32(infs, _mm256_and_si256(special, mantissa_zero));
+    nans = _mm256_sub_epi32(nans, _mm256_andnot_si256(mantissa_zero, special));
+    // flush the 32 bit counters before they could overflow
+    if ((i & ((UINT64_C(1) << 30) - 1)) == 0) {
+      uint32_t nan_counts[8], inf_counts[8];
+      _mm256_storeu_si256((__m256i*) nan_counts, nans);
+      _mm256_storeu_si256((__m256i*) inf_counts, infs);
+      for (int k = 0; k < 8; k++) {
+        stats->nan_count += nan_counts[k];
+        stats->inf_count += inf_counts[k];
+      }
+      nans = zero;
+      infs = zero;
+    }
+  }
+
+  float mins[8], maxs[8];
+  int32_t emins[8], emaxs[8], ors[8], ands[8];
+  uint32_t nan_counts[8], inf_counts[8];
+  _mm256_storeu_ps(mins, min);
+  _mm256_storeu_ps(maxs, max);
+  _mm256_storeu_si256((__m256i*) emins, emin);
+  _mm256_storeu_si256((__m256i*) emaxs, emax);
+  _mm256_storeu_si256((__m256i*) ors, sign_or);
+  _mm256_storeu_si256((__m256i*) ands, sign_and);
+  _mm256_storeu_si256((__m256i*) nan_counts, nans);
+  _mm256_storeu_si256((__m256i*) inf_counts, infs);
+  for (int k = 0; k < 8; k++) {
+    if ((double) mins[k] < stats->minimum) stats->minimum = (double) mins[k];
+    if ((double) maxs[k] > stats->maximum) stats->maximum = (double) maxs[k];
+    if (emins[k] < stats->minimum_exponent) stats->minimum_exponent = (int16_t) emins[k];
+    if (emaxs[k] > stats->maximum_exponent) stats->maximum_exponent = (int16_t) emaxs[k];
+    if (ors[k] < 0) stats->maximum_sign = 1;
+    if (ands[k] >= 0) stats->minimum_sign = 0;
+    stats->nan_count += nan_counts[k];
+    stats->inf_count += inf_counts[k];
+  }
+  return i;
+}
+
+#define STATS_VECTOR_float(buffer, count, stats) (avx2_supported() ? stats_avx2_float(buffer, count, stats) : 0)
+#define STATS_VECTOR_double(buffer, count, stats) (avx2_supported() ? stats_avx2_double(buffer, count, stats) : 0)
+
+#else
+
+#define STATS_VECTOR_float(buffer, count, stats) 0
+#define STATS_VECTOR_double(buffer, count, stats) 0
+
+#endif // SCIL_STATS_X86
+
+//Supported datatypes: float double
+// Repeat for each data type
+
+// merges the statistics of the values into stats
+static void stats_scalar_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, scilI_data_stats_t* stats)
+{
+  <DATATYPE> min = (<DATATYPE>) stats->minimum;
+  <DATATYPE> max = (<DATATYPE>) stats->maximum;
+  for (size_t i = 0; i < count; ++i) {
+    datatype_cast_<DATATYPE> cur;
+    cur.f = buffer[i];
+
+    if (cur.f < min) { min = cur.f; }
+    if (cur.f > max) { max = cur.f; }
+
+    if (cur.p.sign < stats->minimum_sign) { stats->minimum_sign = cur.p.sign; }
+    if (cur.p.sign > stats->maximum_sign) { stats->maximum_sign = cur.p.sign; }
+    if (cur.p.exponent < stats->minimum_exponent) { stats->minimum_exponent = cur.p.exponent; }
+    if (cur.p.exponent > stats->maximum_exponent) { stats->maximum_exponent = cur.p.exponent; }
+
+    if (cur.p.exponent == EXPONENT_MAX_<DATATYPE>) {
+      if (cur.p.mantissa == 0) {
+        stats->inf_count++;
+      } else {
+        stats->nan_count++;
+      }
+    }
+  }
+  stats->minimum = (double) min;
+  stats->maximum = (double) max;
+}
+
+void scilI_data_stats_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, scilI_data_stats_t* stats)
+{
+  assert(buffer != NULL || count == 0);
+  initialize_stats(stats, SCIL_TYPE_<DATATYPE_UPPER>, count);
+  const size_t done = STATS_VECTOR_<DATATYPE>(buffer, count, stats);
+  stats_scalar_<DATATYPE>(buffer + done, count - done, stats);
+}
+
+void scilI_data_stats_minmax_<DATATYPE>(const scilI_data_stats_t* stats, <DATATYPE>* minimum, <DATATYPE>* maximum)
+{
+  *minimum = (<DATATYPE>) stats->minimum;
+  *maximum = (<DATATYPE>) stats->maximum;
+}
+// End repeat
+
+//Supported datatypes: int8_t int16_t int32_t int64_t
+// Repeat for each data type
+
+void scilI_data_stats_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, scilI_data_stats_t* stats)
+{
+  assert(buffer != NULL || count == 0);
+  initialize_stats(stats, SCIL_TYPE_<DATATYPE_UPPER>, count);
+
+  // without branches the compiler vectorizes the loop
+  <DATATYPE> min = MAXIMUM_<DATATYPE>;
+  <DATATYPE> max = MINIMUM_<DATATYPE>;
+  for (size_t i = 0; i < count; ++i) {
+    min = buffer[i] < min ? buffer[i] : min;
+    max = buffer[i] > max ? buffer[i] : max;
+  }
+  stats->minimum_int = min;
+  stats->maximum_int = max;
+  stats->minimum = (double) min;
+  stats->maximum = (double) max;
+  if (count > 0) {
+    stats->minimum_sign = max < 0;
+    stats->maximum_sign = min < 0;
+  }
+}
+
+void scilI_data_stats_minmax_<DATATYPE>(const scilI_data_stats_t* stats, <DATATYPE>* minimum, <DATATYPE>* maximum)
+{
+  *minimum = (<DATATYPE>) stats->minimum_int;
+  *maximum = (<DATATYPE>) stats->maximum_int;
+}
+// End repeat
+
+void scilI_data_stats_compute(SCIL_Datatype_t datatype, const void* data, size_t count, scilI_data_stats_t* stats)
+{
+  switch (datatype) {
+  case (SCIL_TYPE_FLOAT):
+    scilI_data_stats_float((const float*) data, count, stats);
+    break;
+  case (SCIL_TYPE_DOUBLE):
+    scilI_data_stats_double((const double*) data, count, stats);
+    break;
+  case (SCIL_TYPE_INT8):
+    scilI_data_stats_int8_t((const int8_t*) data, count, stats);
+    break;
+  case (SCIL_TYPE_INT16):
+    scilI_data_stats_int16_t((const int16_t*) data, count, stats);
+    break;
+  case (SCIL_TYPE_INT32):
+    scilI_data_stats_int32_t((const int32_t*) data, count, stats);
+    break;
+  case (SCIL_TYPE_INT64):
+    scilI_data_stats_int64_t((const int64_t*) data, count, stats);
+    break;
+  case (SCIL_TYPE_UNKNOWN):
+  case (SCIL_TYPE_BINARY):
+  case (SCIL_TYPE_STRING):
+    assert(0 && "unsupported datatype for statistics");
+  }
+}
+
+const scilI_data_stats_t* scilI_context_data_stats(const scil_context_t* ctx, const void* data, size_t count)
+{
+  scilI_data_stats_t* stats = ctx->stats;
+  if (stats->data != data || stats->count != count || stats->datatype != ctx->datatype) {
+    scilI_data_stats_compute(ctx->datatype, data, count, stats);
+    stats->data = data;
+  }
+  return stats;
+}
+
+void scilI_context_data_stats_invalidate(scil_context_t* ctx)
+{
+  ctx->stats->data = NULL;
+}
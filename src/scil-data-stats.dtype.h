@@ -0,0 +1,85 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCIL_DATA_STATS_H
+#define SCIL_DATA_STATS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <scil-cca.h>
+
+/*
+ Statistics of a data buffer gathered in a single pass, they replace the separate scans
+ for the minimum/maximum and the sign/exponent ranges the algorithms did before.
+ */
+typedef struct scil_data_stats {
+  SCIL_Datatype_t datatype;
+  size_t count;
+
+  // NaN values are ignored, integer data is stored exactly in the _int fields
+  double minimum;
+  double maximum;
+  int64_t minimum_int;
+  int64_t maximum_int;
+
+  // floating point data only, the range of the sign bits and biased exponents of all values
+  uint8_t minimum_sign;
+  uint8_t maximum_sign;
+  int16_t minimum_exponent;
+  int16_t maximum_exponent;
+
+  size_t nan_count;
+  size_t inf_count;
+
+  // the buffer the cached statistics of a context belong to
+  const void* data;
+} scilI_data_stats_t;
+
+/**
+ * \brief Computes the statistics of count values of the given datatype.
+ */
+void scilI_data_stats_compute(SCIL_Datatype_t datatype, const void* data, size_t count, scilI_data_stats_t* stats);
+
+/**
+ * \brief Returns the statistics of the data, they are computed on the first request and cached in the context.
+ * The cache is dropped when the context compresses the next buffer, thus all stages and the algorithm chooser
+ * share one scan of the input.
+ */
+const scilI_data_stats_t* scilI_context_data_stats(const scil_context_t* ctx, const void* data, size_t count);
+
+/**
+ * \brief Drops the cached statistics, needed whenever the content behind a buffer may change.
+ */
+void scilI_context_data_stats_invalidate(scil_context_t* ctx);
+
+//Supported datatypes: int8_t int16_t int32_t int64_t float double
+// Repeat for each data type
+/**
+ * \brief Computes the statistics of the buffer.
+ * \param buffer The buffer to scan
+ * \param count Element count of the buffer
+ * \param stats The statistics
+ * \pre buffer != NULL || count == 0
+ */
+void scilI_data_stats_<DATATYPE>(const <DATATYPE>* restrict buffer, size_t count, scilI_data_stats_t* stats);
+
+/**
+ * \brief Returns the minimum and maximum of the statistics in the datatype of the data.
+ */
+void scilI_data_stats_minmax_<DATATYPE>(const scilI_data_stats_t* stats, <DATATYPE>* minimum, <DATATYPE>* maximum);
+// End repeat
+
+#endif // SCIL_DATA_STATS_H
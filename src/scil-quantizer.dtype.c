@@ -1,5 +1,7 @@
 #include <scil-quantizer.h>
+#include <scil-data-stats.h>
 #include <scil-error.h>
+#include <scil-swager.h>
 
 #include <assert.h>
 #include <math.h>
@@ -76,16 +78,9 @@ void scil_find_minimum_maximum_<DATATYPE>(const <DATATYPE>* restrict buffer,
     assert(minimum != NULL);
     assert(maximum != NULL);
 
-    <DATATYPE> min = INFINITY_<DATATYPE>;
-    <DATATYPE> max = NINFINITY_<DATATYPE>;
-
-    for(size_t i = 0; i < count; ++i){
-        if (buffer[i] < min) { min = buffer[i]; }
-        if (buffer[i] > max) { max = buffer[i]; }
-    }
-
-    *minimum = min;
-    *maximum = max;
+    scilI_data_stats_t stats;
+    scilI_data_stats_<DATATYPE>(buffer, count, &stats);
+    scilI_data_stats_minmax_<DATATYPE>(&stats, minimum, maximum);
 }
 
 void scilU_subtract_data_<DATATYPE>(const <DATATYPE>* restrict in, <DATATYPE>* restrict inout, size_t count){
@@ -112,13 +107,17 @@ int scil_quantize_buffer_minmax_<DATATYPE>(uint64_t* restrict dest,
     assert(dest != NULL);
     assert(source != NULL);
 
-    if(scil_calculate_bits_needed_<DATATYPE>(minimum, maximum, absolute_tolerance) > 53){
+    const uint64_t bits_needed = scil_calculate_bits_needed_<DATATYPE>(minimum, maximum, absolute_tolerance);
+    if(bits_needed > 53){
         return SCIL_EINVAL; // Quantizing would result in values bigger than UINT64_MAX
     }
     double real_tolerance = (1 / 1.0) / absolute_tolerance;
+    // like scil_quantize_pack(), the values fit into the bits needed even if the maximum rounds up
+    const uint64_t largest = (UINT64_C(1) << bits_needed) - 1;
 
     for(size_t i = 0; i < count; ++i){
-        dest[i] = scil_quantize_value_<DATATYPE>(source[i], real_tolerance, minimum);
+        const uint64_t value = scil_quantize_value_<DATATYPE>(source[i], real_tolerance, minimum);
+        dest[i] = value > largest ? largest : value;
     }
 
     return SCIL_NO_ERR;
@@ -142,6 +141,57 @@ int scil_unquantize_buffer_<DATATYPE>(<DATATYPE>* restrict dest,
     return 0;
 }
 
+int scil_quantize_pack_<DATATYPE>(byte* restrict dest,
+                                  const <DATATYPE>* restrict source,
+                                  size_t count,
+                                  double absolute_tolerance,
+                                  <DATATYPE> minimum,
+                                  uint8_t bits_per_value){
+
+    assert(dest != NULL);
+    assert(source != NULL);
+
+    if(bits_per_value > 53){
+        return SCIL_EINVAL; // Quantizing would result in values bigger than UINT64_MAX
+    }
+    const double real_tolerance = (1 / 1.0) / absolute_tolerance;
+    // rounding may exceed the largest value for the maximum of the data
+    const uint64_t largest = (UINT64_C(1) << bits_per_value) - 1;
+
+    scil_bit_writer_t writer;
+    scil_bit_writer_init(&writer, dest);
+    for(size_t i = 0; i < count; ++i){
+        uint64_t value = scil_quantize_value_<DATATYPE>(source[i], real_tolerance, minimum);
+        scil_bit_writer_put(&writer, value > largest ? largest : value, bits_per_value);
+    }
+    scil_bit_writer_flush(&writer);
+
+    return SCIL_NO_ERR;
+}
+
+int scil_unpack_unquantize_<DATATYPE>(<DATATYPE>* restrict dest,
+                                      const byte* restrict source,
+                                      size_t count,
+                                      double absolute_tolerance,
+                                      <DATATYPE> minimum,
+                                      uint8_t bits_per_value){
+
+    assert(dest != NULL);
+    assert(source != NULL);
+
+    if(bits_per_value > 64){
+        return SCIL_EINVAL;
+    }
+
+    scil_bit_reader_t reader;
+    scil_bit_reader_init(&reader, source, (count * bits_per_value + 7) / 8);
+    for(size_t i = 0; i < count; ++i){
+        dest[i] = scil_unquantize_value_<DATATYPE>(scil_bit_reader_get(&reader, bits_per_value), absolute_tolerance, minimum);
+    }
+
+    return SCIL_NO_ERR;
+}
+
 int scil_quantize_buffer_<DATATYPE>(uint64_t* restrict dest,
                                     const <DATATYPE>* restrict source,
                                     size_t count,
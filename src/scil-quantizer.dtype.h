@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <scil-datatypes.h>
+
 //Supported datatypes: int8_t int16_t int32_t int64_t float double
 // Repeat for each data type
 /**
@@ -65,6 +67,7 @@ uint64_t scil_calculate_bits_needed_<DATATYPE>(<DATATYPE> minimum,
 /**
  * \brief Quantizes the values of the given buffer with a known minimum
  *        and maximum value.
+ * A value that rounds beyond the bits needed for the range is clamped to the largest value of these bits.
  * \param buf_in The Buffer containing the data to quantize
  * \param buf_out The Buffer which will hold the quantized data.
  * \param count Number of elements in the buffer
@@ -115,6 +118,32 @@ int scil_unquantize_buffer_<DATATYPE>(<DATATYPE>* restrict buf_out,
                                       double absolute_tolerance,
                                       <DATATYPE> minimum);
 
+/**
+ * \brief Quantizes the values and packs them with bits_per_value bits each in a single pass.
+ * The result is the same as scil_quantize_buffer_minmax() followed by scil_swage() without the intermediate buffer,
+ * if bits_per_value are the bits needed for minimum and maximum; both clamp a value that rounds beyond them.
+ * \param buf_out The buffer which will hold the packed data, (count * bits_per_value + 7) / 8 bytes are written
+ * \param minimum The minimum of the data
+ * \param bits_per_value The bits needed for the data, see scil_calculate_bits_needed()
+ * \return SCIL_NO_ERR or SCIL_EINVAL if more than 53 bits are needed
+ */
+int scil_quantize_pack_<DATATYPE>(byte* restrict buf_out,
+                                  const <DATATYPE>* restrict buf_in,
+                                  size_t count,
+                                  double absolute_tolerance,
+                                  <DATATYPE> minimum,
+                                  uint8_t bits_per_value);
+
+/**
+ * \brief Unpacks and unquantizes the data created by scil_quantize_pack() in a single pass.
+ */
+int scil_unpack_unquantize_<DATATYPE>(<DATATYPE>* restrict buf_out,
+                                      const byte* restrict buf_in,
+                                      size_t count,
+                                      double absolute_tolerance,
+                                      <DATATYPE> minimum,
+                                      uint8_t bits_per_value);
+
 // End repeat
 
 #endif /* SCIL_QUANTIZER_H_<DATATYPE> */
@@ -1,39 +1,199 @@
 #include <scil-swager.h>
 
-static uint8_t start_mask[9] = {
-    255, //0b11111111
-    127, //0b01111111
-    63,  //0b00111111
-    31,  //0b00011111
-    15,  //0b00001111
-    7,   //0b00000111
-    3,   //0b00000011
-    1,   //0b00000001
-    0    //0b00000000
-};
-
-static uint8_t end_mask[9] = {
-    0,         //0b00000000
-    255 - 127, //0b10000000
-    255 - 63,  //0b11000000
-    255 - 31,  //0b11100000
-    255 - 15,  //0b11110000
-    255 - 7,   //0b11111000
-    255 - 3,   //0b11111100
-    255 - 1,   //0b11111110
-    255        //0b11111111
-};
-
-// Can do negative right shifts!! (left shifts)
-static byte right_shift_64(uint64_t value, int amount){
-    return (byte)(amount >= 0 ?
-        value >> amount :
-        value << -amount);
+#include <scil-error.h>
+
+#include <pthread.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCIL_SWAGE_X86
+#include <immintrin.h>
+#endif
+
+/*
+ The kernels pack and unpack the same format, they differ only in the instructions used.
+ The vector kernels process a prefix of the values and return the number of values processed,
+ the remainder is handled by the scalar code.
+ */
+typedef size_t (*swage_kernel_t)(scil_bit_writer_t* w, const uint64_t* buf_in, size_t count, uint8_t bits_per_value);
+typedef size_t (*unswage_kernel_t)(uint64_t* buf_out, const byte* buf_in, size_t size, size_t count, uint8_t bits_per_value);
+
+static size_t swage_none(scil_bit_writer_t* w, const uint64_t* buf_in, size_t count, uint8_t bits_per_value){
+  return 0;
+}
+
+static size_t unswage_none(uint64_t* buf_out, const byte* buf_in, size_t size, size_t count, uint8_t bits_per_value){
+  return 0;
+}
+
+#ifdef SCIL_SWAGE_X86
+
+// Combines two or four neighbouring values with vector shifts, thus the writer handles up to 64 bits at once.
+__attribute__((target("avx2")))
+static size_t swage_avx2(scil_bit_writer_t* w, const uint64_t* buf_in, size_t count, uint8_t bits_per_value){
+  if (bits_per_value == 0 || bits_per_value > 32){
+    return 0;
+  }
+  const unsigned bits = bits_per_value;
+  const __m256i mask = _mm256_set1_epi64x((INT64_C(1) << bits) - 1);
+  const __m128i shift = _mm_cvtsi32_si128(bits);
+  const __m128i shift_pair = _mm_cvtsi32_si128(2 * bits);
+
+  size_t i = 0;
+  for(; i + 8 <= count; i += 8){
+    const __m256i a = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(buf_in + i)), mask);
+    const __m256i b = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(buf_in + i + 4)), mask);
+    // lane 0: v0 << bits | v1, lane 2: v2 << bits | v3
+    const __m256i pa = _mm256_or_si256(_mm256_sll_epi64(a, shift), _mm256_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+    const __m256i pb = _mm256_or_si256(_mm256_sll_epi64(b, shift), _mm256_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2)));
+    if (bits > 16){
+      scil_bit_writer_put(w, (uint64_t) _mm256_extract_epi64(pa, 0), 2 * bits);
+      scil_bit_writer_put(w, (uint64_t) _mm256_extract_epi64(pa, 2), 2 * bits);
+      scil_bit_writer_put(w, (uint64_t) _mm256_extract_epi64(pb, 0), 2 * bits);
+      scil_bit_writer_put(w, (uint64_t) _mm256_extract_epi64(pb, 2), 2 * bits);
+      continue;
+    }
+    // lane 0: v0 << 3 bits | v1 << 2 bits | v2 << bits | v3
+    const __m256i qa = _mm256_or_si256(_mm256_sll_epi64(pa, shift_pair), _mm256_permute4x64_epi64(pa, _MM_SHUFFLE(3, 2, 3, 2)));
+    const __m256i qb = _mm256_or_si256(_mm256_sll_epi64(pb, shift_pair), _mm256_permute4x64_epi64(pb, _MM_SHUFFLE(3, 2, 3, 2)));
+    const uint64_t ca = (uint64_t) _mm256_extract_epi64(qa, 0);
+    const uint64_t cb = (uint64_t) _mm256_extract_epi64(qb, 0);
+    if (bits > 8){
+      scil_bit_writer_put(w, ca, 4 * bits);
+      scil_bit_writer_put(w, cb, 4 * bits);
+    }else{
+      scil_bit_writer_put(w, (ca << (4 * bits)) | cb, 8 * bits);
+    }
+  }
+  return i;
+}
+
+static const uint8_t byte_reverse[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+/*
+ Each lane loads the 8 bytes starting at the first byte of its value, thus values of up to 57 bits
+ can be extracted by shifting. Only values whose 8 bytes lie inside the buffer are processed.
+ */
+__attribute__((target("avx2")))
+static size_t unswage_avx2(uint64_t* buf_out, const byte* buf_in, size_t size, size_t count, uint8_t bits_per_value){
+  if (bits_per_value == 0 || bits_per_value > 57 || size < 8){
+    return 0;
+  }
+  const uint64_t bits = bits_per_value;
+  const __m256i reverse = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) byte_reverse));
+  const __m256i seven = _mm256_set1_epi64x(7);
+  const __m256i step = _mm256_set1_epi64x(4 * bits);
+  const __m128i right = _mm_cvtsi32_si128(64 - bits);
+  __m256i pos = _mm256_setr_epi64x(0, bits, 2 * bits, 3 * bits);
+
+  size_t i = 0;
+  for(; i + 4 <= count && ((i + 3) * bits) / 8 <= size - 8; i += 4){
+    __m256i v = _mm256_i64gather_epi64((const long long*) buf_in, _mm256_srli_epi64(pos, 3), 1);
+    v = _mm256_shuffle_epi8(v, reverse);
+    v = _mm256_sllv_epi64(v, _mm256_and_si256(pos, seven));
+    v = _mm256_srl_epi64(v, right);
+    _mm256_storeu_si256((__m256i*)(buf_out + i), v);
+    pos = _mm256_add_epi64(pos, step);
+  }
+  return i;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t unswage_avx512(uint64_t* buf_out, const byte* buf_in, size_t size, size_t count, uint8_t bits_per_value){
+  if (bits_per_value == 0 || bits_per_value > 57 || size < 8){
+    return 0;
+  }
+  const uint64_t bits = bits_per_value;
+  const __m512i reverse = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) byte_reverse));
+  const __m512i seven = _mm512_set1_epi64(7);
+  const __m512i step = _mm512_set1_epi64(8 * bits);
+  const __m128i right = _mm_cvtsi32_si128(64 - bits);
+  __m512i pos = _mm512_setr_epi64(0, bits, 2 * bits, 3 * bits, 4 * bits, 5 * bits, 6 * bits, 7 * bits);
+
+  size_t i = 0;
+  for(; i + 8 <= count && ((i + 7) * bits) / 8 <= size - 8; i += 8){
+    __m512i v = _mm512_i64gather_epi64(_mm512_srli_epi64(pos, 3), buf_in, 1);
+    v = _mm512_shuffle_epi8(v, reverse);
+    v = _mm512_sllv_epi64(v, _mm512_and_si512(pos, seven));
+    v = _mm512_srl_epi64(v, right);
+    _mm512_storeu_si512(buf_out + i, v);
+    pos = _mm512_add_epi64(pos, step);
+  }
+  return i;
 }
-static uint64_t right_shift_8(byte value, int amount){
-    return (amount >= 0 ?
-        ((uint64_t)value) >> amount :
-        ((uint64_t)value) << -amount);
+
+#endif // SCIL_SWAGE_X86
+
+static pthread_once_t select_once = PTHREAD_ONCE_INIT;
+static scil_swage_isa_t selected_isa = SCIL_SWAGE_SCALAR;
+static swage_kernel_t swage_kernel = swage_none;
+static unswage_kernel_t unswage_kernel = unswage_none;
+
+static int isa_supported(scil_swage_isa_t isa){
+  switch(isa){
+  case SCIL_SWAGE_SCALAR:
+    return 1;
+#ifdef SCIL_SWAGE_X86
+  case SCIL_SWAGE_AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  case SCIL_SWAGE_AVX512:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+  default:
+    return 0;
+  }
+}
+
+/*
+ The selection may change while other threads pack data. The kernels are stored atomically;
+ a thread seeing the new packing but the old unpacking kernel is fine, as all kernels produce the same format.
+ */
+static void set_kernels(scil_swage_isa_t isa){
+  swage_kernel_t swage = swage_none;
+  unswage_kernel_t unswage = unswage_none;
+  switch(isa){
+#ifdef SCIL_SWAGE_X86
+  case SCIL_SWAGE_AVX2:
+    swage = swage_avx2;
+    unswage = unswage_avx2;
+    break;
+  case SCIL_SWAGE_AVX512:
+    // packing is limited by the bit writer, wider vectors do not help there
+    swage = swage_avx2;
+    unswage = unswage_avx512;
+    break;
+#endif
+  default:
+    break;
+  }
+  __atomic_store_n(&swage_kernel, swage, __ATOMIC_RELAXED);
+  __atomic_store_n(&unswage_kernel, unswage, __ATOMIC_RELAXED);
+  __atomic_store_n(&selected_isa, isa, __ATOMIC_RELAXED);
+}
+
+static void select_kernels(){
+  if (isa_supported(SCIL_SWAGE_AVX512)){
+    set_kernels(SCIL_SWAGE_AVX512);
+  }else if (isa_supported(SCIL_SWAGE_AVX2)){
+    set_kernels(SCIL_SWAGE_AVX2);
+  }else{
+    set_kernels(SCIL_SWAGE_SCALAR);
+  }
+}
+
+scil_swage_isa_t scil_swage_get_isa(){
+  pthread_once(&select_once, select_kernels);
+  return __atomic_load_n(&selected_isa, __ATOMIC_RELAXED);
+}
+
+int scil_swage_set_isa(scil_swage_isa_t isa){
+  pthread_once(&select_once, select_kernels);
+  if (! isa_supported(isa)){
+    return SCIL_EINVAL;
+  }
+  set_kernels(isa);
+  return SCIL_NO_ERR;
 }
 
 int scil_swage(byte* restrict buf_out,
@@ -41,32 +201,19 @@ int scil_swage(byte* restrict buf_out,
                const size_t count,
                const uint8_t bits_per_value)
 {
-    size_t bit_index = 0;
-    for(size_t i = 0; i < count; ++i)
-    {
-        size_t start_byte = bit_index / 8;
-        size_t end_byte   = (bit_index + bits_per_value) / 8;
-        uint8_t bit_offset = bit_index % 8;
+    pthread_once(&select_once, select_kernels);
 
-        int8_t right_shifts = bits_per_value + bit_offset - 8;
+    scil_bit_writer_t w;
+    scil_bit_writer_init(&w, buf_out);
+    const swage_kernel_t kernel = __atomic_load_n(&swage_kernel, __ATOMIC_RELAXED);
+    size_t i = kernel(&w, buf_in, count, bits_per_value);
 
-        // Write to first byte
-
-        // Set remaining bits in start_byte to 0
-        buf_out[start_byte] &= end_mask[bit_offset];
-        // Write as much bits of number as possible to remaining bits
-        buf_out[start_byte] |= right_shift_64(buf_in[i], right_shifts);
-
-        // Write to following bytes
-        uint8_t k = 1;
-        for(uint64_t j = start_byte + 1; j <= end_byte; ++j)
-        {
-            buf_out[j] = right_shift_64(buf_in[i], right_shifts - k * 8);
-            ++k;
-        }
-
-        bit_index += bits_per_value;
+    const uint64_t mask = bits_per_value >= 64 ? UINT64_MAX : (UINT64_C(1) << bits_per_value) - 1;
+    for(; i < count; ++i)
+    {
+        scil_bit_writer_put(&w, buf_in[i] & mask, bits_per_value);
     }
+    scil_bit_writer_flush(&w);
 
     return 0;
 }
@@ -76,36 +223,20 @@ int scil_unswage(uint64_t* restrict buf_out,
                  const size_t count,
                  const uint8_t bits_per_value)
 {
-    size_t bit_index = 0;
-    for(size_t i = 0; i < count; ++i)
+    pthread_once(&select_once, select_kernels);
+
+    const size_t size = (count * bits_per_value + 7) / 8;
+    const unswage_kernel_t kernel = __atomic_load_n(&unswage_kernel, __ATOMIC_RELAXED);
+    size_t i = kernel(buf_out, buf_in, size, count, bits_per_value);
+
+    // continue behind the last value of the vector kernel
+    const size_t bit_index = i * bits_per_value;
+    scil_bit_reader_t r;
+    scil_bit_reader_init(&r, buf_in + bit_index / 8, size - bit_index / 8);
+    scil_bit_reader_get(&r, bit_index % 8);
+    for(; i < count; ++i)
     {
-        size_t start_byte = bit_index / 8;                         // Index of starting byte of current value in swaged buffer
-        size_t end_byte   = (bit_index + bits_per_value) / 8;      // Index of ending byte of current value in swaged buffer
-
-        uint8_t bit_offset = bit_index % 8;                        // Index of current bit in byte [0-7]
-        uint8_t end_byte_bits = (bit_index + bits_per_value) % 8;  // Number of bits in end_byte occupied by current value
-
-        int8_t right_shifts = 8 - bits_per_value - bit_offset;
-
-        // Read from start_byte
-        uint64_t intermed = right_shift_8(buf_in[start_byte] & start_mask[bit_offset], right_shifts); // Masks away first value-unrelated bits in start_byte and shifts related bits to final position
-        // Read from intermediate bytes
-        uint8_t k = 1;
-        for(uint64_t j = start_byte + 1; j < end_byte; ++j)
-        {
-            intermed |= right_shift_8(buf_in[j], right_shifts + k * 8); // Shifts whole byte to final position and applies it
-            ++k;
-        }
-        // Read from end_byte
-        if(start_byte != end_byte)
-        {
-            intermed |= right_shift_8(buf_in[end_byte], 8 - end_byte_bits); // Shifts out unrelated end bits in end_byte and applies value
-        }
-
-        // Write to output buffer
-        buf_out[i] = intermed;
-
-        bit_index += bits_per_value;
+        buf_out[i] = scil_bit_reader_get(&r, bits_per_value);
     }
 
     return 0;
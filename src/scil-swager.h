@@ -14,6 +14,7 @@
  * \param bits_per_value Bit size of each compressed value
  * \pre buf_out != NULL
  * \pre buf_in != NULL
+ * \post exactly (count * bits_per_value + 7) / 8 bytes are written, the unused bits of the last byte are 0
  * \return scil error code
  */
 int scil_swage(byte* restrict buf_out,
@@ -36,4 +37,124 @@ int scil_unswage(uint64_t* restrict buf_out,
                  const size_t count,
                  const uint8_t bits_per_value);
 
+/*
+ The instruction set used by scil_swage() and scil_unswage(), the best one supported by the CPU
+ is selected on the first call. All variants create identical output.
+ */
+typedef enum {
+  SCIL_SWAGE_SCALAR,
+  SCIL_SWAGE_AVX2,
+  SCIL_SWAGE_AVX512
+} scil_swage_isa_t;
+
+scil_swage_isa_t scil_swage_get_isa();
+
+/**
+ * \brief Overrides the automatic selection, intended for testing and benchmarking.
+ * Must not be called while other threads pack data.
+ * \return SCIL_EINVAL if the CPU does not support the instruction set
+ */
+int scil_swage_set_isa(scil_swage_isa_t isa);
+
+/*
+ Streaming versions of scil_swage() and scil_unswage() for kernels that produce or consume
+ one value at a time. They create the same format: values are stored most significant bit first
+ without padding, the unused bits of the last byte are 0. Bits are collected in a register and
+ written as 32 bit words, thus no intermediate array is needed.
+ */
+typedef struct {
+  byte* out;
+  uint64_t acc;
+  unsigned bits; // pending bits in acc, always < 32 between calls
+} scil_bit_writer_t;
+
+typedef struct {
+  const byte* in;
+  const byte* end;
+  uint64_t acc;
+  unsigned bits; // unread bits in acc
+} scil_bit_reader_t;
+
+static inline void scil_bit_writer_init(scil_bit_writer_t* w, byte* out){
+  w->out  = out;
+  w->acc  = 0;
+  w->bits = 0;
+}
+
+// value must be smaller than 2^bits, bits <= 32
+static inline void scil_bit_writer_put32(scil_bit_writer_t* w, uint32_t value, unsigned bits){
+  w->acc   = (w->acc << bits) | value;
+  w->bits += bits;
+  if (w->bits >= 32){
+    w->bits -= 32;
+    const uint32_t word = (uint32_t)(w->acc >> w->bits);
+    w->out[0] = (byte)(word >> 24);
+    w->out[1] = (byte)(word >> 16);
+    w->out[2] = (byte)(word >> 8);
+    w->out[3] = (byte) word;
+    w->out += 4;
+  }
+}
+
+// value must be smaller than 2^bits, bits <= 64
+static inline void scil_bit_writer_put(scil_bit_writer_t* w, uint64_t value, unsigned bits){
+  if (bits > 32){
+    scil_bit_writer_put32(w, (uint32_t)(value >> 32), bits - 32);
+    scil_bit_writer_put32(w, (uint32_t) value, 32);
+  }else{
+    scil_bit_writer_put32(w, (uint32_t) value, bits);
+  }
+}
+
+/**
+ * \brief Writes the pending bits.
+ * \return the end of the packed data
+ */
+static inline byte* scil_bit_writer_flush(scil_bit_writer_t* w){
+  while (w->bits >= 8){
+    w->bits -= 8;
+    *w->out++ = (byte)(w->acc >> w->bits);
+  }
+  if (w->bits > 0){
+    *w->out++ = (byte)(w->acc << (8 - w->bits));
+    w->bits = 0;
+  }
+  return w->out;
+}
+
+static inline void scil_bit_reader_init(scil_bit_reader_t* r, const byte* in, size_t size){
+  r->in   = in;
+  r->end  = in + size;
+  r->acc  = 0;
+  r->bits = 0;
+}
+
+// bits <= 32, reading beyond the end returns 0 bits
+static inline uint32_t scil_bit_reader_get32(scil_bit_reader_t* r, unsigned bits){
+  if (r->bits < bits){
+    if (r->end - r->in >= 4){
+      const uint32_t word = ((uint32_t) r->in[0] << 24) | ((uint32_t) r->in[1] << 16) | ((uint32_t) r->in[2] << 8) | r->in[3];
+      r->acc   = (r->acc << 32) | word;
+      r->bits += 32;
+      r->in   += 4;
+    }else{
+      while (r->bits < bits){
+        r->acc   = (r->acc << 8) | (r->in < r->end ? *r->in++ : 0);
+        r->bits += 8;
+      }
+    }
+  }
+  r->bits -= bits;
+  return (uint32_t)(r->acc >> r->bits) & (uint32_t)((UINT64_C(1) << bits) - 1);
+}
+
+// bits <= 64
+static inline uint64_t scil_bit_reader_get(scil_bit_reader_t* r, unsigned bits){
+  if (bits > 32){
+    const uint64_t high = scil_bit_reader_get32(r, bits - 32);
+    return (high << 32) | scil_bit_reader_get32(r, 32);
+  }
+  return scil_bit_reader_get32(r, bits);
+}
+
 #endif /* SCIL_SWAGER_H */
@@ -13,10 +13,20 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
 #include <scil-algo-chooser.h>
+#include <scil-algo-learning.h>
+#include <scil-chain.h>
+#include <scil-chain-execution.h>
+#include <scil-data-stats.h>
 #include <scil-error.h>
 #include <scil-hardware-limits.h>
+#include <scil-hyperslab.h>
 #include <scil-internal.h>
 #include <scil-context.h>
+#include <scil-stats.h>
+#include <scil-stream.h>
+#include <scil-tiling.h>
+#include <scil-trace.h>
+#include <scil-workspace.h>
 
 #include <scil-compressors.h>
 
@@ -36,37 +46,7 @@
 
 void scil_compression_sprint_last_algorithm_chain(scil_context_t* ctx, char* out, int buff_length)
 {
-    int ret                      = 0;
-    scilI_chain_t* lc = &ctx->chain;
-    for (int i = 0; i < PRECONDITIONER_LIMIT; i++) {
-        if (lc->pre_cond_first[i] == NULL) break;
-        ret = snprintf(out, buff_length, "%s,", lc->pre_cond_first[i]->name);
-        buff_length -= ret;
-        out += ret;
-    }
-	if (lc->converter != NULL) {
-		ret = snprintf(out, buff_length, "%s,", lc->converter->name);
-		buff_length -= ret;
-		out += ret;
-	}
-	for (int i = 0; i < PRECONDITIONER_LIMIT; i++) {
-        if (lc->pre_cond_second[i] == NULL) break;
-        ret = snprintf(out, buff_length, "%s,", lc->pre_cond_second[i]->name);
-        buff_length -= ret;
-        out += ret;
-    }
-	if (lc->data_compressor != NULL) {
-		ret = snprintf(out, buff_length, "%s,", lc->data_compressor->name);
-		buff_length -= ret;
-		out += ret;
-	}
-    if (lc->byte_compressor != NULL) {
-        ret = snprintf(out, buff_length, "%s,", lc->byte_compressor->name);
-        buff_length -= ret;
-        out += ret;
-    }
-    // remove the last character
-    out[-1] = 0;
+    scilI_chain_sprint(&ctx->chain, out, buff_length);
 }
 
 static inline void* pick_buffer(int is_src,
@@ -90,6 +70,40 @@ static inline void* pick_buffer(int is_src,
     }
 }
 
+// the probes of a stage record the statistics and the trace, if they are enabled
+static inline void stage_begin(const scil_stats_t* stats, int trace, scil_timer* timer)
+{
+    if (stats != NULL || trace) {
+        scilU_start_timer(timer);
+    }
+}
+
+static inline void stage_end(scil_stats_t* stats, int trace, scil_timer timer, int stage, const char* name, const char* category, size_t bytes_in, size_t bytes_out)
+{
+    if (stats != NULL) {
+        scilC_stats_add_stage(stats, stage, name, scilU_stop_timer(timer), bytes_in, bytes_out);
+    }
+    if (trace) {
+        scilU_trace_span(name, category, timer, bytes_in, bytes_out);
+    }
+}
+
+// the tiled and the blocked execution write a container of independently compressed parts
+static int compress_container(byte* restrict dest,
+                              size_t dest_size,
+                              void* restrict source,
+                              const scil_dims_t* dims,
+                              size_t* restrict out_size,
+                              scil_context_t* ctx) {
+    if (scilC_get_tile_count(ctx, dims) > 1) {
+        return scilC_compress_tiled(dest, dest_size, source, dims, out_size, ctx);
+    }
+    if (scilC_get_block_count(ctx, dims) > 1) {
+        return scilC_compress_blocked(dest, dest_size, source, dims, out_size, ctx);
+    }
+    return scilC_compress_chain(dest, dest_size, source, dims, out_size, ctx);
+}
+
 /*
 A compression chain compresses data in multiple phases, i.e., applying algo 1,
 then algo 2 ...
@@ -98,7 +112,9 @@ The processing sequence may consist of the following steps:
 2) a data compressor
 3) a single byte compressor.
 For cache efficiency reasons, a compound compression scheme should be used
-instead of multiple data copy stages.
+instead of multiple data copy stages. A context with a block size splits large
+arrays into blocks that pass all stages before the next block is processed, see
+scilPr_set_block_size() and scilC_compress_blocked().
 
 Internally, the compressed buffer is formated as follows:
 - byte CHAIN_LENGTH // the number of compressors to apply.
@@ -135,11 +151,8 @@ int scil_compress(byte* restrict dest,
 	assert(out_size_p != NULL);
 	assert(source != NULL);
 
-	int ret = SCIL_NO_ERR;
-
 	// Get byte size of input data
-    size_t input_size           = scilPr_get_dims_size(dims, ctx->datatype);
-    const size_t datatypes_size = input_size;
+    const size_t datatypes_size = scilPr_get_dims_size(dims, ctx->datatype);
 
 	// Skip the compression if input size is 0 and set destination buffer to a single 0 and size 1
     if (datatypes_size == 0) {
@@ -149,18 +162,145 @@ int scil_compress(byte* restrict dest,
         return SCIL_NO_ERR;
     }
 
-	// Why? Factor 4 seems arbitrary
-    if (in_dest_size < 4 * datatypes_size) {
-        return SCIL_MEMORY_ERR;
+    // the statistics and the trace of the call include the selection of the chain
+    struct scil_context_stats* stats = ctx->call_stats;
+    const int trace = scilU_trace_enabled();
+    scil_timer stats_timer;
+    if (stats != NULL) {
+        scilC_stats_begin(&stats->last);
+    }
+    if (stats != NULL || trace) {
+        scilU_start_timer(&stats_timer);
     }
 
-	// Set local references of hints and compression chain
-    const scil_user_hints_t* hints = &ctx->hints;
-    scilI_chain_t* chain  = &ctx->chain;
+    // the caller may have changed the data since the last call
+    scilI_context_data_stats_invalidate(ctx);
 
 	// Check whether automatic compressor decision can be skipped because of a user forced chain
-    if (hints->force_compression_methods == NULL) {
+	// The decision is made once for all tiles to keep the output independent of the tiling
+    if (ctx->hints.force_compression_methods == NULL) {
+        scil_timer chooser_timer;
+        if (trace) {
+            scilU_start_timer(&chooser_timer);
+        }
         scilC_algo_chooser_execute(source, dims, ctx);
+        if (trace) {
+            scilU_trace_span("chooser", "compress", chooser_timer, 0, 0);
+        }
+    }
+
+    if (in_dest_size < scil_compress_bound(ctx, dims)) {
+        return SCIL_MEMORY_ERR;
+    }
+
+    // the observed performance of a chain picked with learning refines the next decisions
+    scil_timer timer;
+    scil_timer fallback_timer;
+    if (ctx->chain_adaptive) {
+        scilU_start_timer(&timer);
+    }
+    int ret = compress_container(dest, in_dest_size, source, dims, out_size_p, ctx);
+    char failed[SCIL_LEARNING_CHAIN_LENGTH];
+    failed[0] = 0;
+    if (ret != SCIL_NO_ERR && ctx->hints.force_compression_methods == NULL) {
+        scilI_chain_sprint(&ctx->chain, failed, sizeof(failed));
+        if (scilC_algo_chooser_fallback(dims, ctx)) {
+            // the lossy chain chosen automatically cannot meet the hints for this data, lz4 can
+            debug("The chosen chain failed with %d, using lz4\n", ret);
+            if (in_dest_size < scil_compress_bound(ctx, dims)) {
+                return SCIL_MEMORY_ERR;
+            }
+            if (stats != NULL) {
+                scilC_stats_begin(&stats->last);
+            }
+            scilI_context_data_stats_invalidate(ctx);
+            scilU_start_timer(&fallback_timer);
+            ret = compress_container(dest, in_dest_size, source, dims, out_size_p, ctx);
+        } else {
+            failed[0] = 0;
+        }
+    }
+    if (ret == SCIL_NO_ERR && ctx->chain_adaptive) {
+        if (failed[0] != 0) {
+            // the failed chain is charged with both attempts for the result of lz4, thus it is not tried first again
+            scilC_learning_record(failed, ctx->datatype, datatypes_size, *out_size_p, scilU_stop_timer(timer));
+            scilC_algo_chooser_learn(ctx, datatypes_size, *out_size_p, scilU_stop_timer(fallback_timer));
+        } else {
+            scilC_algo_chooser_learn(ctx, datatypes_size, *out_size_p, scilU_stop_timer(timer));
+        }
+    }
+    if (ret == SCIL_NO_ERR && stats != NULL) {
+        scilC_stats_end(&stats->last, &stats->total, datatypes_size, *out_size_p, scilU_stop_timer(stats_timer));
+    }
+    if (ret == SCIL_NO_ERR && trace) {
+        scilU_trace_span("scil_compress", "compress", stats_timer, datatypes_size, *out_size_p);
+    }
+    return ret;
+}
+
+size_t scil_compress_bound(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+    if (scilPr_get_dims_size(dims, ctx->datatype) == 0) {
+        return 1;
+    }
+    if (scilC_get_tile_count(ctx, dims) > 1) {
+        return scilC_compress_tiled_bound(ctx, dims);
+    }
+    if (scilC_get_block_count(ctx, dims) > 1) {
+        return scilC_compress_blocked_bound(ctx, dims);
+    }
+    return scilC_compress_chain_bound(ctx, dims);
+}
+
+size_t scilC_compress_chain_bound(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+    // a chain picked with learning may change with the next call
+    if (ctx->chain.total_size == 0 || ctx->chain_adaptive) {
+        return scilC_algo_chooser_compress_bound(ctx, dims);
+    }
+    return scilI_chain_compress_bound(&ctx->chain, ctx->datatype, dims, NULL);
+}
+
+size_t scilC_compress_workspace_size(const scil_context_t* ctx, const scil_dims_t* dims)
+{
+    size_t stage_size = 0;
+    scilC_tiling_t blocks;
+    if (scilC_blocking_initialize(&blocks, ctx, dims)) {
+        // the largest block is a regular one
+        dims = &blocks.tile;
+    }
+    if (ctx->chain.total_size != 0) {
+        scilI_chain_compress_bound(&ctx->chain, ctx->datatype, dims, &stage_size);
+    }
+    // the two intermediate buffers, the built-in algorithms need no temporary memory
+    return 2 * (stage_size + SCIL_WORKSPACE_ALIGNMENT);
+}
+
+int scilC_compress_chain(byte* restrict dest,
+                         size_t in_dest_size,
+                         void* restrict source,
+                         const scil_dims_t* dims,
+                         size_t* restrict out_size_p,
+                         scil_context_t* ctx) {
+	int ret = SCIL_NO_ERR;
+
+	// Get byte size of input data
+    size_t input_size           = scilPr_get_dims_size(dims, ctx->datatype);
+    const size_t datatypes_size = input_size;
+
+    if (datatypes_size == 0) {
+        out_size_p[0] = 1;
+        dest[0]       = (byte)0;
+
+        return SCIL_NO_ERR;
+    }
+
+	// Set local reference of the compression chain
+    scilI_chain_t* chain  = &ctx->chain;
+
+    size_t stage_size;
+    if (in_dest_size < scilI_chain_compress_bound(chain, ctx->datatype, dims, &stage_size)) {
+        return SCIL_MEMORY_ERR;
     }
 
     size_t out_size = 0;
@@ -172,23 +312,35 @@ int scil_compress(byte* restrict dest,
     dest++;
 
     // Process the compression pipeline
-    // we use 1.5 the memory buffer as intermediate location // no we don't, do we?
-    const size_t buffer_tmp_offset = 2 * datatypes_size + 10;
-    byte* restrict buff_tmp        = &dest[buffer_tmp_offset];
+    // intermediate stages alternate between two workspace buffers, only the last stage writes to dest
+    // the algorithms take their temporary buffers from the same workspace
+    scilI_workspace_reset(ctx->workspace);
+    byte* buff_tmp1 = NULL;
+    byte* buff_tmp2 = NULL;
+    if (stage_size > 0) {
+        buff_tmp1 = (byte*)scilI_workspace_alloc(ctx->workspace, stage_size);
+        buff_tmp2 = (byte*)scilI_workspace_alloc(ctx->workspace, stage_size);
+    }
+
+    // the stages of all blocks of a call are summed up
+    scil_stats_t* stats = ctx->call_stats == NULL ? NULL : &ctx->call_stats->last;
+    const int trace     = scilU_trace_enabled();
+    scil_timer stage_timer = {0};
 
     // process the compression chain
     // apply the first pre-conditioners
     if (chain->precond_first_count > 0) {
         out_size += datatypes_size;
         // add the header at the end of the preconditioners
-        byte* header = datatypes_size + (byte*)pick_buffer(0, total_compressors, 1 + total_compressors - chain->precond_first_count, source, dest, buff_tmp, dest);
+        byte* header = datatypes_size + (byte*)pick_buffer(0, total_compressors, 1 + total_compressors - chain->precond_first_count, source, dest, buff_tmp1, buff_tmp2);
 
         for (int i = 0; i < chain->precond_first_count; i++) {
             int header_size_out;
             scilI_algorithm_t* algo = chain->pre_cond_first[i];
-            void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-            void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
+            void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
+            void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
 
+            stage_begin(stats, trace, &stage_timer);
             switch (ctx->datatype) {
                 case (SCIL_TYPE_FLOAT):
                     ret = algo->c.PFtype.compress_float(ctx, (float*)dst, header, &header_size_out, src, dims);
@@ -216,6 +368,7 @@ int scil_compress(byte* restrict dest,
             }
 
             if (ret != 0) return ret;
+            stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "compress", datatypes_size, datatypes_size + header_size_out + 1);
             remaining_compressors--;
             out_size += header_size_out;
             header   += header_size_out;
@@ -234,13 +387,14 @@ int scil_compress(byte* restrict dest,
 	// Apply the converter
 	if (chain->converter) {
 		// we need to preserve the header of the pre-conditioners.
-        void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-        void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
+        void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
+        void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
 
         // set the output size to the expected buffer size
         out_size = (size_t)(datatypes_size * 2);
 
         scilI_algorithm_t* algo = chain->converter;
+        stage_begin(stats, trace, &stage_timer);
         switch (ctx->datatype) {
             case (SCIL_TYPE_FLOAT):
                 ret = algo->c.Ctype.compress_float(ctx, (int64_t*)dst, &out_size, src, dims);
@@ -276,6 +430,7 @@ int scil_compress(byte* restrict dest,
             out_size += preserve;
             scilU_print_buffer(dst, out_size);
         }
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "compress", input_size, out_size + 1);
 
         remaining_compressors--;
         ((char*)dst)[out_size] = algo->compressor_id;
@@ -289,17 +444,19 @@ int scil_compress(byte* restrict dest,
     if (chain->precond_second_count > 0) {
         out_size += datatypes_size;
         // add the header at the end of the preconditioners
-        byte* header = datatypes_size + (byte*)pick_buffer(0, total_compressors, 1 + total_compressors - chain->precond_second_count, source, dest, buff_tmp, dest);
+        byte* header = datatypes_size + (byte*)pick_buffer(0, total_compressors, 1 + total_compressors - chain->precond_second_count, source, dest, buff_tmp1, buff_tmp2);
 
         for (int i = 0; i < chain->precond_second_count; i++) {
             int header_size_out;
             scilI_algorithm_t* algo = chain->pre_cond_second[i];
-            void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-            void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
+            void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
+            void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
 
+            stage_begin(stats, trace, &stage_timer);
 			      ret = algo->c.PStype.compress(ctx, (int64_t*)dst, header, &header_size_out, src, dims);
 
             if (ret != 0) return ret;
+            stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "compress", datatypes_size, datatypes_size + header_size_out + 1);
             remaining_compressors--;
             out_size += header_size_out;
             header   += header_size_out;
@@ -317,13 +474,14 @@ int scil_compress(byte* restrict dest,
 	// Apply the data compressor
     if (chain->data_compressor) {
         // we need to preserve the header of the pre-conditioners.
-        void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
-        void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
+        void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
+        void* dst = pick_buffer(0, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
 
         // set the output size to the expected buffer size
         out_size = (size_t)(datatypes_size * 2);
 
         scilI_algorithm_t* algo = chain->data_compressor;
+        stage_begin(stats, trace, &stage_timer);
         switch (ctx->datatype) {
           case (SCIL_TYPE_FLOAT):
                 ret = algo->c.DNtype.compress_float(ctx, dst, &out_size, src, dims);
@@ -359,6 +517,7 @@ int scil_compress(byte* restrict dest,
             out_size += preserve;
             scilU_print_buffer(dst, out_size);
         }
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "compress", input_size, out_size + 1);
 
         remaining_compressors--;
         ((char*)dst)[out_size] = algo->compressor_id;
@@ -370,12 +529,14 @@ int scil_compress(byte* restrict dest,
 
 	// Apply byte compressor
     if (chain->byte_compressor) {
-        void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp, dest);
+        void* src = pick_buffer(1, total_compressors, remaining_compressors, source, dest, buff_tmp1, buff_tmp2);
 
         // scilU_print_buffer(src, input_size);
 
+        stage_begin(stats, trace, &stage_timer);
         ret = chain->byte_compressor->c.Btype.compress(ctx, dest, &out_size, (byte*)src, input_size);
         if (ret != 0) return ret;
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, chain->byte_compressor->name, "compress", input_size, out_size + 1);
         dest[out_size] = chain->byte_compressor->compressor_id;
         debugI("C compressor ID %d at pos %llu\n",
                chain->byte_compressor->compressor_id,
@@ -385,10 +546,39 @@ int scil_compress(byte* restrict dest,
         // scilU_print_buffer(dest, out_size);
     }
 
+    if (stats != NULL) {
+        stats->scratch_bytes = max(stats->scratch_bytes, scilI_workspace_used(ctx->workspace));
+    }
     *out_size_p = out_size + 1; // for the length of the processing chain
     return SCIL_NO_ERR;
 }
 
+int scilC_decompress(SCIL_Datatype_t datatype,
+                     void* restrict dest,
+                     scil_dims_t* dims,
+                     byte* restrict source,
+                     const size_t source_size,
+                     byte* restrict buff_tmp1,
+                     scil_stats_t* stats) {
+
+    if (dims->dims == 0) {
+        return SCIL_NO_ERR;
+    }
+
+    assert(dest != NULL);
+    assert(source != NULL);
+
+    if (source[0] == SCIL_TILED_CONTAINER) {
+        return scilC_decompress_tiled(datatype, dest, dims, source, source_size, stats);
+    }
+    if (source[0] == SCIL_STREAM_CONTAINER) {
+        // the frames of a stream are not broken down into stages
+        return scilC_decompress_stream_buffer(datatype, dest, dims, source, source_size, buff_tmp1);
+    }
+
+    return scilC_decompress_chain(datatype, dest, dims, source, source_size, buff_tmp1, stats);
+}
+
 int scil_decompress(SCIL_Datatype_t datatype,
                     void* restrict dest,
                     scil_dims_t* dims,
@@ -396,13 +586,115 @@ int scil_decompress(SCIL_Datatype_t datatype,
                     const size_t source_size,
                     byte* restrict buff_tmp1) {
 
-    if (dims->dims == 0) {
-        return SCIL_NO_ERR;
+    struct scil_context_stats* stats = scilC_decompression_stats();
+    const int trace = scilU_trace_enabled();
+    if (stats == NULL && ! trace) {
+        return scilC_decompress(datatype, dest, dims, source, source_size, buff_tmp1, NULL);
+    }
+
+    scil_timer stats_timer;
+    if (stats != NULL) {
+        scilC_stats_begin(&stats->last);
+    }
+    scilU_start_timer(&stats_timer);
+    int ret = scilC_decompress(datatype, dest, dims, source, source_size, buff_tmp1, stats == NULL ? NULL : &stats->last);
+    const size_t size = scilPr_get_dims_size(dims, datatype);
+    if (ret == SCIL_NO_ERR && stats != NULL) {
+        scilC_stats_end(&stats->last, &stats->total, source_size, size, scilU_stop_timer(stats_timer));
+    }
+    if (ret == SCIL_NO_ERR && trace) {
+        scilU_trace_span("scil_decompress", "decompress", stats_timer, source_size, size);
     }
+    return ret;
+}
+
+size_t scil_decompress_scratch_size(SCIL_Datatype_t datatype,
+                                    const scil_dims_t* dims,
+                                    const byte* source,
+                                    const size_t source_size) {
+    if (dims->dims == 0 || source_size == 0) {
+        return 0;
+    }
+    if (source[0] == SCIL_TILED_CONTAINER) {
+        return 0;
+    }
+    if (source[0] == SCIL_STREAM_CONTAINER) {
+        return scilC_decompress_stream_scratch_size(datatype, dims, source, source_size);
+    }
+    return scilC_decompress_chain_scratch_size(datatype, dims, source, source_size);
+}
+
+int scil_decompress_region(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           scil_dims_t* dims,
+                           const scil_dims_t* offset,
+                           const scil_dims_t* count,
+                           byte* restrict source,
+                           const size_t source_size) {
 
     assert(dest != NULL);
     assert(source != NULL);
-    assert(buff_tmp1 != NULL);
+
+    if (offset->dims != dims->dims || count->dims != dims->dims) {
+        return SCIL_EINVAL;
+    }
+    for (int d = 0; d < dims->dims; d++) {
+        if (offset->length[d] + count->length[d] > dims->length[d]) {
+            return SCIL_EINVAL;
+        }
+    }
+    if (scilPr_get_dims_count(count) == 0 || dims->dims == 0) {
+        return SCIL_NO_ERR;
+    }
+
+    if (source[0] == SCIL_TILED_CONTAINER) {
+        return scilC_decompress_tiled_region(datatype, dest, dims, offset, count, source, source_size);
+    }
+
+    // other formats can only be decompressed as a whole
+    byte* data = (byte*)malloc(scilPr_get_dims_size(dims, datatype));
+    int ret    = SCIL_MEMORY_ERR;
+    if (data != NULL) {
+        ret = scil_decompress(datatype, data, dims, source, source_size, NULL);
+    }
+    if (ret == SCIL_NO_ERR) {
+        scil_dims_t zero = {0};
+        zero.dims = dims->dims;
+        scilI_copy_hyperslab(dest, count, &zero, data, dims, offset, count, DATATYPE_LENGTH(datatype));
+    }
+    free(data);
+    return ret;
+}
+
+// the size of an intermediate result, the datatype compressors may expand the data slightly
+static size_t decompress_stage_size(size_t output_size)
+{
+    return output_size * 2 + 10;
+}
+
+size_t scilC_decompress_chain_scratch_size(SCIL_Datatype_t datatype, const scil_dims_t* dims, const byte* source, size_t source_size)
+{
+    if (source_size == 0 || source[0] <= 1) {
+        return 0;
+    }
+    // the first and the last stage read the source and write the destination directly,
+    // longer chains alternate between two intermediate buffers
+    const size_t buffers = source[0] == 2 ? 1 : 2;
+    return buffers * decompress_stage_size(scilPr_get_dims_size(dims, datatype));
+}
+
+int scilC_decompress_chain(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           scil_dims_t* dims,
+                           byte* restrict source,
+                           const size_t source_size,
+                           byte* restrict buff_tmp1,
+                           scil_stats_t* stats) {
+
+    // the decompressors take their temporary buffers from the workspace of the thread
+    scilI_workspace_reset(scilI_thread_workspace());
+    const int trace = scilU_trace_enabled();
+    scil_timer stage_timer = {0};
 
     // Read compressor ID (algorithm id) from header
     const int total_compressors = (uint8_t)source[0];
@@ -413,7 +705,12 @@ int scil_decompress(SCIL_Datatype_t datatype,
     int ret;
 
     const size_t output_size = scilPr_get_dims_size(dims, datatype);
-    byte* restrict buff_tmp2 = &buff_tmp1[(int)(output_size * 2 + 10)];
+    const size_t stage_size  = decompress_stage_size(output_size);
+    if (buff_tmp1 == NULL && total_compressors > 1) {
+        buff_tmp1 = (byte*)scilI_workspace_alloc(scilI_thread_workspace(), scilC_decompress_chain_scratch_size(datatype, dims, source, source_size));
+    }
+    // only chains of three and more stages use the second buffer
+    byte* restrict buff_tmp2 = total_compressors > 2 ? &buff_tmp1[stage_size] : NULL;
 
     // for(int i=0; i < chain_size; i++){
     src_size--;
@@ -430,8 +727,12 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void* src = pick_buffer(1, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         void* dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
 
-        ret = algo->c.Btype.decompress(dst, output_size * 2 + 10, (byte*)src, src_size, &src_size);
+        stage_begin(stats, trace, &stage_timer);
+        const size_t in_size = src_size;
+        // the last stage must not write behind the data in dest
+        ret = algo->c.Btype.decompress(dst, dst == dest ? output_size : stage_size, (byte*)src, src_size, &src_size);
         if (ret != 0) return ret;
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "decompress", in_size, src_size);
         remaining_compressors--;
 
         // the header is on the right hand side of the buffer
@@ -456,6 +757,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void* src = pick_buffer(1, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         void* dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
 
+        stage_begin(stats, trace, &stage_timer);
         switch (datatype) {
             case (SCIL_TYPE_FLOAT):
                 ret = algo->c.DNtype.decompress_float(dst, dims, src, src_size);
@@ -483,6 +785,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
         }
 
         if (ret != 0) return ret;
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "decompress", src_size, output_size);
         remaining_compressors--;
         if (remaining_compressors > 0) {
             // scilU_print_buffer(dst, src_size);
@@ -499,11 +802,13 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void* dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         int header_parsed;
 
+        stage_begin(stats, trace, &stage_timer);
         ret = algo->c.PStype.decompress(dst, dims, src, header, &header_parsed);
 
         header -= header_parsed;
 
         if (ret != 0) return ret;
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "decompress", output_size, output_size);
         remaining_compressors--;
 
         // scilU_print_buffer(dst, src_size);
@@ -518,6 +823,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
         void* src = pick_buffer(1, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
         void* dst = pick_buffer(0, total_compressors, remaining_compressors, src_adj, dest, buff_tmp1, buff_tmp2);
 
+        stage_begin(stats, trace, &stage_timer);
         switch (datatype) {
           case (SCIL_TYPE_FLOAT):
             ret = algo->c.Ctype.decompress_float(dst, dims, src, src_size);
@@ -545,6 +851,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
         }
 
         if (ret != 0) return ret;
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "decompress", src_size, output_size);
         remaining_compressors--;
         if (remaining_compressors > 0) {
             // scilU_print_buffer(dst, src_size);
@@ -565,6 +872,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
             return SCIL_BUFFER_ERR;
         }
 
+        stage_begin(stats, trace, &stage_timer);
         switch (datatype) {
           case (SCIL_TYPE_FLOAT):
               ret = algo->c.PFtype.decompress_float(dst, dims, src, header, &header_parsed);
@@ -593,6 +901,7 @@ int scil_decompress(SCIL_Datatype_t datatype,
         header -= header_parsed;
 
         if (ret != 0) return ret;
+        stage_end(stats, trace, stage_timer, total_compressors - remaining_compressors, algo->name, "decompress", output_size, output_size);
         remaining_compressors--;
 
         if (remaining_compressors > 0) {
@@ -608,6 +917,9 @@ int scil_decompress(SCIL_Datatype_t datatype,
     }
     // TODO check if the header is completely devoured.
 
+    if (stats != NULL) {
+        stats->scratch_bytes = max(stats->scratch_bytes, scilI_workspace_used(scilI_thread_workspace()));
+    }
     return SCIL_NO_ERR;
 }
 
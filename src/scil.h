@@ -253,8 +253,7 @@ void scil_compression_sprint_last_algorithm_chain(scil_context_t* ctx,
  * \brief Method to compress a data buffer
  * \param dest Destination of the compressed buffer
  * \param dest_size Reference to the compressed buffer byte size, max size is
- * given as argument, if a pipeline is processed it should be 3x the memory size
- * of the input size + the HEADER.
+ * given as argument, it must be at least scil_compress_bound().
  * \param source Source buffer of the data to compress
  * \param dims struct containing information about dimension count and length of
  * buffer in each dimension
@@ -273,6 +272,17 @@ int scil_compress(byte* restrict dest,
                   size_t* restrict out_size,
                   scil_context_t* ctx);
 
+/**
+ * \brief Returns the maximum size of the compressed data for a buffer of the given dimensions
+ * The bound is exact for the chain forced in ctx or chosen by a previous scil_compress().
+ * Otherwise it covers every chain the automatic selection may pick.
+ * \param ctx Reference to the compression context
+ * \param dims struct containing information about dimension count and length of
+ * buffer in each dimension
+ * \return The minimum size of the destination buffer of scil_compress()
+ */
+size_t scil_compress_bound(const scil_context_t* ctx, const scil_dims_t* dims);
+
 /**
  * \brief Method to decompress a data buffer
  * \param datatype The datatype of the data (float, double, etc...)
@@ -283,7 +293,10 @@ int scil_compress(byte* restrict dest,
  * \pre datatype == 0 || datatype == 1
  * \pre dest != NULL
  * \pre source != NULL
- * \pre tmp_buff != NULL with a size of scilPr_get_compressed_data_size_limit() / 2
+ * \param tmp_buff Scratch of at least scil_decompress_scratch_size() bytes or NULL.
+ * Single-stage chains and tiled data are decoded directly into dest and need no scratch.
+ * If tmp_buff is NULL, the scratch is taken from a buffer the library keeps per thread.
+ * Tiled data is decompressed in parallel, the environment variable SCIL_THREADS limits the number of threads.
  * \return Success state of the decompression
  */
 int scil_decompress(SCIL_Datatype_t datatype,
@@ -293,6 +306,248 @@ int scil_decompress(SCIL_Datatype_t datatype,
                     const size_t source_size,
                     byte* restrict tmp_buff);
 
+/**
+ * \brief Returns the exact size of the scratch buffer scil_decompress() needs for the compressed data.
+ * \param datatype The datatype of the data
+ * \param dims Dimensional information about the decompressed buffer
+ * \param source The compressed data
+ * \param source_size Byte size of the compressed data
+ * \return The size in bytes, 0 if the data is decoded without scratch
+ */
+size_t scil_decompress_scratch_size(SCIL_Datatype_t datatype,
+                                    const scil_dims_t* dims,
+                                    const byte* source,
+                                    const size_t source_size);
+
+/**
+ * \brief Method to decompress a hyperslab of a data buffer
+ * Of data compressed with tiling, only the tiles overlapping the hyperslab are decompressed.
+ * Other data must be decompressed completely into an internal buffer.
+ * \param dest Destination of the hyperslab, its extent is given by count
+ * \param dims Dimensional information about the complete decompressed buffer
+ * \param offset The position of the first element of the hyperslab
+ * \param count The extent of the hyperslab in each dimension
+ * \pre offset + count <= dims in each dimension
+ * \return Success state of the decompression
+ */
+int scil_decompress_region(SCIL_Datatype_t datatype,
+                           void* restrict dest,
+                           scil_dims_t* dims,
+                           const scil_dims_t* offset,
+                           const scil_dims_t* count,
+                           byte* restrict source,
+                           const size_t source_size);
+
+// the stages of the longest chain
+#define SCIL_STATS_STAGES_MAX (2 * PRECONDITIONER_LIMIT + 3)
+
+/**
+ * \brief The execution of one algorithm of the chain.
+ */
+typedef struct scil_stage_stats {
+  const char* name;
+  double seconds;
+  size_t bytes_in;
+  size_t bytes_out;
+} scil_stage_stats_t;
+
+/**
+ * \brief Statistics of compressions or decompressions, see scilPr_set_stats() and scil_set_decompression_stats().
+ * The stages are summed up over the blocks and tiles of a call; the seconds of tiles compressed in parallel
+ * are the sum of all threads, thus they may exceed the wall time of the call.
+ */
+typedef struct scil_stats {
+  uint64_t calls;
+  // the wall time of the calls, including the selection of the chain
+  double seconds;
+  size_t bytes_in;
+  size_t bytes_out;
+  // the scratch memory taken from the workspaces, the maximum of a single call
+  size_t scratch_bytes;
+  int stage_count;
+  scil_stage_stats_t stages[SCIL_STATS_STAGES_MAX];
+} scil_stats_t;
+
+/**
+ * \brief Returns the statistics recorded for the context.
+ * \param out_last If not NULL, receives the statistics of the last successful scil_compress()
+ * \param out_total If not NULL, receives the statistics of all calls; stages are aggregated by the name of the algorithm
+ * \return SCIL_EINVAL if the statistics are not enabled for the context
+ */
+int scil_get_last_stats(const scil_context_t* ctx, scil_stats_t* out_last, scil_stats_t* out_total);
+
+/**
+ * \brief Enables or disables the recording of statistics by scil_decompress() in the calling thread.
+ * Enabling them clears the statistics. Stages are only recorded for data compressed without tiles or blocks,
+ * otherwise only the totals of the call are available.
+ */
+void scil_set_decompression_stats(int enabled);
+
+/**
+ * \brief Returns the statistics of the decompressions of the calling thread.
+ * \param out_last If not NULL, receives the statistics of the last successful scil_decompress()
+ * \param out_total If not NULL, receives the statistics of all calls
+ * \return SCIL_EINVAL if the statistics are not enabled for the thread
+ */
+int scil_get_last_decompression_stats(scil_stats_t* out_last, scil_stats_t* out_total);
+
+/**
+ * \brief A variable compressed by scil_compress_batch().
+ */
+typedef struct scil_batch_item {
+  // input
+  void* source;
+  scil_dims_t dims;
+  SCIL_Datatype_t datatype;
+  // NULL selects the default hints; items sharing the same hints pointer and datatype share a context
+  const scil_user_hints_t* hints;
+  // the destination, if NULL a buffer of the compressed size is allocated that the caller must free
+  byte* dest;
+  size_t dest_size;
+
+  // output
+  size_t out_size;
+  int ret;
+} scil_batch_item_t;
+
+/**
+ * \brief Compresses many independent variables using a pool of workers.
+ * The largest items are scheduled first to balance the load, each worker reuses its context
+ * and buffers for consecutive items with the same hints.
+ * \param items The variables, out_size and ret of each item are set
+ * \param count The number of items
+ * \param thread_count The number of workers, 0 uses SCIL_THREADS or the number of online processors
+ * \return SCIL_NO_ERR if all items succeeded, otherwise the error of the first failed item
+ */
+int scil_compress_batch(scil_batch_item_t* items, size_t count, int thread_count);
+
+typedef struct scil_request scil_request_t;
+
+/**
+ * \brief Callback invoked by a background thread when an asynchronous request completed.
+ * The context and the staging buffer of the request are released before, thus the callback may submit the next
+ * request of the same context; it must not destroy the context, as the destruction waits for the callback.
+ * \param ret The result of the compression or decompression
+ * \param out_size The compressed size or the size of the decompressed data
+ */
+typedef void (*scil_request_callback_t)(void* user_ptr, int ret, size_t out_size);
+
+/**
+ * \brief Starts the compression of the data in the background and returns immediately.
+ * The data is copied into a staging buffer of the context, thus the source can be modified right away.
+ * A context has two staging buffers; if both are in use, the call waits until the oldest request finished.
+ * Requests of the same context are executed in the order of submission.
+ * \param out_request Returns the handle for scil_test() and scil_wait(); if NULL, a callback must be given
+ * and the request is released after the callback
+ * \param callback If not NULL, it is invoked when the compression completed
+ * \pre dest must stay valid until the request completed
+ */
+int scil_compress_async(scil_request_t** out_request,
+                        byte* restrict dest,
+                        size_t in_dest_size,
+                        const void* restrict source,
+                        const scil_dims_t* dims,
+                        scil_context_t* ctx,
+                        scil_request_callback_t callback,
+                        void* user_ptr);
+
+/**
+ * \brief Starts the decompression of the data in the background and returns immediately.
+ * \param out_request Returns the handle for scil_test() and scil_wait(); if NULL, a callback must be given
+ * \pre source and dest must stay valid until the request completed
+ */
+int scil_decompress_async(scil_request_t** out_request,
+                          SCIL_Datatype_t datatype,
+                          void* restrict dest,
+                          const scil_dims_t* dims,
+                          byte* restrict source,
+                          const size_t source_size,
+                          scil_request_callback_t callback,
+                          void* user_ptr);
+
+/**
+ * \brief Checks without blocking whether the request completed.
+ * \param done Set to 1 if the request completed; it must still be released with scil_wait()
+ */
+int scil_test(scil_request_t* request, int* done);
+
+/**
+ * \brief Waits for the completion of the request and releases it.
+ * \param out_size If not NULL, returns the compressed size or the size of the decompressed data
+ * \return The result of the compression or decompression
+ */
+int scil_wait(scil_request_t* request, size_t* out_size);
+
+/**
+ * \brief Callback receiving the compressed data of a stream.
+ * \return 0 on success, any other value aborts the stream
+ */
+typedef int (*scil_stream_write_func_t)(void* user_ptr, const byte* buffer, size_t size);
+
+typedef struct scil_compress_stream scil_compress_stream_t;
+
+/**
+ * \brief Begins the compression of data that is provided in slabs along the slowest (last) dimension.
+ * The data is compressed in frames which are passed to the write function as soon as they are complete.
+ * The result can be decompressed with scil_decompress().
+ * \param dims The dimensions of the complete data
+ * \param window_size The maximum number of uncompressed bytes in a frame, 0 selects 64 MiB.
+ * The stream needs about five times the window size of memory; a frame contains at least a single plane.
+ * \param write The function receiving the compressed data
+ * \pre ctx must stay valid until the stream is finished
+ */
+int scil_compress_stream_begin(scil_compress_stream_t** out_stream,
+                               scil_context_t* ctx,
+                               const scil_dims_t* dims,
+                               size_t window_size,
+                               scil_stream_write_func_t write,
+                               void* user_ptr);
+
+/**
+ * \brief Appends the next planes of the data to the stream.
+ * \param slab The data of the planes, each plane covers all but the slowest dimension
+ * \param planes The number of planes in the slab
+ */
+int scil_compress_stream_append(scil_compress_stream_t* stream,
+                                const void* slab,
+                                size_t planes);
+
+/**
+ * \brief Compresses the remaining planes, terminates the stream and releases it.
+ * \param out_size If not NULL, returns the total number of bytes written
+ * \return SCIL_EINVAL if fewer planes than declared by the dimensions were appended
+ */
+int scil_compress_stream_finish(scil_compress_stream_t* stream, size_t* out_size);
+
+/**
+ * \brief Callback providing compressed data of a stream.
+ * \return 0 if exactly size bytes have been read into buffer, any other value aborts the stream
+ */
+typedef int (*scil_stream_read_func_t)(void* user_ptr, byte* buffer, size_t size);
+
+/**
+ * \brief Callback receiving decompressed planes of a stream.
+ * \param slab The data of the planes
+ * \param first_plane The index of the first plane in the slab along the slowest dimension
+ * \param planes The number of planes in the slab
+ * \return 0 on success, any other value aborts the stream
+ */
+typedef int (*scil_stream_sink_func_t)(void* user_ptr, const void* slab, size_t first_plane, size_t planes);
+
+/**
+ * \brief Decompresses data created with scil_compress_stream_begin() that is pulled from a read function.
+ * The stream is processed frame by frame, the next frame is read while the current one is decompressed.
+ * Memory usage is bounded by the size of two frames.
+ * \param dims The expected dimensions; if dims->dims is 0, it returns the dimensions stored in the stream
+ * \return SCIL_BUFFER_ERR if the data is not a complete stream
+ */
+int scil_decompress_stream(SCIL_Datatype_t datatype,
+                           scil_dims_t* dims,
+                           scil_stream_read_func_t read,
+                           void* read_ptr,
+                           scil_stream_sink_func_t sink,
+                           void* sink_ptr);
+
 void scil_determine_accuracy(SCIL_Datatype_t datatype,
                              const void* restrict data_1,
                              const void* restrict data_2,
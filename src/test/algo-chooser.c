@@ -0,0 +1,140 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// The automatic selection must pick the cheapest chain of the configuration that honors the hints.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define COUNT 100000
+
+static double smooth[COUNT];
+static double noise[COUNT];
+static double wide[COUNT];
+
+// with a storage of 100 MiB/s the compression ratio dominates unless a chain is too slow
+static const char* configuration =
+  "!storage 100\n"
+  "# randomness; chain; compression; decompression; ratio\n"
+  "0; memcopy; 10000; 10000; 1\n"
+  "100; memcopy; 10000; 10000; 1\n"
+  "0; lz4; 2000; 4000; 0.4\n"
+  "100; lz4; 2000; 4000; 1\n"
+  "0.0; 1; pattern; abstol,lz4; 500; 1000; 0.05\n"
+  "# measured for float data only\n"
+  "0.0; 0; pattern; quantize; 9000; 9000; 0.001\n"
+  "0; quantize; 400; 900; 0.2\n"
+  "0; sigbits,lz4; 800; 1000; 0.1\n"
+  "0; wavelets,lz4; 5000; 5000; 0.01\n";
+
+static void chosen_chain(const double* data, scil_user_hints_t* hints, char* out){
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, hints);
+  assert(ret == SCIL_NO_ERR);
+
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+  double* check = malloc(COUNT * sizeof(double));
+  size_t size;
+  ret = scil_compress(buff, bound, (double*) data, & dims, & size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scil_compression_sprint_last_algorithm_chain(ctx, out, 100);
+  printf("%s\n", out);
+
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, check, & dims, buff, size, NULL);
+  assert(ret == SCIL_NO_ERR);
+  for(int i=0; i < COUNT; i++){
+    assert(fabs(check[i] - data[i]) <= 0.01);
+  }
+  free(check);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  char file[] = "/tmp/scil-algo-chooser-XXXXXX";
+  int fd = mkstemp(file);
+  assert(fd >= 0);
+  FILE* f = fdopen(fd, "w");
+  fputs(configuration, f);
+  fclose(f);
+  setenv("SCIL_SYSTEM_CHARACTERISTICS_FILE", file, 1);
+
+  srand(1);
+  for(int i=0; i < COUNT; i++){
+    smooth[i] = floor(sin(i / 1000.0) * 10) / 10;
+    noise[i] = rand() / (double) RAND_MAX;
+  }
+
+  scil_user_hints_t hints;
+  char chain[100];
+
+  // without accuracy hints only lossless chains qualify
+  scilPr_initialize_user_hints(& hints);
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "lz4") == 0);
+  chosen_chain(noise, & hints, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // the lossy chain honoring the tolerance saves the most I/O
+  hints.absolute_tolerance = 0.01;
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "abstol,lz4") == 0);
+
+  // the significant bits are not honored by abstol, sigbits does not honor the tolerance
+  hints.significant_bits = 20;
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "lz4") == 0);
+
+  // abstol,lz4 and lz4 are too slow for the demanded throughput
+  hints.significant_bits = SCIL_ACCURACY_INT_IGNORE;
+  hints.comp_speed.unit = SCIL_PERFORMANCE_GIB;
+  hints.comp_speed.multiplier = 5;
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // a throughput relative to the storage
+  hints.comp_speed.unit = SCIL_PERFORMANCE_SINGLESTREAM_SHARED_STORAGE;
+  hints.comp_speed.multiplier = 4.5;
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "abstol,lz4") == 0);
+
+  // abstol cannot quantize this range with this tolerance in 53 bits, the compression falls back to lz4
+  hints.comp_speed.unit = SCIL_PERFORMANCE_IGNORE;
+  hints.absolute_tolerance = 1e-12;
+  for(int i=0; i < COUNT; i++){
+    wide[i] = smooth[i] * 1e5;
+  }
+  chosen_chain(wide, & hints, chain);
+  assert(strcmp(chain, "lz4") == 0);
+
+  // the finest accuracy demands a lossless chain
+  hints.comp_speed.unit = SCIL_PERFORMANCE_IGNORE;
+  hints.absolute_tolerance = SCIL_ACCURACY_DBL_FINEST;
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "lz4") == 0);
+
+  unlink(file);
+  printf("OK\n");
+  return 0;
+}
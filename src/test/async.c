@@ -0,0 +1,168 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Asynchronous requests must produce the same data as the synchronous calls.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 50000
+#define STEPS 6
+
+static double data[COUNT];
+static double data_check[COUNT];
+
+static int callbacks = 0;
+
+static void fill(int step){
+  for(int i=0; i < COUNT; i++){
+    data[i] = sin(i / 300.0 + step) * (step + 1);
+  }
+}
+
+static void count_callback(void* user_ptr, int ret, size_t out_size){
+  assert(ret == SCIL_NO_ERR);
+  assert(out_size > 0);
+  __atomic_fetch_add((int*) user_ptr, 1, __ATOMIC_RELAXED);
+}
+
+// each completed compression submits the next one to the same context, like an in-situ pipeline
+typedef struct{
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  byte* dest;
+  size_t dest_size;
+  int submitted;
+  int completed;
+} pipeline_t;
+
+static void pipeline_callback(void* user_ptr, int ret, size_t out_size){
+  pipeline_t* p = (pipeline_t*) user_ptr;
+  assert(ret == SCIL_NO_ERR);
+  if(p->submitted < STEPS * 2){
+    p->submitted++;
+    ret = scil_compress_async(NULL, p->dest, p->dest_size, data, & p->dims, p->ctx, pipeline_callback, p);
+    assert(ret == SCIL_NO_ERR);
+  }
+  __atomic_fetch_add(& p->completed, 1, __ATOMIC_RELAXED);
+}
+
+int main(){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_context_t* sync_ctx;
+  scil_dims_t dims;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.001;
+  hints.force_compression_methods = "abstol,lz4";
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  // the context of pending requests must not be used for anything else
+  ret = scilPr_create_context(& sync_ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_initialize_dims_1d(& dims, COUNT);
+
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* compressed[STEPS];
+  byte* expected[STEPS];
+  size_t expected_size[STEPS];
+  scil_request_t* requests[STEPS];
+
+  // the data is overwritten by the next step while the previous ones are still compressed
+  for(int step=0; step < STEPS; step++){
+    compressed[step] = malloc(bound);
+    fill(step);
+    ret = scil_compress_async(& requests[step], compressed[step], bound, data, & dims, ctx, NULL, NULL);
+    assert(ret == SCIL_NO_ERR);
+  }
+  for(int step=0; step < STEPS; step++){
+    size_t out_size;
+    int done = 0;
+    while(! done){
+      ret = scil_test(requests[step], & done);
+      assert(ret == SCIL_NO_ERR);
+    }
+    ret = scil_wait(requests[step], & out_size);
+    assert(ret == SCIL_NO_ERR);
+
+    fill(step);
+    expected[step] = malloc(bound);
+    ret = scil_compress(expected[step], bound, data, & dims, & expected_size[step], sync_ctx);
+    assert(ret == SCIL_NO_ERR);
+    assert(out_size == expected_size[step]);
+    assert(memcmp(compressed[step], expected[step], out_size) == 0);
+  }
+
+  // requests without a handle report through the callback, destroying the context waits for them
+  for(int step=0; step < STEPS; step++){
+    fill(step);
+    ret = scil_compress_async(NULL, compressed[step], bound, data, & dims, ctx, count_callback, & callbacks);
+    assert(ret == SCIL_NO_ERR);
+  }
+  ret = scil_compress_async(NULL, compressed[0], bound, data, & dims, ctx, NULL, NULL);
+  assert(ret == SCIL_EINVAL);
+  scilPr_destroy_context(ctx);
+  scilPr_destroy_context(sync_ctx);
+  assert(__atomic_load_n(& callbacks, __ATOMIC_RELAXED) == STEPS);
+
+  // both staging buffers are in use when the callback of the first request submits the next one
+  pipeline_t pipeline;
+  ret = scilPr_create_context(& pipeline.ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  pipeline.dims = dims;
+  pipeline.dest_size = bound;
+  pipeline.dest = malloc(bound);
+  pipeline.submitted = 2;
+  pipeline.completed = 0;
+  byte* second = malloc(bound);
+  fill(0);
+  scil_request_t* first_request;
+  scil_request_t* second_request;
+  ret = scil_compress_async(& first_request, pipeline.dest, bound, data, & dims, pipeline.ctx, pipeline_callback, & pipeline);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_compress_async(& second_request, second, bound, data, & dims, pipeline.ctx, NULL, NULL);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_wait(first_request, NULL);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_wait(second_request, NULL);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_destroy_context(pipeline.ctx);
+  assert(__atomic_load_n(& pipeline.completed, __ATOMIC_RELAXED) == STEPS * 2 - 1);
+  free(pipeline.dest);
+  free(second);
+
+  for(int step=0; step < STEPS; step++){
+    scil_request_t* request;
+    memset(data_check, 0, sizeof(data_check));
+    ret = scil_decompress_async(& request, SCIL_TYPE_DOUBLE, data_check, & dims, compressed[step], expected_size[step], NULL, NULL);
+    assert(ret == SCIL_NO_ERR);
+    ret = scil_wait(request, NULL);
+    assert(ret == SCIL_NO_ERR);
+    fill(step);
+    for(int i=0; i < COUNT; i++){
+      assert(fabs(data_check[i] - data[i]) <= 0.001);
+    }
+    free(compressed[step]);
+    free(expected[step]);
+  }
+
+  printf("OK\n");
+  return 0;
+}
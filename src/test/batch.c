@@ -0,0 +1,132 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// A batch must produce the same output as compressing each item on its own.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ITEMS 40
+
+static void compress_single(scil_batch_item_t* item, byte** out, size_t* out_size){
+  scil_user_hints_t defaults;
+  scil_context_t* ctx;
+  scilPr_initialize_user_hints(& defaults);
+  int ret = scilPr_create_context(& ctx, item->datatype, 0, NULL, item->hints != NULL ? item->hints : & defaults);
+  assert(ret == SCIL_NO_ERR);
+  const size_t bound = scil_compress_bound(ctx, & item->dims);
+  *out = malloc(bound);
+  ret = scil_compress(*out, bound, item->source, & item->dims, out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  scil_user_hints_t lossy, lossless;
+  scilPr_initialize_user_hints(& lossy);
+  lossy.absolute_tolerance = 0.01;
+  lossy.force_compression_methods = "abstol,lz4";
+  scilPr_initialize_user_hints(& lossless);
+  lossless.force_compression_methods = "lz4";
+
+  scil_batch_item_t items[ITEMS];
+  memset(items, 0, sizeof(items));
+  for(int i=0; i < ITEMS; i++){
+    // sizes differ by two orders of magnitude to exercise the scheduling
+    const size_t count = 100 + (i * 7919) % 40000;
+    scil_batch_item_t* item = & items[i];
+    scilPr_initialize_dims_1d(& item->dims, count);
+    if (i % 4 == 3){
+      item->datatype = SCIL_TYPE_FLOAT;
+      float* data = malloc(count * sizeof(float));
+      for(size_t k=0; k < count; k++){
+        data[k] = (float) sin(k / 50.0 + i);
+      }
+      item->source = data;
+    }else{
+      item->datatype = SCIL_TYPE_DOUBLE;
+      double* data = malloc(count * sizeof(double));
+      for(size_t k=0; k < count; k++){
+        data[k] = sin(k / 50.0 + i) * i;
+      }
+      item->source = data;
+    }
+    item->hints = i % 3 == 0 ? & lossless : (i % 3 == 1 ? & lossy : NULL);
+    if (i % 5 == 0){
+      item->dest_size = scilPr_get_compressed_data_size_limit(& item->dims, item->datatype);
+      item->dest = malloc(item->dest_size);
+    }
+  }
+
+  int ret = scil_compress_batch(items, ITEMS, 4);
+  assert(ret == SCIL_NO_ERR);
+  for(int i=0; i < ITEMS; i++){
+    assert(items[i].ret == SCIL_NO_ERR);
+    byte* expected;
+    size_t expected_size;
+    compress_single(& items[i], & expected, & expected_size);
+    assert(items[i].out_size == expected_size);
+    assert(memcmp(items[i].dest, expected, expected_size) == 0);
+    free(expected);
+  }
+
+  // a failing item is reported, the others are still compressed
+  byte small[4];
+  free(items[7].dest);
+  items[7].dest = small;
+  items[7].dest_size = sizeof(small);
+  free(items[2].dest);
+  items[2].dest = NULL;
+  ret = scil_compress_batch(items, ITEMS, 0);
+  assert(ret == SCIL_MEMORY_ERR);
+  assert(items[7].ret == SCIL_MEMORY_ERR);
+  assert(items[2].ret == SCIL_NO_ERR && items[2].dest != NULL);
+  items[7].dest = NULL;
+
+  // the context of the largest item cannot be created, the other items must be compressed anyway
+  scil_user_hints_t invalid;
+  scilPr_initialize_user_hints(& invalid);
+  invalid.force_compression_methods = "unknown-compressor";
+  int largest = 0;
+  for(int i=1; i < ITEMS; i++){
+    if(scilPr_get_dims_count(& items[i].dims) > scilPr_get_dims_count(& items[largest].dims)){
+      largest = i;
+    }
+  }
+  items[largest].hints = & invalid;
+  for(int i=0; i < ITEMS; i++){
+    free(items[i].dest);
+    items[i].dest = NULL;
+  }
+  ret = scil_compress_batch(items, ITEMS, 4);
+  assert(ret != SCIL_NO_ERR);
+  assert(items[largest].ret != SCIL_NO_ERR);
+  for(int i=0; i < ITEMS; i++){
+    if(i != largest){
+      assert(items[i].ret == SCIL_NO_ERR && items[i].dest != NULL && items[i].out_size > 0);
+    }
+  }
+
+  for(int i=0; i < ITEMS; i++){
+    free(items[i].dest);
+    free(items[i].source);
+  }
+  printf("OK\n");
+  return 0;
+}
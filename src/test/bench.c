@@ -0,0 +1,86 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The benchmark harness must stop once the mean is precise and report the percentiles of the measured times.
+#include <scil-bench.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct{
+  int calls;
+  int fail_at;
+  const double * times;
+  int count;
+} fake_t;
+
+// reports the given times one after another
+static int fake_run(void * arg, double * out_seconds){
+  fake_t * f = (fake_t*) arg;
+  if(f->calls == f->fail_at){
+    return 7;
+  }
+  *out_seconds = f->times[f->calls % f->count];
+  f->calls++;
+  return 0;
+}
+
+int main(){
+  scilU_bench_config_t config;
+  scilU_bench_config_init(& config);
+  scilU_bench_result_t result;
+
+  // constant times stop after the minimum repetitions, the warm-up is not measured
+  const double constant[] = {100, 100, 1, 1, 1, 1, 1, 1};
+  fake_t f = {0, -1, constant, 8};
+  int ret = scilU_bench_run(& config, fake_run, & f, & result);
+  assert(ret == 0);
+  assert(f.calls == config.warmup + config.min_repetitions);
+  assert(result.repetitions == config.min_repetitions);
+  assert(fabs(result.median - 1) < 1e-12 && fabs(result.mean - 1) < 1e-12);
+  assert(result.interval < 1e-12);
+
+  // noisy times repeat up to the limit, the percentiles ignore the outliers
+  const double noisy[] = {1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 100};
+  f = (fake_t){0, -1, noisy, 20};
+  config.warmup = 0;
+  config.max_repetitions = 20;
+  ret = scilU_bench_run(& config, fake_run, & f, & result);
+  assert(ret == 0);
+  printf("median %f p5 %f p95 %f interval %f\n", result.median, result.p5, result.p95, result.interval);
+  assert(result.repetitions == 20);
+  assert(fabs(result.median - 1.5) < 1e-12);
+  assert(fabs(result.p5 - 1) < 1e-12);
+  assert(result.p95 > 2 && result.p95 < 100);
+  assert(result.interval > 0.02 * result.mean);
+
+  // an error ends the benchmark
+  f = (fake_t){0, 3, noisy, 20};
+  ret = scilU_bench_run(& config, fake_run, & f, & result);
+  assert(ret == 7);
+
+  // the pages of the buffer are written
+  const size_t size = 1024 * 1024 + 3;
+  char * buffer = malloc(size);
+  scilU_bench_prefault(buffer, size);
+  assert(buffer[0] == 0 && buffer[size - 1] == 0);
+  free(buffer);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,121 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Large arrays pass the chain in blocks, the result must decompress like the unblocked one.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define X 100
+#define Y 70
+#define Z 30
+#define COUNT (X * Y * Z)
+
+static double data[COUNT];
+static double data_check[COUNT];
+
+static size_t compress(const char * chain, size_t block_size, const scil_dims_t * dims, double abstol){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  size_t out_size;
+  int ret;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = abstol;
+  hints.significant_bits = 30;
+  hints.force_compression_methods = (char*) chain;
+  ret = scilPr_create_context(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  // blocking is off by default, the plain chain format is kept for existing users
+  if(block_size > 0){
+    scilPr_set_block_size(ctx, block_size);
+  }
+
+  const size_t bound = scil_compress_bound(ctx, dims);
+  byte * buff = malloc(bound);
+  ret = scil_compress(buff, bound, data, (scil_dims_t*) dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  assert(out_size <= bound);
+
+  // the second call reuses the buffers of the first one
+  ret = scil_compress(buff, bound, data, (scil_dims_t*) dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+
+  // a single stage has no intermediate data, it is not split
+  const int blocked = block_size > 0 && strchr(chain, ',') != NULL;
+  assert((buff[0] == 255) == blocked);
+
+  byte * tmp = malloc(scilPr_get_compressed_data_size_limit(dims, SCIL_TYPE_DOUBLE));
+  memset(data_check, 0, sizeof(data_check));
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, (scil_dims_t*) dims, buff, out_size, tmp);
+  assert(ret == SCIL_NO_ERR);
+  const double tolerance = abstol > 0 ? abstol : fabs(ldexp(1, -29));
+  for(size_t i=0; i < scilPr_get_dims_count(dims); i++){
+    assert(fabs(data_check[i] - data[i]) <= tolerance * (1 + fabs(data[i])));
+  }
+
+  // the blocks are stored like tiles, thus a region can be extracted
+  if (dims->dims == 3){
+    scil_dims_t offset, count;
+    scilPr_initialize_dims_3d(& offset, 10, 20, 5);
+    scilPr_initialize_dims_3d(& count, 50, 30, 20);
+    ret = scil_decompress_region(SCIL_TYPE_DOUBLE, data_check, (scil_dims_t*) dims, & offset, & count, buff, out_size);
+    assert(ret == SCIL_NO_ERR);
+    for(int z=0; z < 20; z++){
+      for(int y=0; y < 30; y++){
+        for(int x=0; x < 50; x++){
+          const double expected = data[(x + 10) + X * ((y + 20) + Y * (z + 5))];
+          assert(fabs(data_check[x + 50 * (y + 30 * z)] - expected) <= tolerance * (1 + fabs(expected)));
+        }
+      }
+    }
+  }
+
+  printf("%s block size %zu: %zu bytes\n", chain, block_size, out_size);
+  free(tmp);
+  free(buff);
+  scilPr_destroy_context(ctx);
+  return out_size;
+}
+
+int main(){
+  for(int i=0; i < COUNT; i++){
+    // the trend gives each block another range
+    data[i] = sin(i / 1000.0) * 100 + cos(i / 7.0) + i / 10.0;
+  }
+
+  scil_dims_t dims3, dims1;
+  scilPr_initialize_dims_3d(& dims3, X, Y, Z);
+  scilPr_initialize_dims_1d(& dims1, COUNT);
+
+  // the preconditioner passes each block through the same intermediate buffer
+  const char * chains[] = {"abstol,lz4", "dummy-precond,abstol,lz4", "sigbits,lz4", "lz4"};
+  for(int c=0; c < 4; c++){
+    const double abstol = c < 2 ? 0.01 : 0;
+    const size_t whole = compress(chains[c], 0, & dims3, abstol);
+    const size_t blocked = compress(chains[c], SCIL_RECOMMENDED_BLOCK_SIZE, & dims3, abstol);
+    compress(chains[c], 10000, & dims3, abstol);
+    compress(chains[c], SCIL_RECOMMENDED_BLOCK_SIZE, & dims1, abstol);
+    // the headers of the blocks must not hurt the ratio much
+    assert(blocked < whole + whole / 10);
+  }
+
+  printf("OK\n");
+  return 0;
+}
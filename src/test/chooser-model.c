@@ -0,0 +1,136 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// The automatic selection must follow the trained model and skip the chains that do not honor the hints.
+#include <scil.h>
+#include <scil-chooser-model.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define COUNT 100000
+
+static double smooth[COUNT];
+static double noise[COUNT];
+
+// smooth data is compressed with lz4 or with a tolerance, fpzip is not honoring the hints or not available
+static const char* model =
+  "# node; feature; threshold; left; right\n"
+  "0; max_step; 0.1; 1; 2\n"
+  "1; abs_tol; 0; 3; 4\n"
+  "# node; leaf; chains ranked by the time\n"
+  "2; leaf; fpzip; memcopy\n"
+  "3; leaf; lz4\n"
+  "4; leaf; sigbits,lz4; abstol,lz4\n";
+
+static void write_file(const char* name, const char* content){
+  FILE* f = fopen(name, "w");
+  assert(f != NULL);
+  fputs(content, f);
+  fclose(f);
+}
+
+static void chosen_chain(const double* data, scil_user_hints_t* hints, char* out){
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, hints);
+  assert(ret == SCIL_NO_ERR);
+
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+  double* check = malloc(COUNT * sizeof(double));
+  size_t size;
+  ret = scil_compress(buff, bound, (double*) data, & dims, & size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scil_compression_sprint_last_algorithm_chain(ctx, out, 100);
+  printf("%s\n", out);
+
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, check, & dims, buff, size, NULL);
+  assert(ret == SCIL_NO_ERR);
+  for(int i=0; i < COUNT; i++){
+    assert(fabs(check[i] - data[i]) <= 0.01);
+  }
+  free(check);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  char file[] = "/tmp/scil-chooser-model-XXXXXX";
+  int fd = mkstemp(file);
+  assert(fd >= 0);
+  close(fd);
+  write_file(file, model);
+  setenv("SCIL_CHOOSER_MODEL_FILE", file, 1);
+
+  srand(1);
+  for(int i=0; i < COUNT; i++){
+    smooth[i] = sin(i / 1000.0);
+    noise[i] = rand() / (double) RAND_MAX;
+  }
+
+  scil_user_hints_t hints;
+  char chain[100];
+
+  scilPr_initialize_user_hints(& hints);
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "lz4") == 0);
+  chosen_chain(noise, & hints, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // the first chain of the leaf honoring the tolerance
+  hints.absolute_tolerance = 0.01;
+  chosen_chain(smooth, & hints, chain);
+  assert(strcmp(chain, "abstol,lz4") == 0);
+  chosen_chain(noise, & hints, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // the features are independent of the magnitude of the data
+  scilI_data_features_t data = {0, -100, 100, 0, 50, 2};
+  scil_dims_t dims;
+  scilPr_initialize_dims_2d(& dims, 256, 64);
+  float features[SCIL_MODEL_FEATURE_COUNT];
+  scilC_chooser_model_features(& data, & dims, & hints, features);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_DIMS] - 2) < 1e-6f);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_LOG2_COUNT] - 14) < 1e-6f);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_MEAN] - 0.5f) < 1e-6f);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_STDDEV] - 0.25f) < 1e-6f);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_MAX_STEP] - 0.01f) < 1e-6f);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_ABS_TOL] - 0.00005f) < 1e-9f);
+  assert(fabsf(features[SCIL_MODEL_FEATURE_REL_TOL] - 0) < 1e-6f);
+  const int* ranking;
+  assert(scilC_chooser_model_evaluate(features, & ranking) == 2);
+  assert(strcmp(scilC_chooser_model_chain(ranking[0]), "sigbits,lz4") == 0);
+
+  // a node must refer to nodes behind it, otherwise the tree could contain a cycle
+  write_file(file, "0; stddev; 0.5; 1; 2\n1; leaf; lz4\n2; mean; 0.5; 1; 3\n3; leaf; memcopy\n");
+  assert(scilC_chooser_model_load(file) == SCIL_EINVAL);
+  assert(! scilC_chooser_model_loaded());
+  assert(scilC_chooser_model_evaluate(features, & ranking) == 0);
+  write_file(file, "0; stddev; 0.5; 1; 2\n1; leaf; lz4\n");
+  assert(scilC_chooser_model_load(file) == SCIL_EINVAL);
+  write_file(file, "0; variance; 0.5; 1; 2\n1; leaf; lz4\n2; leaf; lz4\n");
+  assert(scilC_chooser_model_load(file) == SCIL_EINVAL);
+
+  unlink(file);
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,97 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// A destination buffer of exactly scil_compress_bound() bytes must suffice.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 10000
+
+static double data[COUNT];
+static double data_check[COUNT];
+
+static void test(const char * chain, double abstol, scil_dims_t * tile){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t out_size;
+  int ret;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = abstol;
+  hints.force_compression_methods = (char*) chain;
+  ret = scilPr_create_context(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  ret = scilPr_set_tiling(ctx, tile, 2);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_initialize_dims_1d(& dims, COUNT);
+
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  printf("%s bound: %zu input: %zu\n", chain ? chain : "automatic", bound, sizeof(data));
+  assert(bound < scilPr_get_compressed_data_size_limit(& dims, SCIL_TYPE_DOUBLE));
+
+  byte * buff = malloc(bound);
+  if (chain != NULL){
+    ret = scil_compress(buff, bound - 1, data, & dims, & out_size, ctx);
+    assert(ret == SCIL_MEMORY_ERR);
+  }
+  ret = scil_compress(buff, bound, data, & dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  assert(out_size <= bound);
+  // the chosen chain may have a tighter bound
+  assert(scil_compress_bound(ctx, & dims) <= bound);
+
+  byte * tmp = malloc(scilPr_get_compressed_data_size_limit(& dims, SCIL_TYPE_DOUBLE));
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & dims, buff, out_size, tmp);
+  assert(ret == SCIL_NO_ERR);
+  for(int i=0; i < COUNT; i++){
+    assert(fabs(data_check[i] - data[i]) <= abstol);
+  }
+
+  free(tmp);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  // random data is the worst case for the byte compressors
+  srand(4711);
+  for(int i=0; i < COUNT; i++){
+    data[i] = rand() / (double) RAND_MAX;
+  }
+
+  scil_dims_t tile;
+  scilPr_initialize_dims_1d(& tile, 999);
+
+  test("memcopy", 0, NULL);
+  test("lz4", 0, NULL);
+  test("gzip", 0, NULL);
+  test("abstol", 0.001, NULL);
+  test("abstol,lz4", 0.001, NULL);
+  test("dummy-precond,dummy-precond,lz4", 0, NULL);
+  test("lz4", 0, & tile);
+  test("abstol", 0.001, & tile);
+
+  // without a forced chain the bound covers every choice of the chooser
+  test(NULL, 0, NULL);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,172 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// The single pass statistics must match a straightforward scan of the data.
+#include <scil.h>
+#include <scil-data-stats.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+#define COUNT 1003
+
+static double data[COUNT];
+static float data_float[COUNT];
+static int16_t data_int[COUNT];
+
+static int equal(double a, double b){
+  return ! (a < b || a > b);
+}
+
+static void check_double(size_t count){
+  double min = INFINITY, max = -INFINITY;
+  int min_sign = 1, max_sign = 0, min_exp = 0x7fff, max_exp = -0x7fff;
+  size_t nans = 0, infs = 0;
+  for(size_t i=0; i < count; i++){
+    datatype_cast_double cur;
+    cur.f = data[i];
+    if (cur.f < min) min = cur.f;
+    if (cur.f > max) max = cur.f;
+    if (cur.p.sign < min_sign) min_sign = cur.p.sign;
+    if (cur.p.sign > max_sign) max_sign = cur.p.sign;
+    if (cur.p.exponent < min_exp) min_exp = cur.p.exponent;
+    if (cur.p.exponent > max_exp) max_exp = cur.p.exponent;
+    nans += isnan(cur.f) != 0;
+    infs += isinf(cur.f) != 0;
+  }
+
+  scilI_data_stats_t stats;
+  scilI_data_stats_double(data, count, & stats);
+  assert(stats.count == count);
+  assert(equal(stats.minimum, min) && equal(stats.maximum, max));
+  assert(stats.minimum_sign == min_sign && stats.maximum_sign == max_sign);
+  assert(stats.minimum_exponent == min_exp && stats.maximum_exponent == max_exp);
+  assert(stats.nan_count == nans && stats.inf_count == infs);
+}
+
+static void check_float(size_t count){
+  float min = INFINITY, max = -INFINITY;
+  int min_sign = 1, max_sign = 0, min_exp = 0x7fff, max_exp = -0x7fff;
+  size_t nans = 0, infs = 0;
+  for(size_t i=0; i < count; i++){
+    datatype_cast_float cur;
+    cur.f = data_float[i];
+    if (cur.f < min) min = cur.f;
+    if (cur.f > max) max = cur.f;
+    if (cur.p.sign < min_sign) min_sign = cur.p.sign;
+    if (cur.p.sign > max_sign) max_sign = cur.p.sign;
+    if (cur.p.exponent < min_exp) min_exp = cur.p.exponent;
+    if (cur.p.exponent > max_exp) max_exp = cur.p.exponent;
+    nans += isnan(cur.f) != 0;
+    infs += isinf(cur.f) != 0;
+  }
+
+  scilI_data_stats_t stats;
+  scilI_data_stats_float(data_float, count, & stats);
+  float smin, smax;
+  scilI_data_stats_minmax_float(& stats, & smin, & smax);
+  assert(equal(smin, min) && equal(smax, max));
+  assert(stats.minimum_sign == min_sign && stats.maximum_sign == max_sign);
+  assert(stats.minimum_exponent == min_exp && stats.maximum_exponent == max_exp);
+  assert(stats.nan_count == nans && stats.inf_count == infs);
+}
+
+static void check_int(size_t count){
+  int16_t min = INT16_MAX, max = INT16_MIN;
+  for(size_t i=0; i < count; i++){
+    if (data_int[i] < min) min = data_int[i];
+    if (data_int[i] > max) max = data_int[i];
+  }
+  scilI_data_stats_t stats;
+  scilI_data_stats_int16_t(data_int, count, & stats);
+  int16_t smin, smax;
+  scilI_data_stats_minmax_int16_t(& stats, & smin, & smax);
+  assert(smin == min && smax == max);
+}
+
+static void fill(double sign_mix, int special){
+  for(int i=0; i < COUNT; i++){
+    double value = ldexp(rand() / (double) RAND_MAX, rand() % 200 - 100);
+    if (rand() / (double) RAND_MAX < sign_mix) value = -value;
+    data[i] = value;
+    data_float[i] = (float) value;
+    data_int[i] = (int16_t) (rand() - RAND_MAX / 2);
+  }
+  if (special){
+    data[17] = NAN;
+    data[500] = INFINITY;
+    data[COUNT - 1] = -INFINITY;
+    data_float[3] = NAN;
+    data_float[COUNT - 2] = NAN;
+    data_float[100] = -INFINITY;
+  }
+}
+
+static void test_context_cache(){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t out_size;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.01;
+  hints.force_compression_methods = "abstol";
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+
+  fill(0, 0);
+  const scilI_data_stats_t* stats = scilI_context_data_stats(ctx, data, COUNT);
+  const double maximum = stats->maximum;
+  assert(scilI_context_data_stats(ctx, data, COUNT) == stats);
+
+  // compressing changed data behind the same pointer must not use the cached statistics
+  for(int i=0; i < COUNT; i++){
+    data[i] = maximum * 2 + i;
+  }
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+  ret = scil_compress(buff, bound, data, & dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  assert(equal(scilI_context_data_stats(ctx, data, COUNT)->maximum, maximum * 2 + COUNT - 1));
+
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  srand(4711);
+  for(int special=0; special <= 1; special++){
+    fill(0, special);
+    for(size_t count=0; count < 20; count++){
+      check_double(count);
+      check_float(count);
+      check_int(count);
+    }
+    for(double mix = 0; mix <= 1; mix += 0.5){
+      fill(mix, special);
+      check_double(COUNT);
+      check_float(COUNT);
+      check_int(COUNT);
+    }
+  }
+  test_context_cache();
+
+  printf("OK\n");
+  return 0;
+}
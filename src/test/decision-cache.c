@@ -0,0 +1,108 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// New contexts for a known variable must reuse the decision of the chooser until the data drifts.
+#include <scil.h>
+#include <scil-decision-cache.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define COUNT 100000
+
+static double smooth[COUNT];
+static double noise[COUNT];
+
+// compresses the data with a new context and returns the chain
+static void compress(const char* id, const double* data, size_t count, char* chain){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  scilPr_initialize_user_hints(& hints);
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  ret = scilPr_set_variable_id(ctx, id);
+  assert(ret == SCIL_NO_ERR);
+
+  scilPr_initialize_dims_1d(& dims, count);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+  size_t size;
+  ret = scil_compress(buff, bound, (double*) data, & dims, & size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scil_compression_sprint_last_algorithm_chain(ctx, chain, 100);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  char chain[100];
+  srand(1);
+  for(int i=0; i < COUNT; i++){
+    uint64_t bits = ((uint64_t) rand() << 33) ^ ((uint64_t) rand() << 11) ^ (uint64_t) rand();
+    memcpy(& noise[i], & bits, sizeof(double));
+    smooth[i] = (double) (i / 100);
+  }
+
+  compress("temperature", smooth, COUNT, chain);
+  assert(strcmp(chain, "lz4") == 0);
+  compress("pressure", noise, COUNT, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // the data is not examined for a cached decision
+  for(int i=1; i < SCIL_DECISION_CACHE_REVALIDATE; i++){
+    compress("temperature", noise, COUNT, chain);
+    assert(strcmp(chain, "lz4") == 0);
+  }
+  // other dimensions or no ID are not cached
+  compress("temperature", noise, COUNT - 1, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+  compress(NULL, noise, COUNT, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // the check detects the drift
+  compress("temperature", noise, COUNT, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+  compress("temperature", smooth, COUNT, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+
+  // a stable variable keeps its decision after the check
+  for(int i=0; i < 2 * SCIL_DECISION_CACHE_REVALIDATE; i++){
+    compress("pressure", noise, COUNT, chain);
+    assert(strcmp(chain, "memcopy") == 0);
+  }
+
+  // the decisions survive a restart
+  char file[] = "/tmp/scil-decision-cache-XXXXXX";
+  int fd = mkstemp(file);
+  assert(fd >= 0);
+  close(fd);
+  int ret = scilC_decision_cache_save(file);
+  assert(ret == SCIL_NO_ERR);
+  scilC_decision_cache_reset();
+  compress("temperature", smooth, COUNT, chain);
+  assert(strcmp(chain, "lz4") == 0);
+  ret = scilC_decision_cache_load(file);
+  assert(ret == SCIL_NO_ERR);
+  compress("temperature", smooth, COUNT, chain);
+  assert(strcmp(chain, "memcopy") == 0);
+  unlink(file);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,109 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// Single stage chains decode directly into the destination, corrupt input must fail without writing behind it.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 10000
+#define GUARD 4096
+
+static double data[COUNT];
+static byte dest[COUNT * sizeof(double) + GUARD];
+static byte corrupt[3 * COUNT * sizeof(double)];
+
+static void check_guard(){
+  for(int i=0; i < GUARD; i++){
+    assert(dest[COUNT * sizeof(double) + i] == 0xAA);
+  }
+}
+
+static int decompress(scil_dims_t* dims, byte* source, size_t size){
+  memset(dest, 0xAA, sizeof(dest));
+  int ret = scil_decompress(SCIL_TYPE_DOUBLE, dest, dims, source, size, NULL);
+  check_guard();
+  return ret;
+}
+
+int main(){
+  for(int i=0; i < COUNT; i++){
+    data[i] = i % 100;
+  }
+  scil_dims_t dims;
+  scilPr_initialize_dims_1d(& dims, COUNT);
+
+  const char * chains[] = {"lz4", "memcopy"};
+  for(int c=0; c < 2; c++){
+    scil_user_hints_t hints;
+    scil_context_t* ctx;
+    scilPr_initialize_user_hints(& hints);
+    hints.force_compression_methods = (char*) chains[c];
+    int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+    assert(ret == SCIL_NO_ERR);
+
+    const size_t bound = scil_compress_bound(ctx, & dims);
+    byte* compressed = malloc(bound);
+    size_t size;
+    ret = scil_compress(compressed, bound, data, & dims, & size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    assert(compressed[0] == 1);
+
+    ret = decompress(& dims, compressed, size);
+    assert(ret == SCIL_NO_ERR);
+    assert(memcmp(dest, data, sizeof(data)) == 0);
+
+    // more data than the destination holds, the last byte is the id of the algorithm
+    const size_t payload = size - 2;
+    memcpy(corrupt, compressed, size - 1);
+    memcpy(corrupt + size - 1, compressed + 1, payload);
+    corrupt[size - 1 + payload] = compressed[size - 1];
+    if(c == 0){
+      // the stored size of lz4 promises the doubled data
+      const int doubled = 2 * COUNT * sizeof(double);
+      memcpy(corrupt + 1, & doubled, sizeof(int));
+    }
+    ret = decompress(& dims, corrupt, size + payload);
+    printf("%s enlarged: %d\n", chains[c], ret);
+    assert(ret != SCIL_NO_ERR);
+
+    if(c == 0){
+      // truncated data
+      memcpy(corrupt, compressed, size / 2);
+      corrupt[size / 2] = compressed[size - 1];
+      ret = decompress(& dims, corrupt, size / 2 + 1);
+      printf("%s truncated: %d\n", chains[c], ret);
+      assert(ret != SCIL_NO_ERR);
+
+      // garbage behind the stored size
+      memcpy(corrupt, compressed, size);
+      srand(1);
+      for(size_t i=5; i < size - 1; i++){
+        corrupt[i] = (byte) rand();
+      }
+      ret = decompress(& dims, corrupt, size);
+      printf("%s garbage: %d\n", chains[c], ret);
+    }
+
+    free(compressed);
+    scilPr_destroy_context(ctx);
+  }
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,218 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Decompression must work with exactly the reported scratch size and without a scratch buffer at all.
+// Without a scratch buffer the buffers of the thread are reused, consecutive calls must not see each other's data.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 10000
+
+static double data[COUNT];
+static double data_check[COUNT];
+
+static void check(const char * chain, int stages, size_t tile){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t out_size;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.001;
+  hints.force_compression_methods = (char*) chain;
+  int ret = scilPr_create_context(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  if (tile > 0){
+    scil_dims_t tiles;
+    scilPr_initialize_dims_1d(& tiles, tile);
+    ret = scilPr_set_tiling(ctx, & tiles, 2);
+    assert(ret == SCIL_NO_ERR);
+  }
+
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte * buff = malloc(bound);
+  ret = scil_compress(buff, bound, data, & dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+
+  const size_t scratch = scil_decompress_scratch_size(SCIL_TYPE_DOUBLE, & dims, buff, out_size);
+  printf("%s tile %zu: scratch %zu bytes\n", chain, tile, scratch);
+  assert((scratch == 0) == (stages == 1 || tile > 0));
+
+  // an exactly sized buffer, the address sanitizer detects accesses behind it
+  byte * tmp = scratch > 0 ? malloc(scratch) : NULL;
+  for(int with_buffer = 0; with_buffer <= 1; with_buffer++){
+    memset(data_check, 0, sizeof(data_check));
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & dims, buff, out_size, with_buffer ? tmp : NULL);
+    assert(ret == SCIL_NO_ERR);
+    for(int i=0; i < COUNT; i++){
+      assert(fabs(data_check[i] - data[i]) <= 0.001);
+    }
+  }
+
+  free(tmp);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+#define INPUTS 3
+#define PLANE 100
+
+static byte * streams[INPUTS];
+static size_t stream_size[INPUTS];
+static size_t stream_limit;
+static size_t in_pos;
+static const double * expected;
+
+static int write_memory(void * user, const byte * buff, size_t size){
+  const int k = *(int*) user;
+  if(stream_size[k] + size > stream_limit){
+    return 1;
+  }
+  memcpy(streams[k] + stream_size[k], buff, size);
+  stream_size[k] += size;
+  return 0;
+}
+
+static int read_memory(void * user, byte * buff, size_t size){
+  const int k = *(int*) user;
+  if(in_pos + size > stream_size[k]){
+    return 1;
+  }
+  memcpy(buff, streams[k] + in_pos, size);
+  in_pos += size;
+  return 0;
+}
+
+static int sink_check(void * user, const void * slab, size_t first_plane, size_t planes){
+  const double * values = (const double*) slab;
+  for(size_t i=0; i < planes * PLANE; i++){
+    assert(fabs(values[i] - expected[first_plane * PLANE + i]) <= 0.001);
+  }
+  return 0;
+}
+
+// compresses different inputs and decompresses them in turns without a scratch buffer
+static void check_sequence(const char * chain, size_t tile){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.001;
+  hints.force_compression_methods = (char*) chain;
+  int ret = scilPr_create_context(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  if (tile > 0){
+    scil_dims_t tiles;
+    scilPr_initialize_dims_1d(& tiles, tile);
+    ret = scilPr_set_tiling(ctx, & tiles, 2);
+    assert(ret == SCIL_NO_ERR);
+  }
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+
+  // each input and each frame of a stream has another range, stale minima or maxima would shift the values
+  static double inputs[INPUTS][COUNT];
+  byte * buff[INPUTS];
+  size_t out_size[INPUTS];
+  int ids[INPUTS];
+  scil_dims_t stream_dims;
+  scilPr_initialize_dims_2d(& stream_dims, PLANE, COUNT / PLANE);
+  stream_limit = 2 * bound;
+  for(int k=0; k < INPUTS; k++){
+    for(int i=0; i < COUNT; i++){
+      inputs[k][i] = sin(i / (50.0 * (k + 1))) * 10 * (k + 1) + 1000 * k + i / 100.0;
+    }
+    buff[k] = malloc(bound);
+    ret = scil_compress(buff[k], bound, inputs[k], & dims, & out_size[k], ctx);
+    assert(ret == SCIL_NO_ERR);
+
+    if (tile == 0){
+      ids[k] = k;
+      streams[k] = malloc(stream_limit);
+      stream_size[k] = 0;
+      scil_compress_stream_t * stream;
+      ret = scil_compress_stream_begin(& stream, ctx, & stream_dims, 10 * PLANE * sizeof(double), write_memory, & ids[k]);
+      assert(ret == SCIL_NO_ERR);
+      ret = scil_compress_stream_append(stream, inputs[k], COUNT / PLANE);
+      assert(ret == SCIL_NO_ERR);
+      ret = scil_compress_stream_finish(stream, NULL);
+      assert(ret == SCIL_NO_ERR);
+    }
+  }
+
+  const int order[] = {0, 1, 2, 0, 2, 1, 1, 0};
+  for(unsigned n=0; n < sizeof(order) / sizeof(int); n++){
+    const int k = order[n];
+    memset(data_check, 0, sizeof(data_check));
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & dims, buff[k], out_size[k], NULL);
+    assert(ret == SCIL_NO_ERR);
+    for(int i=0; i < COUNT; i++){
+      assert(fabs(data_check[i] - inputs[k][i]) <= 0.001);
+    }
+    if (tile > 0){
+      // the region reader decodes the tiles the same way
+      scil_dims_t offset, count;
+      scilPr_initialize_dims_1d(& offset, 1500);
+      scilPr_initialize_dims_1d(& count, 3000);
+      ret = scil_decompress_region(SCIL_TYPE_DOUBLE, data_check, & dims, & offset, & count, buff[k], out_size[k]);
+      assert(ret == SCIL_NO_ERR);
+      for(int i=0; i < 3000; i++){
+        assert(fabs(data_check[i] - inputs[k][i + 1500]) <= 0.001);
+      }
+    }else{
+      // the frames of a stream are decoded one after another
+      in_pos = 0;
+      expected = inputs[k];
+      ret = scil_decompress_stream(SCIL_TYPE_DOUBLE, & stream_dims, read_memory, & ids[k], sink_check, NULL);
+      assert(ret == SCIL_NO_ERR);
+    }
+  }
+  printf("%s tile %zu: %d inputs in turns\n", chain, tile, INPUTS);
+
+  for(int k=0; k < INPUTS; k++){
+    free(buff[k]);
+    if (tile == 0){
+      free(streams[k]);
+    }
+  }
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  for(int i=0; i < COUNT; i++){
+    data[i] = sin(i / 100.0) * 10;
+  }
+
+  check("memcopy", 1, 0);
+  check("lz4", 1, 0);
+  check("abstol", 1, 0);
+  check("abstol,lz4", 2, 0);
+  check("dummy-precond,abstol,lz4", 3, 0);
+  check("abstol,lz4", 2, 1000);
+
+  check_sequence("abstol,lz4", 0);
+  check_sequence("dummy-precond,abstol,lz4", 0);
+  check_sequence("dummy-precond,abstol,lz4", 1000);
+
+  printf("OK\n");
+  return 0;
+}
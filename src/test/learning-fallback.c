@@ -0,0 +1,112 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+// With learning a lossy chain that fails for the data must not be tried first by every new context.
+#include <scil.h>
+#include <scil-algo-learning.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define COUNT (64 * 1024)
+#define CONTEXTS 8
+#define CALLS 12
+
+static double data[COUNT];
+static char stats[] = "/tmp/scil-learning-fallback-XXXXXX";
+
+static const char* configuration =
+  "!storage 100\n"
+  "0; memcopy; 10000; 10000; 1\n"
+  "0; lz4; 2000; 4000; 0.4\n"
+  "0; abstol,lz4; 500; 1000; 0.05\n";
+
+// registered before the library writes the statistics at exit, thus it runs afterwards
+static void remove_statistics(){
+  unlink(stats);
+}
+
+static uint32_t observations(const char* chain){
+  scilC_learned_t learned;
+  if(! scilC_learning_lookup(chain, SCIL_TYPE_DOUBLE, sizeof(data), & learned)){
+    return 0;
+  }
+  return learned.count;
+}
+
+int main(){
+  char conf[] = "/tmp/scil-learning-fallback-conf-XXXXXX";
+  int fd = mkstemp(conf);
+  assert(fd >= 0);
+  assert(write(fd, configuration, strlen(configuration)) == (ssize_t) strlen(configuration));
+  close(fd);
+  fd = mkstemp(stats);
+  assert(fd >= 0);
+  close(fd);
+  unlink(stats);
+  atexit(remove_statistics);
+  setenv("SCIL_SYSTEM_CHARACTERISTICS_FILE", conf, 1);
+  setenv("SCIL_LEARNED_STATISTICS_FILE", stats, 1);
+
+  // abstol cannot quantize this range with this tolerance in 53 bits
+  scil_user_hints_t hints;
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 1e-12;
+  for(int i=0; i < COUNT; i++){
+    data[i] = floor(sin(i / 1000.0) * 10) * 1e4;
+  }
+  scil_dims_t dims;
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  double* check = malloc(sizeof(data));
+
+  int fallbacks = 0;
+  for(int c=0; c < CONTEXTS; c++){
+    scil_context_t* ctx;
+    int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+    assert(ret == SCIL_NO_ERR);
+    assert(scilC_learning_enabled());
+    const size_t bound = scil_compress_bound(ctx, & dims);
+    byte* buff = malloc(bound);
+    for(int i=0; i < CALLS; i++){
+      const uint32_t failed_before = observations("abstol,lz4");
+      const uint32_t lz4_before = observations("lz4");
+      size_t size;
+      ret = scil_compress(buff, bound, data, & dims, & size, ctx);
+      assert(ret == SCIL_NO_ERR);
+      ret = scil_decompress(SCIL_TYPE_DOUBLE, check, & dims, buff, size, NULL);
+      assert(ret == SCIL_NO_ERR);
+      assert(memcmp(check, data, sizeof(data)) == 0);
+      if(observations("abstol,lz4") > failed_before){
+        // the failure is recorded together with the compression by lz4
+        assert(observations("lz4") > lz4_before);
+        fallbacks++;
+      }
+    }
+    free(buff);
+    scilPr_destroy_context(ctx);
+  }
+  // the failed chain was tried once as unobserved chain, only the exploration of a context may try it again
+  printf("fallbacks: %d of %d calls\n", fallbacks, CONTEXTS * CALLS);
+  assert(fallbacks >= 1);
+  assert(fallbacks <= 1 + CONTEXTS * CALLS / SCIL_LEARNING_DECISION_INTERVAL / SCIL_LEARNING_EXPLORE_INTERVAL);
+
+  free(check);
+  unlink(conf);
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,126 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// With learning the chooser must follow the data when it becomes incompressible.
+#include <scil.h>
+#include <scil-algo-learning.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define COUNT (512 * 1024)
+#define CALLS 64
+
+static double data[COUNT];
+static char stats[] = "/tmp/scil-learning-XXXXXX";
+
+// registered before the library writes the statistics at exit, thus it runs afterwards
+static void remove_statistics(){
+  FILE* f = fopen(stats, "r");
+  assert(f != NULL);
+  char line[1024];
+  int lines = 0;
+  while(fgets(line, sizeof(line), f) != NULL){
+    lines++;
+  }
+  fclose(f);
+  assert(lines > 1);
+  unlink(stats);
+}
+
+// compresses the data CALLS times and returns how often lz4 was used in the last quarter
+static int compress_repeatedly(scil_context_t* ctx, byte* buff){
+  scil_dims_t dims;
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  int lz4 = 0;
+  for(int i=0; i < CALLS; i++){
+    size_t size;
+    int ret = scil_compress(buff, bound, data, & dims, & size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    char chain[100];
+    scil_compression_sprint_last_algorithm_chain(ctx, chain, sizeof(chain));
+    if(i >= CALLS * 3 / 4 && strcmp(chain, "lz4") == 0){
+      lz4++;
+    }
+  }
+  return lz4;
+}
+
+int main(){
+  // the storage is slow, thus the ratio decides
+  char conf[] = "/tmp/scil-learning-conf-XXXXXX";
+  int fd = mkstemp(conf);
+  assert(fd >= 0);
+  assert(write(fd, "!storage 50\n", 12) == 12);
+  close(fd);
+  fd = mkstemp(stats);
+  assert(fd >= 0);
+  close(fd);
+  unlink(stats);
+  atexit(remove_statistics);
+  setenv("SCIL_SYSTEM_CHARACTERISTICS_FILE", conf, 1);
+  setenv("SCIL_LEARNED_STATISTICS_FILE", stats, 1);
+
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scilPr_initialize_user_hints(& hints);
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  assert(scilC_learning_enabled());
+
+  scil_dims_t dims;
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  byte* buff = malloc(scilPr_get_compressed_data_size_limit(& dims, SCIL_TYPE_DOUBLE) * 2);
+
+  for(int i=0; i < COUNT; i++){
+    data[i] = (double) (i / 64);
+  }
+  int lz4 = compress_repeatedly(ctx, buff);
+  printf("compressible: lz4 %d of %d\n", lz4, CALLS / 4);
+  assert(lz4 >= CALLS / 4 - 4);
+
+  // the data drifts, lz4 no longer reduces the I/O
+  srand(1);
+  for(int i=0; i < COUNT; i++){
+    uint64_t bits = ((uint64_t) rand() << 33) ^ ((uint64_t) rand() << 11) ^ (uint64_t) rand();
+    memcpy(& data[i], & bits, sizeof(double));
+  }
+  lz4 = compress_repeatedly(ctx, buff);
+  printf("random: lz4 %d of %d\n", lz4, CALLS / 4);
+  assert(lz4 <= 4);
+  scilPr_destroy_context(ctx);
+
+  // the statistics survive a restart
+  scilC_learned_t before, after;
+  assert(scilC_learning_lookup("lz4", SCIL_TYPE_DOUBLE, COUNT * sizeof(double), & before));
+  ret = scilC_learning_save(stats);
+  assert(ret == SCIL_NO_ERR);
+  scilC_learning_reset();
+  assert(! scilC_learning_lookup("lz4", SCIL_TYPE_DOUBLE, COUNT * sizeof(double), & after));
+  ret = scilC_learning_load(stats);
+  assert(ret == SCIL_NO_ERR);
+  assert(scilC_learning_lookup("lz4", SCIL_TYPE_DOUBLE, COUNT * sizeof(double), & after));
+  assert(after.count == before.count);
+  assert(after.ratio > before.ratio - 0.001f && after.ratio < before.ratio + 0.001f);
+
+  free(buff);
+  unlink(conf);
+  printf("OK\n");
+  return 0;
+}
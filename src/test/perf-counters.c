@@ -0,0 +1,55 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The hardware counters count the calling thread, if the machine provides them.
+#include <scil-perf.h>
+
+#include <assert.h>
+#include <stdio.h>
+
+int main(){
+  scilU_perf_t perf;
+  uint64_t values[SCILU_PERF_COUNTERS] = {0};
+  const int available = scilU_perf_open(& perf);
+  printf("%d counters available\n", available);
+
+  scilU_perf_start(& perf);
+  volatile double sum = 0;
+  for(int i=0; i < 1000000; i++){
+    sum += i;
+  }
+  scilU_perf_stop(& perf, values);
+
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    printf("%s: %llu\n", scilU_perf_counter_name((enum scilU_perf_counter) i), (unsigned long long) values[i]);
+    if(perf.fd[i] < 0){
+      assert(values[i] == 0);
+    }
+  }
+  if(perf.fd[SCILU_PERF_INSTRUCTIONS] >= 0){
+    assert(values[SCILU_PERF_INSTRUCTIONS] >= 1000000);
+  }
+
+  // the values are added up
+  const uint64_t first = values[SCILU_PERF_INSTRUCTIONS];
+  scilU_perf_start(& perf);
+  scilU_perf_stop(& perf, values);
+  assert(values[SCILU_PERF_INSTRUCTIONS] >= first);
+
+  scilU_perf_close(& perf);
+  printf("OK\n");
+  return 0;
+}
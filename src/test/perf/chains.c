@@ -0,0 +1,110 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The compression and decompression throughput of every registered chain on the standard patterns.
+// Chains that cannot be used with the hints, e.g. swage, which needs a quantizer before it, are skipped.
+#include <perf.h>
+
+#include <scil.h>
+#include <scil-compressors.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <stdio.h>
+
+#define X 512
+#define Y 512
+
+static double data[X * Y];
+static double decompressed[X * Y];
+
+typedef struct{
+  scil_context_t * ctx;
+  scil_dims_t dims;
+  byte * compressed;
+  byte * tmp;
+  size_t buff_size;
+  size_t compressed_size;
+} chain_run_t;
+
+static int run_compress(void* arg, double* out_seconds){
+  chain_run_t * r = (chain_run_t*) arg;
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  int ret = scil_compress(r->compressed, r->buff_size, data, & r->dims, & r->compressed_size, r->ctx);
+  *out_seconds = scilU_stop_timer(timer);
+  return ret;
+}
+
+static int run_decompress(void* arg, double* out_seconds){
+  chain_run_t * r = (chain_run_t*) arg;
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  int ret = scil_decompress(SCIL_TYPE_DOUBLE, decompressed, & r->dims, r->compressed, r->compressed_size, r->tmp);
+  *out_seconds = scilU_stop_timer(timer);
+  return ret;
+}
+
+int main(int argc, char** argv){
+  perf_init(argc, argv);
+
+  chain_run_t r;
+  scilPr_initialize_dims_2d(& r.dims, X, Y);
+  r.buff_size = scilPr_get_compressed_data_size_limit(& r.dims, SCIL_TYPE_DOUBLE);
+  r.compressed = (byte*) malloc(r.buff_size);
+  r.tmp = (byte*) malloc(r.buff_size);
+  scilU_bench_prefault(r.compressed, r.buff_size);
+  scilU_bench_prefault(r.tmp, r.buff_size);
+
+  // the tolerances suit the range of the patterns, the lossless chains ignore them
+  scil_user_hints_t hints;
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.01;
+  hints.relative_tolerance_percent = 1;
+  hints.significant_bits = 16;
+
+  for(int i=0; i < scilU_get_available_compressor_count(); i++){
+    const char * chain = scilU_get_compressor_name(i);
+    char compression_name[100];
+    sprintf(compression_name, "%s", chain);
+    hints.force_compression_methods = compression_name;
+    if(scilPr_create_context(& r.ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints) != SCIL_NO_ERR){
+      printf("%-40s not applicable\n", chain);
+      continue;
+    }
+    for(int p=0; p < perf_pattern_count; p++){
+      char c_name[100], d_name[100];
+      sprintf(c_name, "compress-%s-%s", chain, perf_patterns[p]);
+      sprintf(d_name, "decompress-%s-%s", chain, perf_patterns[p]);
+      if(! perf_selected(c_name) && ! perf_selected(d_name)){
+        continue;
+      }
+      int ret = perf_create_pattern(data, SCIL_TYPE_DOUBLE, & r.dims, perf_patterns[p]);
+      assert(ret == SCIL_NO_ERR);
+      // the decompression needs compressed data even if only it is selected
+      double seconds;
+      ret = perf_selected(c_name) ? perf_run(c_name, run_compress, & r, sizeof(data)) : run_compress(& r, & seconds);
+      if(ret == SCIL_NO_ERR){
+        perf_run(d_name, run_decompress, & r, sizeof(data));
+      }
+    }
+    scilPr_destroy_context(r.ctx);
+  }
+  free(r.compressed);
+  free(r.tmp);
+  return perf_finish();
+}
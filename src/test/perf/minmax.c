@@ -0,0 +1,79 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The throughput of the minimum and maximum scans for every datatype.
+#include <perf.h>
+
+#include <scil-quantizer.h>
+#include <scil-util.h>
+
+#include <stdio.h>
+
+#define COUNT (1024 * 1024)
+
+// large enough for COUNT values of any datatype
+static double data[COUNT];
+
+#define MINMAX(type) \
+static void fill_##type(){ \
+  type * values = (type*) data; \
+  for(size_t i=0; i < COUNT; i++){ \
+    values[i] = (type) (rand() % 100 - 50); \
+  } \
+} \
+static int run_##type(void* arg, double* out_seconds){ \
+  type mn, mx; \
+  scil_timer timer; \
+  scilU_start_timer(& timer); \
+  scil_find_minimum_maximum_##type((const type*) data, COUNT, & mn, & mx); \
+  *out_seconds = scilU_stop_timer(timer); \
+  return mn > mx; \
+}
+
+MINMAX(int8_t)
+MINMAX(int16_t)
+MINMAX(int32_t)
+MINMAX(int64_t)
+MINMAX(float)
+MINMAX(double)
+
+typedef struct{
+  const char * name;
+  void (*fill)();
+  scilU_bench_func_t func;
+  size_t size;
+} kernel_t;
+
+int main(int argc, char** argv){
+  perf_init(argc, argv);
+
+  const kernel_t kernels[] = {
+    {"minmax-int8", fill_int8_t, run_int8_t, sizeof(int8_t)},
+    {"minmax-int16", fill_int16_t, run_int16_t, sizeof(int16_t)},
+    {"minmax-int32", fill_int32_t, run_int32_t, sizeof(int32_t)},
+    {"minmax-int64", fill_int64_t, run_int64_t, sizeof(int64_t)},
+    {"minmax-float", fill_float, run_float, sizeof(float)},
+    {"minmax-double", fill_double, run_double, sizeof(double)}
+  };
+  for(unsigned k=0; k < sizeof(kernels) / sizeof(kernel_t); k++){
+    if(perf_selected(kernels[k].name)){
+      srand(1);
+      kernels[k].fill();
+      perf_run(kernels[k].name, kernels[k].func, NULL, COUNT * kernels[k].size);
+    }
+  }
+  return perf_finish();
+}
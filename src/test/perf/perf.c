@@ -0,0 +1,311 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <perf.h>
+
+#include <scil-error.h>
+#include <scil-patterns.h>
+
+#include <scil-util.h>
+
+#include <math.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_ENTRIES 1024
+#define NAME_LENGTH 100
+#define RETRIES 2
+// a new process gets other pages for the data, which changes the speed of some kernels on shared machines
+#define PROCESS_ATTEMPTS 3
+#define REFERENCE_COUNT (1024 * 1024)
+
+// the throughput relative to the reference
+typedef struct{
+  char name[NAME_LENGTH];
+  double relative;
+} entry_t;
+
+static const char * baseline_file;
+static entry_t baseline[MAX_ENTRIES];
+static int baseline_count = 0;
+
+static entry_t measured[MAX_ENTRIES];
+static int measured_count = 0;
+
+static double tolerance = 0.25;
+static int update = 0;
+static int regressions = 0;
+static int failures = 0;
+static int attempt = 1;
+
+// the measurements to repeat in a new process
+static const char * regressed[MAX_ENTRIES];
+
+static char * program;
+static int argument_count;
+static char ** arguments;
+
+static scilU_bench_config_t config;
+
+// MiB/s of the reference on this machine
+static double reference;
+static int without_baseline = 0;
+
+const char * perf_patterns[] = {"constant35", "random0-1", "steps16", "sin16", "poly4-234-3", "simplex106"};
+const int perf_pattern_count = sizeof(perf_patterns) / sizeof(char*);
+
+static uint64_t reference_in[REFERENCE_COUNT];
+static uint64_t reference_out[REFERENCE_COUNT];
+
+static int reference_copy(void* arg, double* out_seconds){
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  memcpy(reference_out, reference_in, sizeof(reference_in));
+  *out_seconds = scilU_stop_timer(timer);
+  return 0;
+}
+
+static int reference_compute(void* arg, double* out_seconds){
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  uint64_t x = reference_out[0] | 1;
+  for(size_t i=0; i < REFERENCE_COUNT; i++){
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    reference_out[i] = x + reference_in[i];
+  }
+  *out_seconds = scilU_stop_timer(timer);
+  return 0;
+}
+
+/*
+ The reference does not use the library: the geometric mean of the memory bandwidth of memcpy and the speed of
+ a scalar loop. Comparing the ratios of the kernels to it keeps the baseline valid on faster or slower machines.
+ */
+static double measure_reference(){
+  scilU_bench_config_t reference_config = config;
+  reference_config.max_seconds = 1;
+  scilU_bench_result_t copy, compute;
+  scilU_bench_prefault(reference_in, sizeof(reference_in));
+  scilU_bench_prefault(reference_out, sizeof(reference_out));
+  scilU_bench_run(& reference_config, reference_copy, NULL, & copy);
+  scilU_bench_run(& reference_config, reference_compute, NULL, & compute);
+  return sizeof(reference_in) / sqrt(copy.median * compute.median) / 1024 / 1024;
+}
+
+void perf_init(int argc, char** argv){
+  if(argc < 2){
+    printf("Synopsis: %s <baseline file> [measurement...]\n", argv[0]);
+    exit(1);
+  }
+  program = argv[0];
+  baseline_file = argv[1];
+  argument_count = argc - 2;
+  arguments = argv + 2;
+
+  const char * value = getenv("SCIL_PERF_TOLERANCE");
+  if(value != NULL){
+    tolerance = atof(value);
+  }
+  value = getenv("SCIL_PERF_UPDATE");
+  update = value != NULL && atoi(value) != 0;
+  value = getenv("SCIL_PERF_ATTEMPT");
+  if(value != NULL){
+    attempt = atoi(value);
+  }
+
+  // the kernels run for milliseconds, the median of a few repetitions is stable enough
+  scilU_bench_config_init(& config);
+  config.max_repetitions = 50;
+  config.max_seconds = 0.25;
+
+  reference = measure_reference();
+  printf("Reference %.1f MiB/s\n", reference);
+
+  FILE * f = fopen(baseline_file, "r");
+  if(f == NULL){
+    printf("No baseline in %s, the measurements are reported only\n", baseline_file);
+    return;
+  }
+  char line[1024];
+  while(fgets(line, sizeof(line), f) != NULL && baseline_count < MAX_ENTRIES){
+    if(line[0] == '#'){
+      continue;
+    }
+    entry_t * e = & baseline[baseline_count];
+    if(sscanf(line, "%99[^;]; %lf", e->name, & e->relative) != 2){
+      printf("Invalid line in the baseline \"%s\"\n", line);
+      continue;
+    }
+    baseline_count++;
+  }
+  fclose(f);
+}
+
+int perf_selected(const char* name){
+  if(argument_count == 0){
+    return 1;
+  }
+  for(int i=0; i < argument_count; i++){
+    if(strcmp(arguments[i], name) == 0){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static entry_t * find_baseline(const char* name){
+  for(int i=0; i < baseline_count; i++){
+    if(strcmp(baseline[i].name, name) == 0){
+      return & baseline[i];
+    }
+  }
+  return NULL;
+}
+
+static int compare_double(const void * a, const void * b){
+  const double x = *(const double*) a;
+  const double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+int perf_measure(scilU_bench_func_t func, void* arg, size_t size, double* out_relative){
+  scilU_bench_result_t result;
+  int ret = scilU_bench_run(& config, func, arg, & result);
+  if(ret != 0){
+    return ret;
+  }
+  *out_relative = size / result.median / 1024 / 1024 / reference;
+  return 0;
+}
+
+int perf_regressed(double relative, double baseline_relative){
+  return relative < baseline_relative * (1 - tolerance);
+}
+
+int perf_run(const char* name, scilU_bench_func_t func, void* arg, size_t size){
+  if(! perf_selected(name)){
+    return 0;
+  }
+  const entry_t * b = find_baseline(name);
+  double relative = 0;
+  double runs[RETRIES + 1];
+  int regression = 0;
+  for(int i=0; i <= RETRIES; i++){
+    double measured;
+    int ret = perf_measure(func, arg, size, & measured);
+    if(ret != 0){
+      printf("%-40s failed with %d\n", name, ret);
+      failures++;
+      return ret;
+    }
+    runs[i] = measured;
+    relative = measured > relative ? measured : relative;
+    regression = b != NULL && ! update && perf_regressed(relative, b->relative);
+    if(! regression && ! update){
+      break;
+    }
+  }
+  if(update){
+    // a lucky run must not become the baseline, record the median of all runs
+    qsort(runs, RETRIES + 1, sizeof(double), compare_double);
+    relative = runs[RETRIES / 2];
+  }
+
+  if(measured_count < MAX_ENTRIES){
+    entry_t * e = & measured[measured_count++];
+    snprintf(e->name, NAME_LENGTH, "%s", name);
+    e->relative = relative;
+  }
+  if(b == NULL){
+    printf("%-40s %10.1f MiB/s %8.4f no baseline\n", name, relative * reference, relative);
+    without_baseline++;
+    return 0;
+  }
+  printf("%-40s %10.1f MiB/s %8.4f baseline %8.4f %+6.1f%%%s\n", name, relative * reference, relative, b->relative,
+         (relative / b->relative - 1) * 100, regression ? " REGRESSION" : "");
+  if(regression){
+    regressed[regressions++] = b->name;
+  }
+  return 0;
+}
+
+int perf_create_pattern(void* buffer, SCIL_Datatype_t datatype, const scil_dims_t* dims, const char* name){
+  for(int i=0; i < scilPa_get_pattern_library_size(); i++){
+    if(strcmp(scilPa_get_library_pattern_name(i), name) == 0){
+      return scilPa_create_library_pattern(buffer, datatype, dims, i);
+    }
+  }
+  return SCIL_EINVAL;
+}
+
+int perf_finish(){
+  if(update){
+    // the measurements that did not run keep their baseline
+    for(int i=0; i < measured_count; i++){
+      entry_t * b = find_baseline(measured[i].name);
+      if(b != NULL){
+        b->relative = measured[i].relative;
+      }else if(baseline_count < MAX_ENTRIES){
+        baseline[baseline_count++] = measured[i];
+      }
+    }
+    FILE * f = fopen(baseline_file, "w");
+    if(f == NULL){
+      printf("Could not write the baseline to %s\n", baseline_file);
+      return 1;
+    }
+    fprintf(f, "# measurement; throughput relative to the reference, which was %.1f MiB/s\n", reference);
+    for(int i=0; i < baseline_count; i++){
+      fprintf(f, "%s; %.5f\n", baseline[i].name, baseline[i].relative);
+    }
+    fclose(f);
+    printf("Wrote %d measurements to %s\n", measured_count, baseline_file);
+  }
+  if(without_baseline > 0 && ! update){
+    printf("%d measurements have no baseline, they are not checked\n", without_baseline);
+  }
+  if(failures > 0){
+    printf("%d measurements failed\n", failures);
+    return 1;
+  }
+  if(regressions > 0 && attempt < PROCESS_ATTEMPTS){
+    // a real regression shows in every process, the new process checks only the regressed measurements
+    printf("%d measurements are more than %.0f%% slower than the baseline, attempt %d of %d, repeating them in a new process\n",
+           regressions, tolerance * 100, attempt, PROCESS_ATTEMPTS);
+    char * args[MAX_ENTRIES + 3];
+    args[0] = program;
+    args[1] = (char*) baseline_file;
+    for(int i=0; i < regressions; i++){
+      args[i + 2] = (char*) regressed[i];
+    }
+    args[regressions + 2] = NULL;
+    char value[12];
+    sprintf(value, "%d", attempt + 1);
+    setenv("SCIL_PERF_ATTEMPT", value, 1);
+    fflush(stdout);
+    execv(program, args);
+    printf("Could not start %s again\n", program);
+  }
+  if(regressions > 0){
+    printf("%d measurements are more than %.0f%% slower than the baseline\n", regressions, tolerance * 100);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,82 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SCIL_TEST_PERF_H
+#define SCIL_TEST_PERF_H
+
+/*
+ The performance tests measure the throughput of a kernel and compare it with the baseline file given as first argument.
+ The throughput is stored relative to a reference that is measured by each test without the library, thus a baseline
+ written on one machine holds on others as long as the kernels scale like memory bandwidth and scalar code.
+ A test fails if a kernel is slower than the baseline by more than the tolerance, 0.25 by default or SCIL_PERF_TOLERANCE.
+ The noise of shared machines is handled by repetition: a slower measurement is repeated, then the regressed measurements
+ are repeated in up to two new processes, as the placement of the data in a process can change the speed of a kernel.
+ Run the tests with SCIL_PERF_UPDATE=1 to write the median of three runs to the file.
+ */
+
+#include <scil-bench.h>
+#include <scil-datatypes.h>
+#include <scil-dims.h>
+
+#include <stdlib.h>
+
+/**
+ * \brief Measures the reference and reads the baseline, argv[1] is the file, further arguments select the measurements to run.
+ */
+void perf_init(int argc, char** argv);
+
+/**
+ * \brief Returns 1 if the measurement is selected on the command line, all are selected without arguments.
+ */
+int perf_selected(const char* name);
+
+/**
+ * \brief Measures the median throughput of the function and compares its ratio to the reference with the baseline, if the measurement is selected.
+ * A measurement slower than the baseline is repeated, thus a single disturbance of the machine does not fail the test.
+ * A measurement without baseline is reported only.
+ * \param size the uncompressed data processed by one call
+ * \return 0 or the error of the function
+ */
+int perf_run(const char* name, scilU_bench_func_t func, void* arg, size_t size);
+
+/**
+ * \brief Measures the median throughput of the function relative to the reference, without a comparison.
+ * \return 0 or the error of the function
+ */
+int perf_measure(scilU_bench_func_t func, void* arg, size_t size, double* out_relative);
+
+/**
+ * \brief Returns 1 if the relative throughput is slower than the baseline by more than the tolerance.
+ */
+int perf_regressed(double relative, double baseline_relative);
+
+// one pattern of each family of the pattern library
+extern const char * perf_patterns[];
+extern const int perf_pattern_count;
+
+/**
+ * \brief Creates the pattern of the library with the name.
+ * \return SCIL error code
+ */
+int perf_create_pattern(void* buffer, SCIL_Datatype_t datatype, const scil_dims_t* dims, const char* name);
+
+/**
+ * \brief Writes the baseline if requested and prints the summary.
+ * \return the exit code of the test
+ */
+int perf_finish();
+
+#endif // SCIL_TEST_PERF_H
@@ -0,0 +1,103 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The throughput of the quantizers, separate and fused with the packing, for float and double.
+#include <perf.h>
+
+#include <scil-quantizer.h>
+#include <scil-util.h>
+
+#include <stdio.h>
+
+#define COUNT (1024 * 1024)
+#define TOLERANCE 0.01
+
+static double data_double[COUNT];
+static float data_float[COUNT];
+static double out_double[COUNT];
+static float out_float[COUNT];
+static uint64_t quantized[COUNT];
+static byte packed[COUNT * sizeof(uint64_t)];
+
+static double minimum, maximum;
+static uint8_t bits;
+
+#define QUANTIZERS(type) \
+static int quantize_##type(void* arg, double* out_seconds){ \
+  scil_timer timer; \
+  scilU_start_timer(& timer); \
+  int ret = scil_quantize_buffer_minmax_##type(quantized, data_##type, COUNT, TOLERANCE, (type) minimum, (type) maximum); \
+  *out_seconds = scilU_stop_timer(timer); \
+  return ret; \
+} \
+static int unquantize_##type(void* arg, double* out_seconds){ \
+  scil_timer timer; \
+  scilU_start_timer(& timer); \
+  int ret = scil_unquantize_buffer_##type(out_##type, quantized, COUNT, TOLERANCE, (type) minimum); \
+  *out_seconds = scilU_stop_timer(timer); \
+  return ret; \
+} \
+static int quantize_pack_##type(void* arg, double* out_seconds){ \
+  scil_timer timer; \
+  scilU_start_timer(& timer); \
+  int ret = scil_quantize_pack_##type(packed, data_##type, COUNT, TOLERANCE, (type) minimum, bits); \
+  *out_seconds = scilU_stop_timer(timer); \
+  return ret; \
+} \
+static int unpack_unquantize_##type(void* arg, double* out_seconds){ \
+  scil_timer timer; \
+  scilU_start_timer(& timer); \
+  int ret = scil_unpack_unquantize_##type(out_##type, packed, COUNT, TOLERANCE, (type) minimum, bits); \
+  *out_seconds = scilU_stop_timer(timer); \
+  return ret; \
+}
+
+QUANTIZERS(float)
+QUANTIZERS(double)
+
+typedef struct{
+  const char * name;
+  scilU_bench_func_t func;
+  size_t size;
+} kernel_t;
+
+int main(int argc, char** argv){
+  perf_init(argc, argv);
+
+  srand(1);
+  for(size_t i=0; i < COUNT; i++){
+    data_double[i] = 1000.0 * (-1.0 + 2.0 * rand() / (double) RAND_MAX);
+    data_float[i] = (float) data_double[i];
+  }
+  scil_find_minimum_maximum_double(data_double, COUNT, & minimum, & maximum);
+  bits = (uint8_t) scil_calculate_bits_needed_double(minimum, maximum, TOLERANCE);
+
+  // the unquantizers and unpackers use the output of the kernel before
+  const kernel_t kernels[] = {
+    {"quantize-float", quantize_float, sizeof(float)},
+    {"unquantize-float", unquantize_float, sizeof(float)},
+    {"quantize-pack-float", quantize_pack_float, sizeof(float)},
+    {"unpack-unquantize-float", unpack_unquantize_float, sizeof(float)},
+    {"quantize-double", quantize_double, sizeof(double)},
+    {"unquantize-double", unquantize_double, sizeof(double)},
+    {"quantize-pack-double", quantize_pack_double, sizeof(double)},
+    {"unpack-unquantize-double", unpack_unquantize_double, sizeof(double)}
+  };
+  for(unsigned k=0; k < sizeof(kernels) / sizeof(kernel_t); k++){
+    perf_run(kernels[k].name, kernels[k].func, NULL, COUNT * kernels[k].size);
+  }
+  return perf_finish();
+}
@@ -0,0 +1,58 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The throughput of scilI_get_data_randomness() on the standard patterns.
+#include <perf.h>
+
+#include <scil.h>
+#include <scil-data-characteristics.h>
+#include <scil-error.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <stdio.h>
+
+#define X 512
+#define Y 512
+
+static double data[X * Y];
+static byte buffer[2 * X * Y * sizeof(double)];
+
+static int run_randomness(void* arg, double* out_seconds){
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  float r = scilI_get_data_randomness(data, sizeof(data), buffer, sizeof(buffer));
+  *out_seconds = scilU_stop_timer(timer);
+  return r < 0;
+}
+
+int main(int argc, char** argv){
+  perf_init(argc, argv);
+
+  scil_dims_t dims;
+  scilPr_initialize_dims_2d(& dims, X, Y);
+  for(int p=0; p < perf_pattern_count; p++){
+    char name[100];
+    sprintf(name, "randomness-%s", perf_patterns[p]);
+    if(! perf_selected(name)){
+      continue;
+    }
+    int ret = perf_create_pattern(data, SCIL_TYPE_DOUBLE, & dims, perf_patterns[p]);
+    assert(ret == SCIL_NO_ERR);
+    perf_run(name, run_randomness, NULL, sizeof(data));
+  }
+  return perf_finish();
+}
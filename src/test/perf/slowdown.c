@@ -0,0 +1,58 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Checks the harness: a kernel doing its work twice must be reported as regression of the kernel doing it once.
+#include <perf.h>
+
+#include <scil-util.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT (1024 * 1024)
+
+static double data[COUNT];
+static double copy[COUNT];
+
+static int run_copy(void* arg, double* out_seconds){
+  const int repeat = *(int*) arg;
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  for(int i=0; i < repeat; i++){
+    memcpy(copy, data, sizeof(data));
+    data[i] = copy[COUNT - 1 - i];
+  }
+  *out_seconds = scilU_stop_timer(timer);
+  return 0;
+}
+
+int main(int argc, char** argv){
+  perf_init(argc, argv);
+  scilU_bench_prefault(data, sizeof(data));
+  scilU_bench_prefault(copy, sizeof(copy));
+
+  int once = 1;
+  int twice = 2;
+  double baseline, slower;
+  int ret = perf_measure(run_copy, & once, sizeof(data), & baseline);
+  assert(ret == 0);
+  ret = perf_measure(run_copy, & twice, sizeof(data), & slower);
+  assert(ret == 0);
+  printf("%-40s %8.4f baseline %8.4f %+6.1f%%%s\n", "copy-twice", slower, baseline, (slower / baseline - 1) * 100,
+         perf_regressed(slower, baseline) ? " REGRESSION" : "");
+  assert(perf_regressed(slower, baseline));
+  return perf_finish();
+}
@@ -0,0 +1,68 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The throughput of scil_swage() and scil_unswage() for every bit width.
+#include <perf.h>
+
+#include <scil-swager.h>
+#include <scil-util.h>
+
+#include <stdio.h>
+
+#define COUNT (1024 * 1024)
+
+static uint64_t values[COUNT];
+static uint64_t unpacked[COUNT];
+static byte packed[COUNT * sizeof(uint64_t)];
+
+static uint8_t bits;
+
+static int run_swage(void* arg, double* out_seconds){
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  int ret = scil_swage(packed, values, COUNT, bits);
+  *out_seconds = scilU_stop_timer(timer);
+  return ret;
+}
+
+static int run_unswage(void* arg, double* out_seconds){
+  scil_timer timer;
+  scilU_start_timer(& timer);
+  int ret = scil_unswage(unpacked, packed, COUNT, bits);
+  *out_seconds = scilU_stop_timer(timer);
+  return ret;
+}
+
+int main(int argc, char** argv){
+  perf_init(argc, argv);
+
+  srand(1);
+  for(bits = 1; bits <= 64; bits++){
+    const uint64_t mask = bits == 64 ? UINT64_MAX : (1ull << bits) - 1;
+    for(size_t i=0; i < COUNT; i++){
+      values[i] = (((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ (uint64_t) rand()) & mask;
+    }
+    char name[100];
+    sprintf(name, "swage-%d", bits);
+    perf_run(name, run_swage, NULL, sizeof(values));
+    sprintf(name, "unswage-%d", bits);
+    if(perf_selected(name)){
+      scil_swage(packed, values, COUNT, bits);
+      perf_run(name, run_unswage, NULL, sizeof(values));
+    }
+  }
+  return perf_finish();
+}
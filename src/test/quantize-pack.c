@@ -0,0 +1,123 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// The fused kernels must create the same format as quantizing followed by scil_swage().
+#include <scil-quantizer.h>
+#include <scil-swager.h>
+#include <scil-util.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 1001
+
+static uint64_t values[COUNT];
+static uint64_t values_check[COUNT];
+static double data[COUNT];
+static double data_check[COUNT];
+// scil_swage() may write one byte behind the packed data
+static byte packed[COUNT * 8 + 1];
+static byte packed_check[COUNT * 8 + 1];
+
+static uint64_t random_bits(int bits){
+  uint64_t value = ((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ (uint64_t) rand();
+  return bits == 64 ? value : value & ((UINT64_C(1) << bits) - 1);
+}
+
+static void test_bit_stream(int bits){
+  const size_t size = (COUNT * bits + 7) / 8;
+  for(int i=0; i < COUNT; i++){
+    values[i] = random_bits(bits);
+  }
+  scil_swage(packed, values, COUNT, bits);
+
+  scil_bit_writer_t writer;
+  scil_bit_writer_init(& writer, packed_check);
+  for(int i=0; i < COUNT; i++){
+    scil_bit_writer_put(& writer, values[i], bits);
+  }
+  assert(scil_bit_writer_flush(& writer) == packed_check + size);
+  assert(memcmp(packed, packed_check, size) == 0);
+
+  scil_bit_reader_t reader;
+  scil_bit_reader_init(& reader, packed_check, size);
+  for(int i=0; i < COUNT; i++){
+    values_check[i] = scil_bit_reader_get(& reader, bits);
+  }
+  assert(memcmp(values, values_check, sizeof(values)) == 0);
+}
+
+static void test_quantize(double abstol){
+  for(int i=0; i < COUNT; i++){
+    data[i] = sin(i / 10.0) * 1000 + (rand() / (double) RAND_MAX);
+  }
+  double minimum, maximum;
+  scil_find_minimum_maximum_double(data, COUNT, & minimum, & maximum);
+  const int bits = scil_calculate_bits_needed_double(minimum, maximum, abstol);
+  const size_t size = (COUNT * bits + 7) / 8;
+
+  int ret = scil_quantize_buffer_minmax_double(values, data, COUNT, abstol, minimum, maximum);
+  assert(ret == 0);
+  scil_swage(packed, values, COUNT, bits);
+
+  ret = scil_quantize_pack_double(packed_check, data, COUNT, abstol, minimum, bits);
+  assert(ret == 0);
+  assert(memcmp(packed, packed_check, size) == 0);
+
+  ret = scil_unpack_unquantize_double(data_check, packed_check, COUNT, abstol, minimum, bits);
+  assert(ret == 0);
+  for(int i=0; i < COUNT; i++){
+    assert(fabs(data_check[i] - data[i]) <= abstol * 1.0001);
+  }
+}
+
+// the maximum rounds to 1 << bits, both paths clamp it to the largest value of the bits
+static void test_clamp(){
+  const double minimum = 373.97896818536282;
+  const double maximum = 86003047.100401253;
+  const double abstol = 1.9096429575745217e-08;
+  for(int i=0; i < COUNT; i++){
+    data[i] = minimum + (maximum - minimum) * i / (COUNT - 1);
+  }
+  data[COUNT - 1] = maximum;
+  const int bits = scil_calculate_bits_needed_double(minimum, maximum, abstol);
+  const size_t size = (COUNT * bits + 7) / 8;
+
+  int ret = scil_quantize_buffer_minmax_double(values, data, COUNT, abstol, minimum, maximum);
+  assert(ret == 0);
+  assert(values[COUNT - 1] == (UINT64_C(1) << bits) - 1);
+  scil_swage(packed, values, COUNT, bits);
+
+  ret = scil_quantize_pack_double(packed_check, data, COUNT, abstol, minimum, bits);
+  assert(ret == 0);
+  assert(memcmp(packed, packed_check, size) == 0);
+}
+
+int main(){
+  srand(4711);
+  for(int bits=0; bits <= 64; bits++){
+    test_bit_stream(bits);
+  }
+  test_quantize(1);
+  test_quantize(0.01);
+  test_quantize(0.00001);
+  test_quantize(1e-10);
+  test_clamp();
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,109 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Decompression of hyperslabs from tiled and untiled data.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define X 40
+#define Y 30
+#define Z 20
+
+static int data[Z][Y][X];
+static int region[Z * Y * X + 1];
+
+static void check_region(byte * buff, size_t size, size_t ox, size_t oy, size_t oz, size_t cx, size_t cy, size_t cz){
+  scil_dims_t dims, offset, count;
+  scilPr_initialize_dims_3d(& dims, X, Y, Z);
+  scilPr_initialize_dims_3d(& offset, ox, oy, oz);
+  scilPr_initialize_dims_3d(& count, cx, cy, cz);
+
+  memset(region, -1, sizeof(region));
+  int ret = scil_decompress_region(SCIL_TYPE_INT32, region, & dims, & offset, & count, buff, size);
+  assert(ret == SCIL_NO_ERR);
+
+  int * pos = region;
+  for(size_t z=oz; z < oz + cz; z++){
+    for(size_t y=oy; y < oy + cy; y++){
+      for(size_t x=ox; x < ox + cx; x++){
+        assert(*pos == data[z][y][x]);
+        pos++;
+      }
+    }
+  }
+  // nothing is written behind the region
+  assert(*pos == -1);
+}
+
+static void test(scil_dims_t * tile){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t out_size;
+  int ret;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.force_compression_methods = "lz4";
+  ret = scilPr_create_context(&ctx, SCIL_TYPE_INT32, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_set_tiling(ctx, tile, 0);
+
+  scilPr_initialize_dims_3d(& dims, X, Y, Z);
+  size_t size = scilPr_get_compressed_data_size_limit(&dims, SCIL_TYPE_INT32);
+  byte * buff = malloc(size);
+  ret = scil_compress(buff, size, data, & dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_destroy_context(ctx);
+
+  check_region(buff, out_size, 0, 0, 0, X, Y, Z);
+  check_region(buff, out_size, 1, 2, 3, 5, 4, 3);
+  check_region(buff, out_size, 7, 5, 2, 20, 17, 9);
+  check_region(buff, out_size, X-1, Y-1, Z-1, 1, 1, 1);
+  check_region(buff, out_size, 0, 10, 5, X, 1, 10);
+
+  // the region must be within the data
+  scil_dims_t offset, count;
+  scilPr_initialize_dims_3d(& offset, 1, 0, 0);
+  scilPr_initialize_dims_3d(& count, X, 1, 1);
+  ret = scil_decompress_region(SCIL_TYPE_INT32, region, & dims, & offset, & count, buff, out_size);
+  assert(ret == SCIL_EINVAL);
+
+  free(buff);
+}
+
+int main(){
+  int i = 0;
+  for(int z=0; z < Z; z++){
+    for(int y=0; y < Y; y++){
+      for(int x=0; x < X; x++){
+        data[z][y][x] = i++;
+      }
+    }
+  }
+
+  scil_dims_t tile;
+  scilPr_initialize_dims_3d(& tile, 16, 7, 6);
+  test(& tile);
+  scilPr_initialize_dims_3d(& tile, 0, 0, 3);
+  test(& tile);
+  test(NULL);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,101 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// The sampled randomness must describe the whole field, not the region at its start.
+#include <scil.h>
+#include <scil-data-characteristics.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define X 300
+#define Y 200
+#define Z 50
+
+static double field[Z][Y][X];
+
+int main(){
+  scil_dims_t dims;
+  scilPr_initialize_dims_3d(& dims, X, Y, Z);
+  scilI_workspace_t* ws = scilI_workspace_create();
+
+  // a constant fill region in the first tenth of the field, noise elsewhere
+  srand(1);
+  for(int z=0; z < Z; z++){
+    for(int y=0; y < Y; y++){
+      for(int x=0; x < X; x++){
+        field[z][y][x] = z < Z / 10 ? -999.0 : rand() / (double) RAND_MAX;
+      }
+    }
+  }
+  byte buffer[15000];
+  const float head = scilI_get_data_randomness(field, 10000, buffer, sizeof(buffer));
+  const float sampled = scilI_sample_data_randomness(field, SCIL_TYPE_DOUBLE, & dims, SCIL_DEFAULT_SAMPLE_SIZE, ws);
+  const float whole = scilI_sample_data_randomness(field, SCIL_TYPE_DOUBLE, & dims, 0, ws);
+  printf("head %.1f sampled %.1f whole %.1f\n", (double) head, (double) sampled, (double) whole);
+  assert(head < 10);
+  assert(sampled > 80);
+  assert(sampled - whole < 10 && whole - sampled < 10);
+
+  // noise only in a slab along the slowest dimension, the blocks must cover it in proportion
+  for(int z=0; z < Z; z++){
+    for(int y=0; y < Y; y++){
+      for(int x=0; x < X; x++){
+        field[z][y][x] = y < Y / 2 ? 1.0 : rand() / (double) RAND_MAX;
+      }
+    }
+  }
+  const float half = scilI_sample_data_randomness(field, SCIL_TYPE_DOUBLE, & dims, SCIL_DEFAULT_SAMPLE_SIZE, ws);
+  printf("half %.1f\n", (double) half);
+  assert(half > 25 && half < 75);
+
+  // blocks of a single value and tiny arrays
+  scilPr_initialize_dims_1d(& dims, 5);
+  const float tiny = scilI_sample_data_randomness(field, SCIL_TYPE_DOUBLE, & dims, 8, ws);
+  assert(tiny > 0);
+
+  // the automatic selection stores random data without compression, although the first plane is a fill value
+  scil_context_t* ctx;
+  scil_user_hints_t hints;
+  scilPr_initialize_user_hints(& hints);
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  ret = scilPr_set_sample_size(ctx, 16 * 1024);
+  assert(ret == SCIL_NO_ERR);
+  for(int z=0; z < Z; z++){
+    for(int y=0; y < Y; y++){
+      for(int x=0; x < X; x++){
+        field[z][y][x] = z == 0 ? -999.0 : rand() / (double) RAND_MAX;
+      }
+    }
+  }
+  scilPr_initialize_dims_3d(& dims, X, Y, Z);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* compressed = malloc(bound);
+  size_t size;
+  ret = scil_compress(compressed, bound, (double*) field, & dims, & size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  char chain[100];
+  scil_compression_sprint_last_algorithm_chain(ctx, chain, sizeof(chain));
+  assert(strcmp(chain, "memcopy") == 0);
+
+  free(compressed);
+  scilPr_destroy_context(ctx);
+  scilI_workspace_destroy(ws);
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,135 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// The statistics record the stages of the chain and accumulate them per context.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 100000
+
+static double data[COUNT];
+static double data_check[COUNT];
+
+// the stages of tiles compressed in parallel may take longer than the call
+static void check_stages(const scil_stats_t* s, size_t compressed_size, int parallel){
+  assert(s->calls == 1);
+  assert(s->stage_count == 2);
+  assert(strcmp(s->stages[0].name, "abstol") == 0);
+  assert(strcmp(s->stages[1].name, "lz4") == 0);
+  double stage_seconds = 0;
+  for(int i=0; i < s->stage_count; i++){
+    assert(s->stages[i].seconds >= 0);
+    stage_seconds += s->stages[i].seconds;
+  }
+  assert(parallel || stage_seconds <= s->seconds);
+  assert(s->bytes_in == COUNT * sizeof(double));
+  assert(s->bytes_out == compressed_size);
+}
+
+static void test_compression(scil_dims_t* tile){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  scil_stats_t last, total;
+  size_t size;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.01;
+  hints.force_compression_methods = "abstol,lz4";
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  if(tile != NULL){
+    scilPr_set_tiling(ctx, tile, 4);
+  }
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+
+  assert(scil_get_last_stats(ctx, & last, & total) == SCIL_EINVAL);
+  ret = scilPr_set_stats(ctx, 1);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_get_last_stats(ctx, & last, & total);
+  assert(ret == SCIL_NO_ERR && last.calls == 0 && total.calls == 0);
+
+  for(int i=0; i < 3; i++){
+    ret = scil_compress(buff, bound, data, & dims, & size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    ret = scil_get_last_stats(ctx, & last, NULL);
+    assert(ret == SCIL_NO_ERR);
+    check_stages(& last, size, tile != NULL);
+    // the quantized data is smaller than the input of the byte compressor
+    assert(last.stages[0].bytes_in == COUNT * sizeof(double));
+    assert(last.stages[1].bytes_in == last.stages[0].bytes_out);
+    assert(last.stages[1].bytes_out <= size);
+    assert(last.scratch_bytes > 0);
+  }
+  ret = scil_get_last_stats(ctx, NULL, & total);
+  assert(ret == SCIL_NO_ERR);
+  printf("%d stages, %.6fs per call, %zu bytes of scratch\n", total.stage_count, total.seconds / total.calls, total.scratch_bytes);
+  assert(total.calls == 3);
+  assert(total.bytes_in == 3 * COUNT * sizeof(double));
+  assert(total.stage_count == 2);
+  assert(total.stages[1].bytes_out == 3 * last.stages[1].bytes_out);
+
+  // the statistics are cleared when they are enabled again
+  scilPr_set_stats(ctx, 0);
+  assert(scil_get_last_stats(ctx, & last, & total) == SCIL_EINVAL);
+  ret = scil_compress(buff, bound, data, & dims, & size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_set_stats(ctx, 1);
+  scil_get_last_stats(ctx, NULL, & total);
+  assert(total.calls == 0);
+
+  // decompression
+  scil_stats_t d_last;
+  assert(scil_get_last_decompression_stats(& d_last, NULL) == SCIL_EINVAL);
+  scil_set_decompression_stats(1);
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & dims, buff, size, NULL);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_get_last_decompression_stats(& d_last, NULL);
+  assert(ret == SCIL_NO_ERR);
+  assert(d_last.calls == 1);
+  assert(d_last.bytes_in == size && d_last.bytes_out == COUNT * sizeof(double));
+  // the stages are recorded in the order of the decompression
+  assert(d_last.stage_count == 2);
+  assert(strcmp(d_last.stages[0].name, "lz4") == 0);
+  assert(d_last.stages[0].bytes_in < size);
+  assert(d_last.stages[1].bytes_out == COUNT * sizeof(double));
+  scil_set_decompression_stats(0);
+  assert(scil_get_last_decompression_stats(& d_last, NULL) == SCIL_EINVAL);
+
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  for(int i=0; i < COUNT; i++){
+    data[i] = (i % 1000) * 0.1;
+  }
+  test_compression(NULL);
+
+  // the stages of the blocks and tiles are summed up over all workers
+  scil_dims_t tile;
+  scilPr_initialize_dims_1d(& tile, COUNT / 8);
+  test_compression(& tile);
+
+  printf("OK\n");
+  return 0;
+}
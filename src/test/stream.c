@@ -0,0 +1,158 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Compression of data that is appended in slabs along the slowest dimension.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define X 100
+#define Y 57
+
+static float data[Y][X];
+static float data_check[Y][X];
+
+static byte * out;
+static size_t out_pos;
+static size_t out_limit;
+
+static size_t in_pos;
+
+static int read_memory(void * user, byte * buff, size_t size){
+  if(in_pos + size > out_pos){
+    return 1;
+  }
+  memcpy(buff, out + in_pos, size);
+  in_pos += size;
+  return 0;
+}
+
+static int sink_planes(void * user, const void * slab, size_t first_plane, size_t planes){
+  memcpy(data_check[first_plane], slab, planes * X * sizeof(float));
+  return 0;
+}
+
+static int write_memory(void * user, const byte * buff, size_t size){
+  if(out_pos + size > out_limit){
+    return 1;
+  }
+  memcpy(out + out_pos, buff, size);
+  out_pos += size;
+  return 0;
+}
+
+int main(){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_compress_stream_t * stream;
+  scil_dims_t dims;
+  size_t out_size;
+  int ret;
+
+  for(int y=0; y < Y; y++){
+    for(int x=0; x < X; x++){
+      data[y][x] = (float) (x * y % 17);
+    }
+  }
+
+  scilPr_initialize_user_hints(& hints);
+  hints.force_compression_methods = "lz4";
+  ret = scilPr_create_context(&ctx, SCIL_TYPE_FLOAT, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+
+  scilPr_initialize_dims_2d(& dims, X, Y);
+  out_limit = scilPr_get_compressed_data_size_limit(&dims, SCIL_TYPE_FLOAT);
+  out = malloc(out_limit);
+
+  // frames of 7 planes, the slabs do not match the frames
+  ret = scil_compress_stream_begin(& stream, ctx, & dims, 7 * X * sizeof(float), write_memory, NULL);
+  assert(ret == SCIL_NO_ERR);
+  size_t slabs[] = {3, 11, 1, 20, 22};
+  size_t plane = 0;
+  for(int i=0; i < 5; i++){
+    ret = scil_compress_stream_append(stream, data[plane], slabs[i]);
+    assert(ret == SCIL_NO_ERR);
+    plane += slabs[i];
+  }
+  assert(plane == Y);
+  ret = scil_compress_stream_finish(stream, & out_size);
+  assert(ret == SCIL_NO_ERR);
+  assert(out_size == out_pos);
+  printf("Stream size: %zu\n", out_size);
+
+  byte * tmp = malloc(out_limit);
+  ret = scil_decompress(SCIL_TYPE_FLOAT, data_check, & dims, out, out_size, tmp);
+  assert(ret == SCIL_NO_ERR);
+  assert(memcmp(data, data_check, sizeof(data)) == 0);
+
+  // pull the stream from a read function
+  scil_dims_t stream_dims;
+  stream_dims.dims = 0;
+  memset(data_check, 0, sizeof(data_check));
+  in_pos = 0;
+  ret = scil_decompress_stream(SCIL_TYPE_FLOAT, & stream_dims, read_memory, NULL, sink_planes, NULL);
+  assert(ret == SCIL_NO_ERR);
+  assert(stream_dims.dims == 2 && stream_dims.length[0] == X && stream_dims.length[1] == Y);
+  assert(in_pos == out_size);
+  assert(memcmp(data, data_check, sizeof(data)) == 0);
+
+  // a truncated stream
+  in_pos = 0;
+  out_pos = out_size - 8;
+  ret = scil_decompress_stream(SCIL_TYPE_FLOAT, & dims, read_memory, NULL, sink_planes, NULL);
+  assert(ret == SCIL_IO_ERR);
+  out_pos = out_size;
+
+  scil_dims_t offset, count;
+  scilPr_initialize_dims_2d(& offset, 10, 20);
+  scilPr_initialize_dims_2d(& count, 5, 30);
+  float region[30][5];
+  ret = scil_decompress_region(SCIL_TYPE_FLOAT, region, & dims, & offset, & count, out, out_size);
+  assert(ret == SCIL_NO_ERR);
+  for(int y=0; y < 30; y++){
+    assert(memcmp(region[y], & data[y + 20][10], sizeof(region[y])) == 0);
+  }
+
+  // incomplete data
+  out_pos = 0;
+  ret = scil_compress_stream_begin(& stream, ctx, & dims, 0, write_memory, NULL);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_compress_stream_append(stream, data, Y - 1);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_compress_stream_append(stream, data, 2);
+  assert(ret == SCIL_EINVAL);
+  ret = scil_compress_stream_finish(stream, NULL);
+  assert(ret == SCIL_EINVAL);
+
+  // errors of the write function abort the stream
+  out_pos = 0;
+  out_limit = 100;
+  ret = scil_compress_stream_begin(& stream, ctx, & dims, 1, write_memory, NULL);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_compress_stream_append(stream, data, Y);
+  assert(ret == SCIL_IO_ERR);
+  ret = scil_compress_stream_finish(stream, NULL);
+  assert(ret == SCIL_IO_ERR);
+
+  scilPr_destroy_context(ctx);
+  free(tmp);
+  free(out);
+
+  printf("OK\n");
+  return 0;
+}
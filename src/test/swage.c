@@ -6,6 +6,50 @@
 #include <time.h>
 #include <math.h>
 #include <assert.h>
+#include <string.h>
+
+// All instruction set variants must produce the same bytes and stay inside the packed size
+static void test_isa_variants(const uint64_t* buf_in, uint32_t count){
+    byte* expected = (byte*)SAFE_MALLOC(count * sizeof(uint64_t) + 1);
+    byte* actual   = (byte*)SAFE_MALLOC(count * sizeof(uint64_t) + 1);
+    uint64_t* buf_end = (uint64_t*)SAFE_MALLOC(count * sizeof(uint64_t));
+    const scil_swage_isa_t best = scil_swage_get_isa();
+
+    for(uint8_t bits = 0; bits <= 64; ++bits)
+    {
+        const size_t size = (count * bits + 7) / 8;
+        const uint64_t mask = bits == 64 ? UINT64_MAX : (UINT64_C(1) << bits) - 1;
+        // skip some values to test different alignments at the end
+        const uint32_t n = count - bits % 8;
+        const size_t n_size = (n * bits + 7) / 8;
+        scil_swage_set_isa(SCIL_SWAGE_SCALAR);
+        scil_swage(expected, buf_in, n, bits);
+
+        for(int isa = SCIL_SWAGE_SCALAR; isa <= SCIL_SWAGE_AVX512; ++isa)
+        {
+            if(scil_swage_set_isa(isa) != SCIL_NO_ERR)
+            {
+                continue;
+            }
+            memset(actual, 0xAB, size + 1);
+            scil_swage(actual, buf_in, n, bits);
+            assert(memcmp(expected, actual, n_size) == 0);
+            assert(actual[n_size] == 0xAB);
+
+            scil_unswage(buf_end, actual, n, bits);
+            for(uint32_t j = 0; j < n; ++j)
+            {
+                assert(buf_end[j] == (buf_in[j] & mask));
+            }
+        }
+    }
+    scil_swage_set_isa(best);
+    printf("Checked instruction set variants, selected: %d\n", best);
+
+    free(expected);
+    free(actual);
+    free(buf_end);
+}
 
 int main(void){
 
@@ -53,6 +97,12 @@ int main(void){
         }
     }
 
+    for(uint64_t j = 0; j < count; ++j)
+    {
+        buf_in[j] = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+    }
+    test_isa_variants(buf_in, count);
+
     printf("Success!\n");
 
     free(buf_in);
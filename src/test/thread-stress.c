@@ -0,0 +1,146 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Many threads use the library at once, each with its own contexts, the results must match a sequential run.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define THREADS 8
+#define ITERATIONS 20
+#define COUNT 20000
+
+// NULL lets the chooser pick the chain
+static const char* chains[] = {"abstol,lz4", "sigbits,lz4", NULL, "quantize", "sigbits,gzip", NULL, "lz4", "abstol", NULL};
+#define CHAIN_COUNT (sizeof(chains) / sizeof(*chains))
+
+// the chooser reads the configuration concurrently, the estimates make its decisions deterministic
+static const char* configuration =
+  "!storage 100\n"
+  "0; memcopy; 10000; 10000; 1\n"
+  "100; memcopy; 10000; 10000; 1\n"
+  "0; lz4; 2000; 4000; 0.4\n"
+  "100; lz4; 2000; 4000; 1\n"
+  "0; abstol,lz4; 500; 1000; 0.05\n"
+  "0; sigbits,lz4; 800; 1000; 0.1\n";
+
+static double data[COUNT];
+
+typedef struct {
+  int id;
+  size_t sizes[ITERATIONS];
+  uint64_t checksums[ITERATIONS];
+} thread_result_t;
+
+static uint64_t checksum(const byte* buffer, size_t size){
+  uint64_t sum = 14695981039346656037ULL;
+  for(size_t i=0; i < size; i++){
+    sum = (sum ^ buffer[i]) * 1099511628211ULL;
+  }
+  return sum;
+}
+
+// compresses and decompresses with a new context per iteration, thus the contexts are created concurrently
+static void run(int id, int iteration, size_t* out_size, uint64_t* out_checksum){
+  const char* chain = chains[(id + iteration) % CHAIN_COUNT];
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.01;
+  // without significant bits the chooser may pick abstol
+  if(chain != NULL || id % 2 == 0){
+    hints.significant_bits = 20;
+  }
+  hints.force_compression_methods = (char*) chain;
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+
+  const size_t count = COUNT - 100 * (size_t) id;
+  scilPr_initialize_dims_1d(& dims, count);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+  double* check = malloc(count * sizeof(double));
+  ret = scil_compress(buff, bound, data, & dims, out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  *out_checksum = checksum(buff, *out_size);
+
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, check, & dims, buff, *out_size, NULL);
+  assert(ret == SCIL_NO_ERR);
+  for(size_t i=0; i < count; i++){
+    assert(fabs(check[i] - data[i]) <= 0.01 + fabs(data[i]) * 1e-5);
+  }
+
+  free(check);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+static void* thread_main(void* arg){
+  thread_result_t* r = (thread_result_t*) arg;
+  for(int i=0; i < ITERATIONS; i++){
+    run(r->id, i, & r->sizes[i], & r->checksums[i]);
+  }
+  return NULL;
+}
+
+int main(){
+  char conf[] = "/tmp/scil-thread-stress-XXXXXX";
+  int fd = mkstemp(conf);
+  assert(fd >= 0);
+  assert(write(fd, configuration, strlen(configuration)) == (ssize_t) strlen(configuration));
+  close(fd);
+  setenv("SCIL_SYSTEM_CHARACTERISTICS_FILE", conf, 1);
+  // learning and the decision cache would make the choice depend on the order of the threads
+  unsetenv("SCIL_LEARNED_STATISTICS_FILE");
+  unsetenv("SCIL_DECISION_CACHE_FILE");
+  unsetenv("SCIL_FORCE_COMPRESSION_CHAIN");
+
+  for(int i=0; i < COUNT; i++){
+    data[i] = sin(i / 200.0) * 50 + cos(i / 3.0);
+  }
+
+  pthread_t threads[THREADS];
+  thread_result_t results[THREADS];
+  for(int t=0; t < THREADS; t++){
+    results[t].id = t;
+    int ret = pthread_create(& threads[t], NULL, thread_main, & results[t]);
+    assert(ret == 0);
+  }
+  for(int t=0; t < THREADS; t++){
+    pthread_join(threads[t], NULL);
+  }
+
+  for(int t=0; t < THREADS; t++){
+    for(int i=0; i < ITERATIONS; i++){
+      size_t size;
+      uint64_t sum;
+      run(t, i, & size, & sum);
+      assert(size == results[t].sizes[i]);
+      assert(sum == results[t].checksums[i]);
+    }
+  }
+
+  unlink(conf);
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,110 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// Tiled compression must be independent of the thread count and restore the data.
+#include <scil.h>
+#include <scil-error.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define X 50
+#define Y 37
+#define Z 21
+
+static double data[Z][Y][X];
+static double data_check[Z][Y][X];
+
+static size_t compress(byte * buff, size_t size, const char * chain, double abstol, scil_dims_t * tile, int threads){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t out_size;
+  int ret;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = abstol;
+  hints.force_compression_methods = (char*) chain;
+  ret = scilPr_create_context(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  ret = scilPr_set_tiling(ctx, tile, threads);
+  assert(ret == SCIL_NO_ERR);
+
+  scilPr_initialize_dims_3d(& dims, X, Y, Z);
+  ret = scil_compress(buff, size, data, & dims, & out_size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_destroy_context(ctx);
+  return out_size;
+}
+
+static void check(const char * chain, double abstol, scil_dims_t * tile){
+  scil_dims_t dims;
+  scilPr_initialize_dims_3d(& dims, X, Y, Z);
+  size_t size = scilPr_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE);
+  byte * buff1 = malloc(size);
+  byte * buff2 = malloc(size);
+  byte * tmp = malloc(size);
+
+  size_t out1 = compress(buff1, size, chain, abstol, tile, 1);
+  size_t out2 = compress(buff2, size, chain, abstol, tile, 4);
+  printf("%s tiled size: %zu\n", chain, out1);
+  assert(out1 == out2);
+  assert(memcmp(buff1, buff2, out1) == 0);
+
+  memset(data_check, 0, sizeof(data_check));
+  int ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & dims, buff1, out1, tmp);
+  assert(ret == SCIL_NO_ERR);
+  for(int z=0; z < Z; z++){
+    for(int y=0; y < Y; y++){
+      for(int x=0; x < X; x++){
+        assert(fabs(data_check[z][y][x] - data[z][y][x]) <= abstol);
+      }
+    }
+  }
+
+  // a truncated container must be rejected
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & dims, buff1, out1 / 2, tmp);
+  assert(ret != SCIL_NO_ERR);
+
+  free(buff1);
+  free(buff2);
+  free(tmp);
+}
+
+int main(){
+  for(int z=0; z < Z; z++){
+    for(int y=0; y < Y; y++){
+      for(int x=0; x < X; x++){
+        data[z][y][x] = sin(x / 10.0) * cos(y / 7.0) + z;
+      }
+    }
+  }
+
+  scil_dims_t tile;
+  // tiles with partial tiles at the borders of each dimension
+  scilPr_initialize_dims_3d(& tile, 16, 8, 5);
+  check("lz4", 0, & tile);
+  check("abstol,lz4", 0.01, & tile);
+
+  // tiles along the slowest dimension are contiguous in memory
+  scilPr_initialize_dims_3d(& tile, 0, 0, 4);
+  check("lz4", 0, & tile);
+  check("abstol,lz4", 0.01, & tile);
+
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,92 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// SCIL_TRACE writes a span for each stage and tile into a Chrome trace file.
+#include <scil.h>
+#include <scil-error.h>
+#include <scil-trace.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 100000
+#define TRACE_FILE "trace-test.json"
+
+static double data[COUNT];
+
+// registered before the library finishes the trace at exit, thus it runs afterwards
+static void check_trace(){
+  FILE* f = fopen(TRACE_FILE, "r");
+  assert(f != NULL);
+  static char trace[1024 * 1024];
+  const size_t size = fread(trace, 1, sizeof(trace) - 1, f);
+  fclose(f);
+  trace[size] = 0;
+  assert(trace[0] == '[');
+  assert(strcmp(trace + size - 3, "}\n]\n") == 0 || strcmp(trace + size - 2, "]\n") == 0);
+  const char* spans[] = {"create_context", "chooser", "sample", "scil_compress", "scil_decompress", "\"tile\"", "\"abstol\"", "\"lz4\""};
+  for(size_t i=0; i < sizeof(spans) / sizeof(*spans); i++){
+    if(strstr(trace, spans[i]) == NULL){
+      printf("Missing span %s\n", spans[i]);
+      assert(0);
+    }
+  }
+  assert(strstr(trace, "\"ph\":\"X\"") != NULL && strstr(trace, "\"tid\":") != NULL);
+  remove(TRACE_FILE);
+  printf("OK\n");
+}
+
+static void compress(const char* chain, scil_dims_t* tile){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t size;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.01;
+  hints.force_compression_methods = (char*) chain;
+  int ret = scilPr_create_context(& ctx, SCIL_TYPE_DOUBLE, 0, NULL, & hints);
+  assert(ret == SCIL_NO_ERR);
+  if(tile != NULL){
+    scilPr_set_tiling(ctx, tile, 4);
+  }
+  scilPr_initialize_dims_1d(& dims, COUNT);
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte* buff = malloc(bound);
+  ret = scil_compress(buff, bound, data, & dims, & size, ctx);
+  assert(ret == SCIL_NO_ERR);
+  ret = scil_decompress(SCIL_TYPE_DOUBLE, data, & dims, buff, size, NULL);
+  assert(ret == SCIL_NO_ERR);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  setenv("SCIL_TRACE", TRACE_FILE, 1);
+  atexit(check_trace);
+  assert(scilU_trace_enabled());
+
+  for(int i=0; i < COUNT; i++){
+    data[i] = (i % 1000) * 0.1;
+  }
+  scil_dims_t tile;
+  scilPr_initialize_dims_1d(& tile, COUNT / 8);
+  compress("abstol,lz4", & tile);
+  // the automatic selection samples the data
+  compress(NULL, NULL);
+  return 0;
+}
@@ -0,0 +1,115 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+// The scratch memory must be reused across calls instead of growing.
+#include <scil.h>
+#include <scil-error.h>
+#include <scil-workspace.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COUNT 20000
+
+static double data[COUNT];
+static double data_check[COUNT];
+
+static void test_arena(){
+  scilI_workspace_t* ws = scilI_workspace_create();
+  char * a = scilI_workspace_alloc(ws, 100);
+  char * b = scilI_workspace_alloc(ws, 1000);
+  assert((uintptr_t) a % SCIL_WORKSPACE_ALIGNMENT == 0);
+  assert((uintptr_t) b % SCIL_WORKSPACE_ALIGNMENT == 0);
+  memset(a, 1, 100);
+  memset(b, 2, 1000);
+  assert(a[99] == 1);
+
+  // the blocks are merged on reset, afterwards the same allocations fit
+  scilI_workspace_reset(ws);
+  const size_t capacity = scilI_workspace_capacity(ws);
+  scilI_workspace_alloc(ws, 100);
+  scilI_workspace_alloc(ws, 1000);
+  assert(scilI_workspace_capacity(ws) == capacity);
+
+  scilI_workspace_reserve(ws, 100000);
+  assert(scilI_workspace_capacity(ws) >= 100000);
+  scilI_workspace_destroy(ws);
+}
+
+static void test_chain(const char * chain){
+  scil_user_hints_t hints;
+  scil_context_t* ctx;
+  scil_dims_t dims;
+  size_t out_size;
+  int ret;
+
+  scilPr_initialize_user_hints(& hints);
+  hints.absolute_tolerance = 0.001;
+  hints.significant_bits = 20;
+  hints.force_compression_methods = (char*) chain;
+  ret = scilPr_create_context(&ctx, SCIL_TYPE_DOUBLE, 0, NULL, &hints);
+  assert(ret == SCIL_NO_ERR);
+  scilPr_initialize_dims_1d(& dims, COUNT);
+
+  ret = scilPr_reserve_workspace(ctx, & dims);
+  assert(ret == SCIL_NO_ERR);
+  const size_t capacity = scilI_workspace_capacity(ctx->workspace);
+  printf("%s workspace: %zu\n", chain, capacity);
+
+  const size_t bound = scil_compress_bound(ctx, & dims);
+  byte * buff = malloc(bound);
+  byte * tmp = malloc(scilPr_get_compressed_data_size_limit(& dims, SCIL_TYPE_DOUBLE));
+  size_t thread_capacity = 0;
+
+  for(int i=0; i < 10; i++){
+    // smaller buffers fit as well
+    scil_dims_t part;
+    scilPr_initialize_dims_1d(& part, COUNT - i * 1000);
+    ret = scil_compress(buff, bound, data, & part, & out_size, ctx);
+    assert(ret == SCIL_NO_ERR);
+    assert(scilI_workspace_capacity(ctx->workspace) == capacity);
+
+    ret = scil_decompress(SCIL_TYPE_DOUBLE, data_check, & part, buff, out_size, tmp);
+    assert(ret == SCIL_NO_ERR);
+    for(size_t k=0; k < part.length[0]; k++){
+      assert(fabs(data_check[k] - data[k]) <= 0.001);
+    }
+    if (i == 0){
+      thread_capacity = scilI_workspace_capacity(scilI_thread_workspace());
+    }
+    assert(scilI_workspace_capacity(scilI_thread_workspace()) == thread_capacity);
+  }
+
+  free(tmp);
+  free(buff);
+  scilPr_destroy_context(ctx);
+}
+
+int main(){
+  for(int i=0; i < COUNT; i++){
+    data[i] = sin(i / 100.0);
+  }
+
+  test_arena();
+  test_chain("abstol");
+  test_chain("abstol,lz4");
+  test_chain("sigbits,lz4");
+
+  printf("OK\n");
+  return 0;
+}
@@ -14,120 +14,476 @@
 // along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
+#include <scil-bench.h>
 #include <scil-compressors.h>
+#include <scil-config.h>
 #include <scil-data-characteristics.h>
 #include <scil-error.h>
 #include <scil-internal.h>
 #include <scil-patterns.h>
+#include <scil-perf.h>
 #include <scil-util.h>
 
 #define allocate(type, name, count) type* name = (type*)malloc(count * sizeof(type))
 
 static int error_occured = 0;
-static double * buffer_uncompressed;
 
-void benchmark(FILE * f, SCIL_Datatype_t datatype, const char * name, byte * buffer_in, scil_dims_t dims){
+void scilU_check_std_err(char const * what, int ret){
+	if (ret != 0){
+		critical("%s returned the error %s\n", what, strerror(errno));
+		exit(1);
+	}
+}
+
+// with calibration every chain runs on this many threads at once, otherwise on one
+static int threads = 1;
+
+static scilU_bench_config_t bench_config;
+
+// the hardware counters are read around each call if enabled
+static int perf_enabled = 0;
+
+// the measurements are written to these files as well if an output prefix is given
+static FILE * csv_file = NULL;
+static FILE * json_file = NULL;
+static int json_entries = 0;
+
+enum phase_e{
+	COMPRESS,
+	DECOMPRESS
+};
+
+// the state of one thread, the buffers are kept for all repetitions
+typedef struct{
+	SCIL_Datatype_t datatype;
+	const byte * buffer_in;
+	scil_dims_t dims;
+	scil_context_t * ctx;
+	byte * buffer_out;
+	byte * tmp_buff;
+	byte * buffer_uncompressed;
+	size_t buff_size;
 	size_t out_c_size;
+	pthread_barrier_t * barrier;
+	enum phase_e phase;
+	int ret;
+	double seconds;
+	// the hardware counters of all calls of the phase, including the warm-up
+	uint64_t counters[SCILU_PERF_COUNTERS];
+	int counters_available;
+	int calls;
+} run_t;
+
+typedef struct{
+	run_t * runs;
+	pthread_barrier_t barrier;
+} chain_bench_t;
+
+// the threads of a calibration start each phase together
+static void * run_phase(void * arg){
+	run_t * run = (run_t*) arg;
+	// the counters belong to the thread, they are opened outside of the measured time
+	scilU_perf_t perf;
+	if(perf_enabled){
+		run->counters_available = scilU_perf_open(& perf);
+	}
+	pthread_barrier_wait(run->barrier);
+	// the syscalls to start and stop the counters are not part of the measured time
+	if(perf_enabled){
+		scilU_perf_start(& perf);
+	}
+	scil_timer timer;
+	scilU_start_timer(& timer);
+	if(run->phase == COMPRESS){
+		run->ret = scil_compress(run->buffer_out, run->buff_size, (void*) run->buffer_in, & run->dims, & run->out_c_size, run->ctx);
+	}else{
+		run->ret = scil_decompress(run->datatype, run->buffer_uncompressed, & run->dims, run->buffer_out, run->out_c_size, run->tmp_buff);
+	}
+	run->seconds = scilU_stop_timer(timer);
+	if(perf_enabled){
+		scilU_perf_stop(& perf, run->counters);
+	}
+	if(perf_enabled){
+		scilU_perf_close(& perf);
+	}
+	run->calls++;
+	return NULL;
+}
 
-	const size_t buff_size = scilPr_get_compressed_data_size_limit(&dims, datatype);
-	const size_t data_size = scilPr_get_dims_size(&dims, datatype);
+// the counters of a phase per byte of uncompressed data, summed over all threads
+typedef struct{
+	int available;
+	double per_byte[SCILU_PERF_COUNTERS];
+	double ipc;
+} counters_t;
+
+static void collect_counters(const run_t * runs, size_t data_size, counters_t * out){
+	uint64_t sum[SCILU_PERF_COUNTERS] = {0};
+	double bytes = 0;
+	out->available = runs[0].counters_available;
+	for(int t=0; t < threads; t++){
+		for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+			sum[i] += runs[t].counters[i];
+		}
+		bytes += (double) runs[t].calls * data_size;
+	}
+	for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+		out->per_byte[i] = bytes > 0 ? sum[i] / bytes : 0;
+	}
+	out->ipc = sum[SCILU_PERF_CYCLES] > 0 ? (double) sum[SCILU_PERF_INSTRUCTIONS] / sum[SCILU_PERF_CYCLES] : 0;
+}
 
-	allocate(byte, buffer_out, buff_size);
-	allocate(byte, tmp_buff, buff_size);
+// a counter that is unavailable reads 0
+static void print_counters(FILE * out, const char * phase, const counters_t * c){
+	fprintf(out, "  %s:", phase);
+	for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+		fprintf(out, " %.4f %s/B", c->per_byte[i], scilU_perf_counter_name((enum scilU_perf_counter) i));
+	}
+	fprintf(out, ", IPC %.2f\n", c->ipc);
+}
 
-  scil_context_t* ctx;
-  scil_user_hints_t hints;
+// one repetition of the phase on all threads, it takes as long as the slowest thread
+static int measure_phase(void * arg, double * out_seconds){
+	chain_bench_t * b = (chain_bench_t*) arg;
+	pthread_t ids[threads];
+	for(int t=1; t < threads; t++){
+		int ret = pthread_create(& ids[t], NULL, run_phase, & b->runs[t]);
+		scilU_check_std_err("pthread_create", ret);
+	}
+	run_phase(& b->runs[0]);
+	*out_seconds = b->runs[0].seconds;
+	int ret = b->runs[0].ret;
+	for(int t=1; t < threads; t++){
+		pthread_join(ids[t], NULL);
+		*out_seconds = max(*out_seconds, b->runs[t].seconds);
+		ret = ret != 0 ? ret : b->runs[t].ret;
+	}
+	return ret;
+}
 
-  scilPr_initialize_user_hints(&hints);
+static int prepare_run(run_t * run, const char * chain){
+	run->buff_size = scilPr_get_compressed_data_size_limit(& run->dims, run->datatype);
+	run->buffer_out = (byte*) malloc(run->buff_size);
+	run->tmp_buff = (byte*) malloc(run->buff_size);
+	run->buffer_uncompressed = (byte*) malloc(run->buff_size);
+	scilU_bench_prefault(run->buffer_out, run->buff_size);
+	scilU_bench_prefault(run->tmp_buff, run->buff_size);
+	scilU_bench_prefault(run->buffer_uncompressed, run->buff_size);
+
+	scil_user_hints_t hints;
+	scilPr_initialize_user_hints(&hints);
 	hints.absolute_tolerance = SCIL_ACCURACY_DBL_FINEST;
+	char compression_name[1024];
+	snprintf(compression_name, sizeof(compression_name), "%s", chain);
+	hints.force_compression_methods = compression_name;
+	return scilPr_create_context(& run->ctx, run->datatype, 0, NULL, &hints);
+}
 
-	double r = (double) scilI_get_data_randomness(buffer_in, data_size, tmp_buff, buff_size);
+static void release_run(run_t * run){
+	if(run->ctx != NULL){
+		scilPr_destroy_context(run->ctx);
+	}
+	free(run->buffer_out);
+	free(run->tmp_buff);
+	free(run->buffer_uncompressed);
+}
 
-	char * outputFiles = getenv("SCIL_BENCHMARK_OUTPUT");
-	const size_t buffer_size = scilPr_get_compressed_data_size_limit(&dims, datatype);
+/*
+ Runs the chain on all threads at once, the times are those of the slowest thread.
+ The decompression uses the data of the last compression.
+ */
+static int measure(SCIL_Datatype_t datatype, const char * chain, const byte * buffer_in, scil_dims_t dims,
+		scilU_bench_result_t * out_c, scilU_bench_result_t * out_d, double * c_fac, counters_t * out_c_counters, counters_t * out_d_counters){
+	run_t runs[threads];
+	chain_bench_t b;
+	b.runs = runs;
+	pthread_barrier_init(& b.barrier, NULL, threads);
+
+	int ret = 0;
+	for(int t=0; t < threads; t++){
+		runs[t] = (run_t){.datatype = datatype, .buffer_in = buffer_in, .dims = dims, .barrier = & b.barrier};
+		int ret_p = prepare_run(& runs[t], chain);
+		ret = ret != 0 ? ret : ret_p;
+	}
+	const size_t data_size = scilPr_get_dims_size(&dims, datatype);
+	if(ret == 0){
+		ret = scilU_bench_run(& bench_config, measure_phase, & b, out_c);
+		collect_counters(runs, data_size, out_c_counters);
+	}
+	if(ret == 0){
+		for(int t=0; t < threads; t++){
+			runs[t].phase = DECOMPRESS;
+			memset(runs[t].counters, 0, sizeof(runs[t].counters));
+			runs[t].calls = 0;
+		}
+		ret = scilU_bench_run(& bench_config, measure_phase, & b, out_d);
+		collect_counters(runs, data_size, out_d_counters);
+	}
+	*c_fac = (double)(runs[0].out_c_size) / scilPr_get_dims_size(&dims, datatype);
 
-	for(int i=0; i < scilU_get_available_compressor_count(); i++ ){
-		char compression_name[1024];
-		sprintf(compression_name, "%s", scilU_get_compressor_name(i));
-		hints.force_compression_methods = compression_name;
+	for(int t=0; t < threads; t++){
+		release_run(& runs[t]);
+	}
+	pthread_barrier_destroy(& b.barrier);
+	return ret;
+}
 
-		int ret = scilPr_create_context(&ctx, datatype, 0, NULL, &hints);
-		if (ret != 0){
-			printf("Invalid combination %s\n", compression_name);
-			continue;
+// the throughput in MiB/s
+static double mib_per_second(size_t size, double seconds){
+	return size / seconds / 1024 / 1024;
+}
+
+static void write_result(SCIL_Datatype_t datatype, const char * name, const char * chain, size_t data_size, double r, double c_fac,
+		const scilU_bench_result_t * c, const scilU_bench_result_t * d, const counters_t * c_counters, const counters_t * d_counters){
+	const counters_t * counters[] = {c_counters, d_counters};
+	if(csv_file != NULL){
+		fprintf(csv_file, "%s,%d,%d,%s,%s,%zu,%.1f,%.5f,%d,%.1f,%.1f,%.1f,%d,%.1f,%.1f,%.1f", SCIL_VERSION, threads, datatype, name, chain, data_size, r, c_fac,
+			c->repetitions, mib_per_second(data_size, c->median), mib_per_second(data_size, c->p95), mib_per_second(data_size, c->p5),
+			d->repetitions, mib_per_second(data_size, d->median), mib_per_second(data_size, d->p95), mib_per_second(data_size, d->p5));
+		for(int p=0; p < 2 && perf_enabled; p++){
+			for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+				fprintf(csv_file, ",%.4f", counters[p]->per_byte[i]);
+			}
+			fprintf(csv_file, ",%.3f", counters[p]->ipc);
 		}
-		assert(ctx != NULL);
-		int ret_c;
-		int ret_d;
-
-		scil_timer timer;
-		scilU_start_timer(& timer);
-		ret_c = scil_compress(buffer_out, buff_size, buffer_in, & dims, & out_c_size, ctx);
-		double seconds_compress = scilU_stop_timer(timer);
-		ret_d = -1;
-
-		double seconds_decompress;
-		if(ret_c == 0){
-			// initialize memory
-			memset(buffer_uncompressed, -1, buffer_size);
-
-			scilU_start_timer(& timer);
-			ret_d = scil_decompress(datatype, buffer_uncompressed, & dims, buffer_out, out_c_size, tmp_buff);
-			seconds_decompress = scilU_stop_timer(timer);
-		}else{
-			seconds_decompress = 1;
+		fprintf(csv_file, "\n");
+	}
+	if(json_file != NULL){
+		fprintf(json_file, "%s\n    {\"datatype\": %d, \"pattern\": \"%s\", \"chain\": \"%s\", \"size\": %zu, \"randomness\": %.1f, \"ratio\": %.5f,\n", json_entries++ > 0 ? "," : "",
+			datatype, name, chain, data_size, r, c_fac);
+		const scilU_bench_result_t * phases[] = {c, d};
+		const char * phase_names[] = {"compression", "decompression"};
+		for(int i=0; i < 2; i++){
+			const scilU_bench_result_t * p = phases[i];
+			fprintf(json_file, "     \"%s\": {\"repetitions\": %d, \"median\": %.1f, \"p5\": %.1f, \"p95\": %.1f", phase_names[i], p->repetitions,
+				mib_per_second(data_size, p->median), mib_per_second(data_size, p->p95), mib_per_second(data_size, p->p5));
+			if(perf_enabled){
+				fprintf(json_file, ", \"per byte\": {");
+				for(int c=0; c < SCILU_PERF_COUNTERS; c++){
+					fprintf(json_file, "\"%s\": %.4f, ", scilU_perf_counter_name((enum scilU_perf_counter) c), counters[i]->per_byte[c]);
+				}
+				fprintf(json_file, "\"IPC\": %.3f}", counters[i]->ipc);
+			}
+			fprintf(json_file, "}%s", i == 0 ? ",\n" : "}");
 		}
+	}
+}
 
-		if ( ret_c == 0 && ret_d == 0 && outputFiles != NULL ){
-			// dump the file
-			char filename[1024];
-			sprintf(filename,"%s-%s.csv", name, compression_name);
-			// TODO
-			//scilU_plot(filename, dims, (double*) buffer_uncompressed);
-		}
+void benchmark(FILE * f, SCIL_Datatype_t datatype, const char * name, byte * buffer_in, scil_dims_t dims){
+	const size_t buff_size = scilPr_get_compressed_data_size_limit(&dims, datatype);
+	const size_t data_size = scilPr_get_dims_size(&dims, datatype);
 
+	allocate(byte, tmp_buff, buff_size);
+	double r = (double) scilI_get_data_randomness(buffer_in, data_size, tmp_buff, buff_size);
+	free(tmp_buff);
 
-		if (ret_c != 0 || ret_d != 0 ){
+	for(int i=0; i < scilU_get_available_compressor_count(); i++ ){
+		const char * compression_name = scilU_get_compressor_name(i);
+		scilU_bench_result_t c, d;
+		counters_t c_counters, d_counters;
+		double c_fac;
+
+		int ret = measure(datatype, compression_name, buffer_in, dims, & c, & d, & c_fac, & c_counters, & d_counters);
+		if (ret == SCIL_EINVAL){
+			printf("Invalid combination %s\n", compression_name);
+			continue;
+		}
+		if (ret != 0){
 			error_occured = 1;
-			printf("Warning: compression %s returned an error!\n",  hints.force_compression_methods);
+			printf("Warning: compression %s returned an error!\n", compression_name);
 			continue;
 		}
-		double c_fac = (double)(out_c_size) / data_size;
-
-		fprintf(f, "%.1f; %d; %s; %s; %.1lf; %.1lf; %.3lf\n",
-			r, datatype, name, hints.force_compression_methods,
-			data_size/seconds_compress/1024 /1024, data_size/seconds_decompress/1024 /1024, c_fac);
+		// the median is robust against a disturbed repetition
+		fprintf(f, "%.1f; %d; %s; %s; %.1lf; %.1lf; %.3lf\n", r, datatype, name, compression_name,
+			mib_per_second(data_size, c.median), mib_per_second(data_size, d.median), c_fac);
+		if(perf_enabled && c_counters.available > 0){
+			printf("%s %s %d\n", name, compression_name, datatype);
+			print_counters(stdout, "compression", & c_counters);
+			print_counters(stdout, "decompression", & d_counters);
+		}
+		write_result(datatype, name, compression_name, data_size, r, c_fac, & c, & d, & c_counters, & d_counters);
   }
-	free(buffer_out);
-	free(tmp_buff);
 }
 
-void scilU_check_std_err(char const * what, int ret){
-	if (ret != 0){
-		critical("%s returned the error %s\n", what, strerror(errno));
-		exit(1);
+// copies the buffer back and forth a few times and returns the MiB/s
+static double memcpy_bandwidth(size_t size){
+	const int repeats = 10;
+	allocate(byte, a, size);
+	allocate(byte, b, size);
+	// touch the pages before the measurement
+	memset(a, 1, size);
+	memset(b, 2, size);
+	scil_timer timer;
+	scilU_start_timer(& timer);
+	for(int i=0; i < repeats; i++){
+		memcpy(i % 2 ? a : b, i % 2 ? b : a, size);
+	}
+	double seconds = scilU_stop_timer(timer);
+	// use the copy, thus it is not optimized away
+	volatile byte last = b[size - 1];
+	(void) last;
+	free(a);
+	free(b);
+	return (double) size * repeats / seconds / 1024 / 1024;
+}
+
+// writes a file of size bytes into the directory, including the time to flush it to the device, and returns the MiB/s
+static double file_write_bandwidth(const char * directory, size_t size){
+	char filename[4096];
+	snprintf(filename, sizeof(filename), "%s/scil-benchmark-XXXXXX", directory);
+	int fd = mkstemp(filename);
+	scilU_check_std_err("mkstemp", fd < 0);
+
+	const size_t block = 8 * 1024 * 1024;
+	allocate(byte, buffer, block);
+	// random content, thus a compressing file system does not fake the bandwidth
+	for(size_t i=0; i < block; i++){
+		buffer[i] = (byte) rand();
+	}
+	scil_timer timer;
+	scilU_start_timer(& timer);
+	for(size_t written = 0; written < size; written += block){
+		ssize_t ret = write(fd, buffer, block);
+		scilU_check_std_err("write", ret != (ssize_t) block);
+	}
+	scilU_check_std_err("fsync", fsync(fd));
+	double seconds = scilU_stop_timer(timer);
+	close(fd);
+	unlink(filename);
+	free(buffer);
+
+	const size_t written = (size + block - 1) / block * block;
+	return (double) written / seconds / 1024 / 1024;
+}
+
+static void usage(const char * name){
+	printf("Synopsis: %s [-c <directory>] [-n <network MiB/s>] [-j <threads>] [-s <file MiB>] [-o <prefix>] [-w <runs>] [-r <runs>] [-t <seconds>] [-p] [x [y [z]]]\n", name);
+	printf("  -c calibrates this machine: the chains run on all cores at once and the storage limit is measured by writing to the directory\n");
+	printf("  -n the network limit to record, it is not measured\n");
+	printf("  -j the number of threads of the calibration, by default the number of cores\n");
+	printf("  -s the size of the file written by the calibration, 1024 MiB by default\n");
+	printf("  -o writes the median, 5th and 95th percentile of the throughput to <prefix>.csv and <prefix>.json\n");
+	printf("  -w the warm-up runs before each measurement, 2 by default\n");
+	printf("  -r the maximum repetitions of a measurement, it stops earlier once the 95%% confidence interval is within 2%% of the mean; 100 by default\n");
+	printf("  -t the time after which a measurement stops repeating, 10 seconds by default\n");
+	printf("  -p reads the hardware counters around each call and reports cycles, instructions, LLC misses and branch misses per byte and the IPC\n");
+}
+
+static void open_outputs(const char * prefix, const scil_dims_t * dims){
+	char filename[4096];
+	snprintf(filename, sizeof(filename), "%s.csv", prefix);
+	csv_file = fopen(filename, "w");
+	scilU_check_std_err("fopen", csv_file == NULL);
+	fprintf(csv_file, "version,threads,datatype,pattern,chain,size,randomness,ratio,"
+		"compression repetitions,compression median MiB/s,compression p5 MiB/s,compression p95 MiB/s,"
+		"decompression repetitions,decompression median MiB/s,decompression p5 MiB/s,decompression p95 MiB/s");
+	const char * phases[] = {"compression", "decompression"};
+	for(int p=0; p < 2 && perf_enabled; p++){
+		for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+			fprintf(csv_file, ",%s %s/B", phases[p], scilU_perf_counter_name((enum scilU_perf_counter) i));
+		}
+		fprintf(csv_file, ",%s IPC", phases[p]);
+	}
+	fprintf(csv_file, "\n");
+
+	snprintf(filename, sizeof(filename), "%s.json", prefix);
+	json_file = fopen(filename, "w");
+	scilU_check_std_err("fopen", json_file == NULL);
+	fprintf(json_file, "{\"version\": \"%s\", \"threads\": %d, \"warmup\": %d, \"dims\": [", SCIL_VERSION, threads, bench_config.warmup);
+	for(int d=0; d < dims->dims; d++){
+		fprintf(json_file, "%s%zu", d > 0 ? ", " : "", dims->length[d]);
+	}
+	fprintf(json_file, "], \"unit\": \"MiB/s\",\n  \"results\": [");
+}
+
+static void close_outputs(){
+	if(csv_file != NULL){
+		scilU_check_std_err("fclose", fclose(csv_file));
+	}
+	if(json_file != NULL){
+		fprintf(json_file, "\n  ]\n}\n");
+		scilU_check_std_err("fclose", fclose(json_file));
 	}
 }
 
-#pragma GCC diagnostic ignored "-Wunused-parameter"
 int main(int argc, char** argv){
 	int ret;
 	scil_dims_t dims;
+	const char * calibration_directory = NULL;
+	double network = 0;
+	size_t file_size = 1024;
+	int calibration_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	const char * output_prefix = NULL;
+	scilU_bench_config_init(& bench_config);
+
+	int opt;
+	while((opt = getopt(argc, argv, "c:n:j:s:o:w:r:t:ph")) != -1){
+		switch(opt){
+			case 'c':
+				calibration_directory = optarg;
+				break;
+			case 'n':
+				network = atof(optarg);
+				break;
+			case 'j':
+				calibration_threads = atoi(optarg);
+				break;
+			case 's':
+				file_size = (size_t) atol(optarg);
+				break;
+			case 'o':
+				output_prefix = optarg;
+				break;
+			case 'w':
+				bench_config.warmup = atoi(optarg);
+				break;
+			case 'r':
+				bench_config.max_repetitions = atoi(optarg);
+				bench_config.min_repetitions = min(bench_config.min_repetitions, bench_config.max_repetitions);
+				break;
+			case 't':
+				bench_config.max_seconds = atof(optarg);
+				break;
+			case 'p':
+				perf_enabled = 1;
+				break;
+			default:
+				usage(argv[0]);
+				exit(opt == 'h' ? 0 : 1);
+		}
+	}
+	if(calibration_directory != NULL){
+		threads = max(calibration_threads, 1);
+	}
+	if(perf_enabled){
+		scilU_perf_t perf;
+		const int available = scilU_perf_open(& perf);
+		scilU_perf_close(& perf);
+		if(available == 0){
+			printf("The hardware counters are unavailable, they are not reported; check /proc/sys/kernel/perf_event_paranoid\n");
+		}else if(available < SCILU_PERF_COUNTERS){
+			printf("Only %d of %d hardware counters are available, the others are reported as 0\n", available, SCILU_PERF_COUNTERS);
+		}
+		perf_enabled = available > 0;
+	}
 
-	if (argc != 1){
-	  switch(argc - 1){
+	if (argc != optind){
+	  switch(argc - optind){
 	    case (1):{
-	  	  scilPr_initialize_dims_1d(& dims, atol(argv[1]));
+	  	  scilPr_initialize_dims_1d(& dims, atol(argv[optind]));
 	      break;
 	    }case (2):{
-	      scilPr_initialize_dims_2d(& dims, atol(argv[1]), atol(argv[2]));
+	      scilPr_initialize_dims_2d(& dims, atol(argv[optind]), atol(argv[optind + 1]));
 	      break;
 	    }case (3):{
-	      scilPr_initialize_dims_3d(& dims, atol(argv[1]), atol(argv[2]), atol(argv[3]));
+	      scilPr_initialize_dims_3d(& dims, atol(argv[optind]), atol(argv[optind + 1]), atol(argv[optind + 2]));
 	      break;
 	    }default:{
 	      printf("Error will only benchmark up to 3D\n");
@@ -140,11 +496,28 @@ int main(int argc, char** argv){
 
 	int bufferSize = scilPr_get_compressed_data_size_limit(&dims, SCIL_TYPE_DOUBLE);
 	double * buffer_in = (double*) malloc(bufferSize);
-	buffer_uncompressed = malloc(bufferSize);
 
 	printf("This program creates a new scil.conf by measuring performance\n");
 
 	FILE * f = fopen("scil.conf.bak", "w+");
+	scilU_check_std_err("fopen", f == NULL);
+	if(output_prefix != NULL){
+		open_outputs(output_prefix, & dims);
+	}
+
+	if(calibration_directory != NULL){
+		const double memory = memcpy_bandwidth(bufferSize);
+		printf("memcpy: %.1f MiB/s\n", memory);
+		const double storage = file_write_bandwidth(calibration_directory, file_size * 1024 * 1024);
+		printf("writing to %s: %.1f MiB/s\n", calibration_directory, storage);
+
+		fprintf(f, "# calibrated with %d threads compressing at once, the throughput of the chains is per thread\n", threads);
+		fprintf(f, "# memcpy bandwidth of a single thread %.1f MiB/s\n", memory);
+		fprintf(f, "!storage %.1f\n", storage);
+		if(network > 0){
+			fprintf(f, "!network %.1f\n", network);
+		}
+	}
 	{
 		char * str = "#randomness; data type; pattern name; compressor name; compr. performance MiB; decompr. performance MiB; inverse compr. ratio\n";
 		ret = fwrite(str, strlen(str), 1, f);
@@ -168,12 +541,12 @@ int main(int argc, char** argv){
 		}
 	}
 	fclose(f);
+	close_outputs();
 	ret = rename("scil.conf.bak", "scil.conf");
 	scilU_check_std_err("rename", ret);
 
 
 	free(buffer_in);
-	free(buffer_uncompressed);
 
 	return error_occured;
 }
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+
+# Trains the decision tree of the automatic chain selection from the CSV files of
+# scil-generate-chooser-data and scil-generate-chooser-data2.
+# The model file is read by the library from the environment variable SCIL_CHOOSER_MODEL_FILE,
+# the format is described in src/compression/scil-chooser-model.h.
+
+import argparse
+import csv
+import math
+import sys
+
+# the names the generators record and the chains of the library
+CHAINS = {
+  "memcpy" : "memcopy",
+  "abstol" : "abstol",
+  "gzip" : "gzip",
+  "sigbits" : "sigbits",
+  "fpzip" : "fpzip",
+  "zfp_abstol" : "zfp-abstol",
+  "zfp_precision" : "zfp-precision",
+  "lz4fast" : "lz4"
+}
+
+# keep in sync with scilC_chooser_model_features()
+FEATURES = ["dims", "log2_count", "mean", "stddev", "max_step", "abs_tol", "rel_tol"]
+
+# the columns that describe one data set, all algorithms are measured with it
+EXPERIMENT = ["Value count", "Dimensionality", "Minimum", "Maximum", "Average", "Standard deviation",
+              "Maximum step", "Absolute error tolerance", "Relative error tolerance"]
+
+LEAF_CHAINS = 8
+
+def features(row):
+  count = float(row["Value count"])
+  mn = float(row["Minimum"])
+  rng = float(row["Maximum"]) - mn
+  def scaled(value):
+    return value / rng if rng > 0 else 0.0
+  abs_tol = float(row["Absolute error tolerance"])
+  rel_tol = float(row["Relative error tolerance"])
+  return [float(row["Dimensionality"]),
+          math.log2(count) if count > 0 else 0.0,
+          scaled(float(row["Average"]) - mn),
+          scaled(float(row["Standard deviation"])),
+          scaled(float(row["Maximum step"])),
+          (abs_tol / rng if rng > 0 else 1.0) if abs_tol > 0 else 0.0,
+          rel_tol if rel_tol > 0 else 0.0]
+
+# the seconds to compress, write, read and decompress one MB, the generators record the throughput in MB/s
+def cost(row, io):
+  c = float(row["Compression throughput"])
+  d = float(row["Decompression throughput"])
+  ratio = float(row["Compression ratio"])
+  if c <= 0 or d <= 0 or ratio <= 0 or math.isinf(c) or math.isinf(d):
+    return None
+  return 1.0 / c + 1.0 / d + 2.0 / ratio / io
+
+# consecutive rows with the same data set form one sample
+def read_samples(filenames, io):
+  samples = []
+  for filename in filenames:
+    with open(filename) as f:
+      last = None
+      for row in csv.DictReader(f):
+        chain = CHAINS.get(row["Algorithm"])
+        time = cost(row, io)
+        if chain is None or time is None:
+          continue
+        key = tuple(row[c] for c in EXPERIMENT)
+        if key != last:
+          samples.append((features(row), {}))
+          last = key
+        samples[-1][1][chain] = time
+  return samples
+
+class Tree:
+  def __init__(self, samples, chains, max_depth, min_leaf):
+    self.chains = chains
+    self.max_depth = max_depth
+    self.min_leaf = min_leaf
+    # a chain that failed for a sample is penalized with ten times the slowest time
+    self.costs = []
+    for f, times in samples:
+      worst = 10 * max(times.values())
+      best = min(times.values())
+      self.costs.append([times.get(c, worst) - best for c in chains])
+    self.features = [f for f, times in samples]
+    self.nodes = []
+
+  def regret(self, indices):
+    sums = [0.0] * len(self.chains)
+    for i in indices:
+      for c, r in enumerate(self.costs[i]):
+        sums[c] += r
+    return sums
+
+  # the threshold between the values with the smallest total regret of the best chain on each side
+  def best_split(self, indices, total):
+    best = None
+    for f in range(len(FEATURES)):
+      order = sorted(indices, key = lambda i: self.features[i][f])
+      left = [0.0] * len(self.chains)
+      for pos in range(len(order) - 1):
+        i = order[pos]
+        for c, r in enumerate(self.costs[i]):
+          left[c] += r
+        lo = self.features[i][f]
+        hi = self.features[order[pos + 1]][f]
+        if lo == hi or pos + 1 < self.min_leaf or len(order) - pos - 1 < self.min_leaf:
+          continue
+        regret = min(left) + min(t - l for t, l in zip(total, left))
+        if best is None or regret < best[0]:
+          best = (regret, f, (lo + hi) / 2, order[:pos + 1], order[pos + 1:])
+    return best
+
+  def build(self, indices, depth):
+    node = len(self.nodes)
+    self.nodes.append(None)
+    total = self.regret(indices)
+    split = None
+    if depth < self.max_depth and len(indices) >= 2 * self.min_leaf:
+      split = self.best_split(indices, total)
+    if split is None or split[0] >= min(total) * (1 - 1e-6):
+      ranking = sorted(range(len(self.chains)), key = lambda c: total[c])
+      self.nodes[node] = ("leaf", [self.chains[c] for c in ranking[:LEAF_CHAINS]])
+      return node
+    regret, f, threshold, left, right = split
+    l = self.build(left, depth + 1)
+    r = self.build(right, depth + 1)
+    self.nodes[node] = (FEATURES[f], threshold, l, r)
+    return node
+
+def write_model(out, tree, args):
+  out.write("# trained by scil-train-chooser-model.py from %s with %.1f MB/s I/O\n" % (" ".join(args.csv), args.io))
+  out.write("# node; feature; threshold; left; right\n")
+  out.write("# node; leaf; chains ranked by the time\n")
+  for i, n in enumerate(tree.nodes):
+    if n[0] == "leaf":
+      out.write("%d; leaf; %s\n" % (i, "; ".join(n[1])))
+    else:
+      out.write("%d; %s; %.9g; %d; %d\n" % (i, n[0], n[1], n[2], n[3]))
+
+def main():
+  parser = argparse.ArgumentParser(description = "Trains the chooser model from the output of scil-generate-chooser-data.")
+  parser.add_argument("csv", nargs = "+", help = "the CSV files of the generators")
+  parser.add_argument("-o", "--output", help = "the model file, standard output by default")
+  parser.add_argument("--io", type = float, default = 100, help = "the throughput of the storage in MB/s")
+  parser.add_argument("--max-depth", type = int, default = 6)
+  parser.add_argument("--min-leaf", type = int, default = 5, help = "the minimum number of data sets in a leaf")
+  args = parser.parse_args()
+
+  samples = read_samples(args.csv, args.io)
+  if len(samples) == 0:
+    print("No measurements in %s" % " ".join(args.csv), file = sys.stderr)
+    sys.exit(1)
+  chains = sorted(set(c for f, times in samples for c in times))
+  tree = Tree(samples, chains, args.max_depth, args.min_leaf)
+  tree.build(list(range(len(samples))), 0)
+
+  if args.output is None:
+    write_model(sys.stdout, tree, args)
+  else:
+    with open(args.output, "w") as out:
+      write_model(out, tree, args)
+  print("%d data sets, %d chains, %d nodes" % (len(samples), len(chains), len(tree.nodes)), file = sys.stderr)
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,116 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <scil-bench.h>
+
+#include <scil-util.h>
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+
+void scilU_bench_config_init(scilU_bench_config_t* config){
+  config->warmup = 2;
+  config->min_repetitions = 5;
+  config->max_repetitions = 100;
+  config->max_seconds = 10;
+  config->confidence = 0.02;
+}
+
+void scilU_bench_prefault(void* buffer, size_t size){
+  const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  volatile char * p = (volatile char*) buffer;
+  for(size_t i=0; i < size; i += page){
+    p[i] = 0;
+  }
+  if(size > 0){
+    p[size - 1] = 0;
+  }
+}
+
+// the two-sided 95% quantile of Student's t-distribution with n - 1 degrees of freedom
+static double t_quantile(int n){
+  static const double quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  const int df = n - 1;
+  return df <= 30 ? quantiles[df - 1] : 1.96;
+}
+
+static int compare_double(const void* a, const void* b){
+  const double x = *(const double*) a;
+  const double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+// linear interpolation between the closest ranks
+static double percentile(const double* sorted, int n, double p){
+  const double rank = p * (n - 1);
+  const int lower = (int) rank;
+  if(lower + 1 >= n){
+    return sorted[n - 1];
+  }
+  return sorted[lower] + (rank - lower) * (sorted[lower + 1] - sorted[lower]);
+}
+
+int scilU_bench_run(const scilU_bench_config_t* config, scilU_bench_func_t func, void* arg, scilU_bench_result_t* out){
+  memset(out, 0, sizeof(scilU_bench_result_t));
+  double seconds;
+  for(int i=0; i < config->warmup; i++){
+    int ret = func(arg, & seconds);
+    if(ret != 0){
+      return ret;
+    }
+  }
+
+  const int max_repetitions = config->max_repetitions > 0 ? config->max_repetitions : 1;
+  double * times = (double*) malloc(max_repetitions * sizeof(double));
+  double sum = 0;
+  double sum_squares = 0;
+  int n = 0;
+  scil_timer total;
+  scilU_start_timer(& total);
+  while(n < max_repetitions){
+    int ret = func(arg, & seconds);
+    if(ret != 0){
+      free(times);
+      return ret;
+    }
+    times[n++] = seconds;
+    sum += seconds;
+    sum_squares += seconds * seconds;
+
+    const double mean = sum / n;
+    if(n > 1){
+      const double variance = max((sum_squares - n * mean * mean) / (n - 1), 0.0);
+      out->interval = t_quantile(n) * sqrt(variance / n);
+    }else{
+      out->interval = INFINITY;
+    }
+    if(n >= config->min_repetitions && (out->interval <= config->confidence * mean || scilU_stop_timer(total) >= config->max_seconds)){
+      break;
+    }
+  }
+
+  qsort(times, n, sizeof(double), compare_double);
+  out->repetitions = n;
+  out->mean = sum / n;
+  out->median = percentile(times, n, 0.5);
+  out->p5 = percentile(times, n, 0.05);
+  out->p95 = percentile(times, n, 0.95);
+  free(times);
+  return 0;
+}
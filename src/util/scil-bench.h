@@ -0,0 +1,72 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SCIL_BENCH_H
+#define SCIL_BENCH_H
+
+/**
+ * \file
+ * \brief Repeated measurements for benchmarks, a measurement stops once its mean is known precisely enough.
+ */
+
+#include <stdlib.h>
+
+typedef struct{
+  // runs that are not measured, they fill the caches and fault in the pages
+  int warmup;
+  int min_repetitions;
+  int max_repetitions;
+  // no further repetition is started after this time, unless there are less than min_repetitions
+  double max_seconds;
+  // the measurement stops once the 95% confidence interval of the mean is within this fraction of the mean
+  double confidence;
+} scilU_bench_config_t;
+
+typedef struct{
+  int repetitions;
+  // in seconds
+  double mean;
+  double median;
+  double p5;
+  double p95;
+  // the half width of the 95% confidence interval of the mean
+  double interval;
+} scilU_bench_result_t;
+
+/**
+ * \brief Runs the code to measure once.
+ * \param out_seconds the time of the run, the function excludes its own preparation this way
+ * \return 0 on success, a failure stops the benchmark
+ */
+typedef int (*scilU_bench_func_t)(void* arg, double* out_seconds);
+
+/**
+ * \brief Sets the defaults: 2 warm-up runs, 5 to 100 repetitions within 10 seconds and a confidence interval of 2%.
+ */
+void scilU_bench_config_init(scilU_bench_config_t* config);
+
+/**
+ * \brief Writes to every page of the buffer, thus page faults do not distort the first measurement.
+ */
+void scilU_bench_prefault(void* buffer, size_t size);
+
+/**
+ * \brief Calls the function for the warm-up and then repeatedly until the confidence interval is tight or a limit is reached.
+ * \return 0, or the first error of the function
+ */
+int scilU_bench_run(const scilU_bench_config_t* config, scilU_bench_func_t func, void* arg, scilU_bench_result_t* out);
+
+#endif // SCIL_BENCH_H
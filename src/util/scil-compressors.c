@@ -24,20 +24,8 @@ scilI_algorithm_t* algo_array[] = {
 
 int scilU_get_available_compressor_count()
 {
-	static int count = -1;
-	if (count > 0){
-		return count;
-	}
-
-	scilI_algorithm_t ** cur = algo_array;
-	count = 0;
-	// count
-	while(*cur != NULL){
-		count++;
-		cur++;
-	}
-
-	return count;
+	// the array is terminated by NULL
+	return (int) (sizeof(algo_array) / sizeof(*algo_array)) - 1;
 }
 
 const char* scilU_get_compressor_name(int number)
@@ -5,7 +5,9 @@ static const char* scil_error_messages[] = {
     "Error code 1: Buffer overflow.",
     "Error code 2: Not enough memory.",
     "Error code 3: Invalid argument.",
-    "Error code 4: Precision too strict."
+    "Error code 4: Unknown error.",
+    "Error code 5: Precision too strict.",
+    "Error code 6: Input/output error."
 };
 
 const char* scil_error_get_message(enum scil_error_code err)
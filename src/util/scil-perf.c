@@ -0,0 +1,115 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <scil-perf.h>
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+static const struct{
+  uint32_t type;
+  uint64_t config;
+} events[SCILU_PERF_COUNTERS] = {
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+int scilU_perf_open(scilU_perf_t* perf){
+  int available = 0;
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    struct perf_event_attr attr;
+    memset(& attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = events[i].type;
+    attr.config = events[i].config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // the calling thread on any CPU
+    perf->fd[i] = (int) syscall(SYS_perf_event_open, & attr, 0, -1, -1, 0);
+    if(perf->fd[i] >= 0){
+      available++;
+    }
+  }
+  return available;
+}
+
+void scilU_perf_start(scilU_perf_t* perf){
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    if(perf->fd[i] >= 0){
+      ioctl(perf->fd[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void scilU_perf_stop(scilU_perf_t* perf, uint64_t out_values[SCILU_PERF_COUNTERS]){
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    if(perf->fd[i] >= 0){
+      ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    // value, time enabled, time running
+    uint64_t data[3];
+    if(perf->fd[i] < 0 || read(perf->fd[i], data, sizeof(data)) != sizeof(data) || data[2] == 0){
+      continue;
+    }
+    out_values[i] += data[2] < data[1] ? (uint64_t) ((double) data[0] * data[1] / data[2]) : data[0];
+  }
+}
+
+void scilU_perf_close(scilU_perf_t* perf){
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    if(perf->fd[i] >= 0){
+      close(perf->fd[i]);
+    }
+    perf->fd[i] = -1;
+  }
+}
+
+#else
+
+int scilU_perf_open(scilU_perf_t* perf){
+  for(int i=0; i < SCILU_PERF_COUNTERS; i++){
+    perf->fd[i] = -1;
+  }
+  return 0;
+}
+
+void scilU_perf_start(scilU_perf_t* perf){
+}
+
+void scilU_perf_stop(scilU_perf_t* perf, uint64_t out_values[SCILU_PERF_COUNTERS]){
+}
+
+void scilU_perf_close(scilU_perf_t* perf){
+}
+
+#endif
+
+const char* scilU_perf_counter_name(enum scilU_perf_counter counter){
+  static const char* names[SCILU_PERF_COUNTERS] = {"cycles", "instructions", "LLC misses", "branch misses"};
+  return names[counter];
+}
@@ -0,0 +1,66 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SCIL_PERF_H
+#define SCIL_PERF_H
+
+/**
+ * \file
+ * \brief Hardware performance counters of the calling thread, read with perf_event_open on Linux.
+ * Only user space is counted, thus the counters work with the default perf_event_paranoid setting.
+ * A counter that the CPU, the kernel or a virtual machine does not provide is reported as unavailable.
+ */
+
+#include <stdint.h>
+
+enum scilU_perf_counter{
+  SCILU_PERF_CYCLES,
+  SCILU_PERF_INSTRUCTIONS,
+  SCILU_PERF_LLC_MISSES,
+  SCILU_PERF_BRANCH_MISSES,
+  SCILU_PERF_COUNTERS
+};
+
+typedef struct{
+  // -1 if the counter is unavailable
+  int fd[SCILU_PERF_COUNTERS];
+} scilU_perf_t;
+
+/**
+ * \brief Opens the counters for the calling thread.
+ * \return the number of available counters
+ */
+int scilU_perf_open(scilU_perf_t* perf);
+
+/**
+ * \brief Resets and starts the counters.
+ */
+void scilU_perf_start(scilU_perf_t* perf);
+
+/**
+ * \brief Stops the counters and adds their values to out_values.
+ * If the kernel multiplexed a counter, its value is extrapolated to the whole time the counters were started.
+ */
+void scilU_perf_stop(scilU_perf_t* perf, uint64_t out_values[SCILU_PERF_COUNTERS]);
+
+void scilU_perf_close(scilU_perf_t* perf);
+
+/**
+ * \brief Returns the name of the counter, e.g., "cycles".
+ */
+const char* scilU_perf_counter_name(enum scilU_perf_counter counter);
+
+#endif // SCIL_PERF_H
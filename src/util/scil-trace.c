@@ -0,0 +1,102 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <scil-trace.h>
+
+#include <scil-internal.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+static pthread_once_t initialize_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* trace_file = NULL;
+static int event_count = 0;
+
+static void finish_at_exit()
+{
+  pthread_mutex_lock(&lock);
+  fprintf(trace_file, "\n]\n");
+  fclose(trace_file);
+  trace_file = NULL;
+  pthread_mutex_unlock(&lock);
+}
+
+static void initialize()
+{
+  const char* pattern = getenv("SCIL_TRACE");
+  if (pattern == NULL || pattern[0] == 0) {
+    return;
+  }
+  char filename[4096];
+  const char* pid = strstr(pattern, "%p");
+  if (pid != NULL) {
+    snprintf(filename, sizeof(filename), "%.*s%d%s", (int)(pid - pattern), pattern, (int) getpid(), pid + 2);
+  } else {
+    snprintf(filename, sizeof(filename), "%s", pattern);
+  }
+  trace_file = fopen(filename, "w");
+  if (trace_file == NULL) {
+    warn("Could not open the trace file %s\n", filename);
+    return;
+  }
+  fprintf(trace_file, "[\n");
+  atexit(finish_at_exit);
+}
+
+int scilU_trace_enabled()
+{
+  pthread_once(&initialize_once, initialize);
+  return trace_file != NULL;
+}
+
+static long thread_id()
+{
+#ifdef __linux__
+  // the kernel thread ID is the one other tools, e.g., perf, report
+  return (long) syscall(SYS_gettid);
+#else
+  return (long) pthread_self();
+#endif
+}
+
+void scilU_trace_span(const char* name, const char* category, scil_timer start, size_t bytes_in, size_t bytes_out)
+{
+  scil_timer end;
+  scilU_start_timer(&end);
+  const double ts  = start.tv_sec * 1e6 + start.tv_nsec / 1e3;
+  const double dur = scilU_time_to_double(scilU_time_diff(end, start)) * 1e6;
+
+  char args[100] = "";
+  if (bytes_in != 0 || bytes_out != 0) {
+    snprintf(args, sizeof(args), ",\"args\":{\"bytes_in\":%zu,\"bytes_out\":%zu}", bytes_in, bytes_out);
+  }
+  const long tid = thread_id();
+
+  pthread_mutex_lock(&lock);
+  if (trace_file != NULL) {
+    fprintf(trace_file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld%s}",
+            event_count == 0 ? "" : ",\n", name, category, ts, dur, (int) getpid(), tid, args);
+    event_count++;
+  }
+  pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,45 @@
+// This file is part of SCIL.
+//
+// SCIL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SCIL is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with SCIL.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SCIL_TRACE_H
+#define SCIL_TRACE_H
+
+/**
+ * \file
+ * \brief Timeline of the library in the Chrome trace event format, it is shown by chrome://tracing and Perfetto.
+ * Tracing is enabled by the environment variable SCIL_TRACE=<file>, "%p" in the name is replaced by the process ID.
+ * Each span is a complete event ("ph":"X") tagged with the process and thread ID, the timestamps are microseconds
+ * of CLOCK_MONOTONIC, thus they line up with other traces of the application that use this clock.
+ * The file is terminated when the process exits; viewers accept a file of a crashed process without the terminating bracket.
+ */
+
+#include <scil-util.h>
+
+/**
+ * \brief Returns 1 if SCIL_TRACE is set, the check is cheap enough to guard each span.
+ */
+int scilU_trace_enabled();
+
+/**
+ * \brief Records a span from start until now.
+ * \param name The name of the span, it must not need escaping in JSON
+ * \param category The category, e.g., "compress"
+ * \param start The beginning of the span, set with scilU_start_timer()
+ * \param bytes_in Recorded as argument of the event unless both sizes are 0
+ */
+void scilU_trace_span(const char* name, const char* category, scil_timer start, size_t bytes_in, size_t bytes_out);
+
+#endif // SCIL_TRACE_H
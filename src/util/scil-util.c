@@ -15,62 +15,23 @@
 
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <scil-util.h>
 #include <scil-quantizer.h>
+#include <scil-data-stats.h>
+#include <scil-error.h>
+#include <scil-internal.h>
 
 void scilU_find_minimum_maximum(SCIL_Datatype_t datatype, byte * data, scil_dims_t * dims, double * out_min, double * out_max){
-  size_t count = scilPr_get_dims_count(dims);
-
-  switch(datatype){
-  case (SCIL_TYPE_DOUBLE): {
-    scil_find_minimum_maximum_double((double*) data, count, out_min, out_max);
-    return;
-  }
-  case (SCIL_TYPE_FLOAT) : {
-    float min, max;
-    scil_find_minimum_maximum_float((float*) data, count, & min, & max);
-    *out_min = (double) min;
-    *out_max = (double) max;
-    return;
-  }
-  case(SCIL_TYPE_INT8):{
-    int8_t min, max;
-    scil_find_minimum_maximum_int8_t((int8_t*)data, count, & min, & max);
-    *out_min = (double) min;
-    *out_max = (double) max;
-    return;
-  }
-  case(SCIL_TYPE_INT16):{
-    int16_t min, max;
-    scil_find_minimum_maximum_int16_t((int16_t*)data, count, & min, & max);
-    *out_min = (double) min;
-    *out_max = (double) max;
-    return;
-  }
-  case(SCIL_TYPE_INT32):{
-    int32_t min, max;
-    scil_find_minimum_maximum_int32_t((int32_t*)data, count, & min, & max);
-    *out_min = (double) min;
-    *out_max = (double) max;
-    return;
-  }
-  case(SCIL_TYPE_INT64):{
-    int64_t min, max;
-    scil_find_minimum_maximum_int64_t((int64_t*) data, count, & min, & max);
-    *out_min = (double) min;
-    *out_max = (double) max;
-    return;
-  }
-  case(SCIL_TYPE_UNKNOWN) :
-  case(SCIL_TYPE_BINARY):
-  case(SCIL_TYPE_STRING):{
-    assert(0 && "unsupported min/max");
-  }
-  }
+  scilI_data_stats_t stats;
+  scilI_data_stats_compute(datatype, data, scilPr_get_dims_count(dims), & stats);
+  *out_min = stats.minimum;
+  *out_max = stats.maximum;
 }
 
 void scilU_subtract_data(SCIL_Datatype_t datatype, byte * restrict  data1, byte * restrict in_out_data2, scil_dims_t * dims){
@@ -213,16 +174,14 @@ void scilU_print_buffer(char * dest, size_t out_size){
 }
 
 
-static unsigned char sig_bits[MANTISSA_MAX_LENGTH_P1] = {255};
-static unsigned char sig_decimals[MANTISSA_MAX_LENGTH_P1] = {255};
+static unsigned char sig_bits[MANTISSA_MAX_LENGTH_P1];
+static unsigned char sig_decimals[MANTISSA_MAX_LENGTH_P1];
+static pthread_once_t sig_mapping_once = PTHREAD_ONCE_INIT;
 
 #define LOG10B2 3.3219280948873626
 #define LOG2B10 0.30102999566398114
 
 static void compute_significant_bit_mapping(){
-
-	if(sig_bits[0] != 255) return;
-
 	for(int i = 0; i < MANTISSA_MAX_LENGTH_P1; ++i){
 		sig_bits[i] = (unsigned char)ceil(i * LOG10B2);
 		sig_decimals[i] = (unsigned char)ceil(i * LOG2B10);
@@ -233,7 +192,7 @@ int scilU_convert_significant_decimals_to_bits(int decimals){
   if (decimals == SCIL_ACCURACY_INT_FINEST){
     return SCIL_ACCURACY_INT_FINEST;
   }
-	compute_significant_bit_mapping();
+	pthread_once(&sig_mapping_once, compute_significant_bit_mapping);
 	return sig_bits[decimals];
 }
 
@@ -242,7 +201,7 @@ int scilU_convert_significant_bits_to_decimals(int bits){
         return SCIL_ACCURACY_INT_FINEST;
     }
 	// compute mapping between decimals and bits
-	compute_significant_bit_mapping();
+	pthread_once(&sig_mapping_once, compute_significant_bit_mapping);
 	return sig_decimals[bits];
 }
 
@@ -413,3 +372,52 @@ void scilU_print_dims(scil_dims_t pos){
   }
   printf(") ");
 }
+
+char* scilU_trim(char* str){
+  while(*str == ' ' || *str == '\t'){
+    str++;
+  }
+  char* end = str + strlen(str);
+  while(end > str && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')){
+    end--;
+  }
+  *end = 0;
+  return str;
+}
+
+#define PERSISTENT_STATES 4
+
+typedef struct{
+  char* filename;
+  const char* description;
+  scilU_persist_func_t save;
+} persistent_state_t;
+
+// registered during the initialization of the library, which runs once
+static persistent_state_t persistent[PERSISTENT_STATES];
+static int persistent_count = 0;
+
+static void save_at_exit(){
+  for(int i = persistent_count - 1; i >= 0; i--){
+    if(persistent[i].save(persistent[i].filename) != SCIL_NO_ERR){
+      warn("Could not write the %s to %s\n", persistent[i].description, persistent[i].filename);
+    }
+  }
+}
+
+const char* scilU_persist_with_env(const char* variable, const char* description, scilU_persist_func_t load, scilU_persist_func_t save){
+  const char* filename = getenv(variable);
+  if(filename == NULL){
+    return NULL;
+  }
+  assert(persistent_count < PERSISTENT_STATES);
+  persistent_state_t* p = & persistent[persistent_count];
+  p->filename = strdup(filename);
+  p->description = description;
+  p->save = save;
+  load(p->filename);
+  if(persistent_count++ == 0){
+    atexit(save_at_exit);
+  }
+  return p->filename;
+}
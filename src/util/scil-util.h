@@ -266,6 +266,22 @@ void scilG_iter(double* data,
 
 void scilU_print_dims(scil_dims_t dims);
 
+/**
+ * \brief Removes the leading and trailing whitespace of the string in place, including the line break.
+ * \return The start of the trimmed string within str
+ */
+char* scilU_trim(char* str);
+
+typedef int (*scilU_persist_func_t)(const char* filename);
+
+/**
+ * \brief Loads a state from the file named by the environment variable and saves it to the file when the process exits.
+ * A missing file is fine, it is created at exit. Must be called once per state during the initialization of the library.
+ * \param description Names the state in the warning if it cannot be written
+ * \return The copied file name, or NULL if the variable is not set
+ */
+const char* scilU_persist_with_env(const char* variable, const char* description, scilU_persist_func_t load, scilU_persist_func_t save);
+
 // like memcopy but swaps the order
 #define scilU_reverse_copy(buffer, src, size) do { char * _o = (char*) buffer; char * _s = ((char *) src) + size - 1; for(int _c=size; _c > 0; _c-- ) { *_o = *_s ; _s--; _o++; } } while(0)
 
@@ -24,6 +24,7 @@
 #include <scil-hdf5-plugin.h>
 
 #include <scil.h>
+#include <scil-trace.h>
 #include <scil-util.h>
 
 #define DEBUG
@@ -113,6 +114,11 @@ typedef struct {
 
 static herr_t compressorSetLocal(hid_t pList, hid_t type_id, hid_t space) {
 	debug("compressorSetLocal()\n");
+	scil_timer timer;
+	const int trace = scilU_trace_enabled();
+	if(trace){
+		scilU_start_timer(& timer);
+	}
 	int rank = H5Sget_simple_extent_ndims(space);
 	if(rank <= 0) return -4;
 
@@ -200,10 +206,14 @@ static herr_t compressorSetLocal(hid_t pList, hid_t type_id, hid_t space) {
 
 	assert(ret == SCIL_NO_ERR);
 
-	config->dst_size = scilPr_get_compressed_data_size_limit(cfg_p->type, & cfg_p->dims);
+	config->dst_size = scil_compress_bound(config->ctx, & cfg_p->dims);
 
 	// now we store the options with the dataset, this is actually not needed...
-	return H5Pmodify_filter( pList, SCIL_ID, H5Z_FLAG_MANDATORY, cd_size, cd_values );
+	herr_t modify_ret = H5Pmodify_filter( pList, SCIL_ID, H5Z_FLAG_MANDATORY, cd_size, cd_values );
+	if(trace){
+		scilU_trace_span("H5Z set_local", "hdf5", timer, 0, 0);
+	}
+	return modify_ret;
 }
 
 static size_t compressorFilter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nBytes, size_t *buf_size, void **buf){
@@ -211,6 +221,11 @@ static size_t compressorFilter(unsigned int flags, size_t cd_nelmts, const unsig
 
 	size_t out_size = *buf_size;
 	int ret;
+	scil_timer timer;
+	const int trace = scilU_trace_enabled();
+	if(trace){
+		scilU_start_timer(& timer);
+	}
 
   if(flags & H5Z_FLAG_REVERSE){
 		// uncompress
@@ -236,6 +251,8 @@ static size_t compressorFilter(unsigned int flags, size_t cd_nelmts, const unsig
 		plugin_config_persisted* cfg_p = ((plugin_config_persisted *) cd_values);
 		plugin_compress_config* config = cfg_p->cfg;
 
+		// once the chain is chosen the bound is exact
+		config->dst_size = scil_compress_bound(config->ctx, & cfg_p->dims);
 		byte * buffer = (byte*) malloc(config->dst_size + 8);
 		// memset(buffer, 0, config->dst_size + 8);
 
@@ -247,6 +264,9 @@ static size_t compressorFilter(unsigned int flags, size_t cd_nelmts, const unsig
 		*buf = buffer;
 	}
 	assert(ret == SCIL_NO_ERR);
+	if(trace){
+		scilU_trace_span(flags & H5Z_FLAG_REVERSE ? "H5Z decompress" : "H5Z compress", "hdf5", timer, nBytes, out_size);
+	}
 
   return out_size; // 0 means error.
 }